@@ -1,15 +1,33 @@
 #include "infrared_brute_force.h"
 
 #include <stdlib.h>
+#include <m-array.h>
 #include <m-dict.h>
 #include <m-string.h>
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/buffered_file_stream.h>
 
 #include "infrared_signal.h"
 
+#define TAG "InfraredBruteForce"
+
+// Universal remote databases are scanned from start to end
+#define INFRARED_BRUTE_FORCE_CACHE_SIZE 2048
+
+// Signal offsets grouped by name, cached next to the database
+#define INFRARED_BRUTE_FORCE_INDEX_EXTENSION ".idx"
+#define INFRARED_BRUTE_FORCE_INDEX_MAGIC "IRX1"
+#define INFRARED_BRUTE_FORCE_INDEX_MAGIC_SIZE 4
+
+// Next signal is read while the current one is transmitted
+#define INFRARED_BRUTE_FORCE_SLOTS 2
+#define INFRARED_BRUTE_FORCE_LOADER_STACK_SIZE 2048
+
 typedef struct {
     uint32_t index;
     uint32_t count;
+    uint32_t first;
 } InfraredBruteForceRecord;
 
 DICT_DEF2(
@@ -19,24 +37,108 @@ DICT_DEF2(
     InfraredBruteForceRecord,
     M_POD_OPLIST);
 
+ARRAY_DEF(InfraredBruteForceOffsetArray, uint32_t, M_POD_OPLIST);
+
+DICT_DEF2(
+    InfraredBruteForceIndexDict,
+    string_t,
+    STRING_OPLIST,
+    InfraredBruteForceOffsetArray_t,
+    ARRAY_OPLIST(InfraredBruteForceOffsetArray, M_POD_OPLIST));
+
+/* Index file: header, then groups of uint8 name size, name, uint32 count, uint32 offsets */
+typedef struct {
+    uint8_t magic[INFRARED_BRUTE_FORCE_INDEX_MAGIC_SIZE];
+    uint64_t db_size;
+    uint32_t db_mtime;
+} __attribute__((packed)) InfraredBruteForceIndexHeader;
+
+typedef struct {
+    InfraredSignal* signal;
+    bool success;
+} InfraredBruteForceSlot;
+
 struct InfraredBruteForce {
     FlipperFormat* ff;
     const char* db_filename;
     string_t current_record_name;
+    uint32_t current_first;
+    uint32_t current_count;
+    uint32_t current_sent;
+    uint32_t current_loaded;
+
+    FuriThread* loader_thread;
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* ready_queue;
+    InfraredBruteForceSlot slots[INFRARED_BRUTE_FORCE_SLOTS];
+    volatile bool loader_cancel;
+
     InfraredBruteForceRecordDict_t records;
+    // Offsets of the signals of all records, in database order for every record
+    InfraredBruteForceOffsetArray_t offsets;
 };
 
+// Signals are read in the order they are sent, the ff is owned by the loader until stop
+static int32_t infrared_brute_force_loader(void* context) {
+    InfraredBruteForce* brute_force = context;
+    Stream* stream = flipper_format_get_raw_stream(brute_force->ff);
+
+    while(brute_force->current_loaded < brute_force->current_count) {
+        InfraredBruteForceSlot* slot;
+        furi_check(
+            furi_message_queue_get(brute_force->free_queue, &slot, FuriWaitForever) ==
+            FuriStatusOk);
+        if(brute_force->loader_cancel) break;
+
+        uint32_t offset = *InfraredBruteForceOffsetArray_get(
+            brute_force->offsets, brute_force->current_first + brute_force->current_loaded);
+        brute_force->current_loaded++;
+        slot->success = stream_seek(stream, offset, StreamOffsetFromStart) &&
+                        infrared_signal_read_body(slot->signal, brute_force->ff);
+
+        furi_check(
+            furi_message_queue_put(brute_force->ready_queue, &slot, FuriWaitForever) ==
+            FuriStatusOk);
+        if(!slot->success) break;
+    }
+
+    return 0;
+}
+
 InfraredBruteForce* infrared_brute_force_alloc() {
     InfraredBruteForce* brute_force = malloc(sizeof(InfraredBruteForce));
     brute_force->ff = NULL;
     brute_force->db_filename = NULL;
     string_init(brute_force->current_record_name);
     InfraredBruteForceRecordDict_init(brute_force->records);
+    InfraredBruteForceOffsetArray_init(brute_force->offsets);
+
+    brute_force->free_queue = furi_message_queue_alloc(
+        INFRARED_BRUTE_FORCE_SLOTS, sizeof(InfraredBruteForceSlot*));
+    brute_force->ready_queue = furi_message_queue_alloc(
+        INFRARED_BRUTE_FORCE_SLOTS, sizeof(InfraredBruteForceSlot*));
+    for(size_t i = 0; i < INFRARED_BRUTE_FORCE_SLOTS; ++i) {
+        brute_force->slots[i].signal = infrared_signal_alloc();
+    }
+
+    brute_force->loader_thread = furi_thread_alloc();
+    furi_thread_set_name(brute_force->loader_thread, "InfraredBruteForceLoader");
+    furi_thread_set_stack_size(
+        brute_force->loader_thread, INFRARED_BRUTE_FORCE_LOADER_STACK_SIZE);
+    furi_thread_set_context(brute_force->loader_thread, brute_force);
+    furi_thread_set_callback(brute_force->loader_thread, infrared_brute_force_loader);
     return brute_force;
 }
 
 void infrared_brute_force_free(InfraredBruteForce* brute_force) {
     furi_assert(!brute_force->ff);
+    furi_thread_free(brute_force->loader_thread);
+    for(size_t i = 0; i < INFRARED_BRUTE_FORCE_SLOTS; ++i) {
+        infrared_signal_free(brute_force->slots[i].signal);
+    }
+    furi_message_queue_free(brute_force->ready_queue);
+    furi_message_queue_free(brute_force->free_queue);
+    InfraredBruteForceOffsetArray_clear(brute_force->offsets);
     InfraredBruteForceRecordDict_clear(brute_force->records);
     string_clear(brute_force->current_record_name);
     free(brute_force);
@@ -46,28 +148,216 @@ void infrared_brute_force_set_db_filename(InfraredBruteForce* brute_force, const
     brute_force->db_filename = db_filename;
 }
 
-bool infrared_brute_force_calculate_messages(InfraredBruteForce* brute_force) {
-    furi_assert(brute_force->db_filename);
+static void infrared_brute_force_reset_offsets(InfraredBruteForce* brute_force) {
+    InfraredBruteForceOffsetArray_reset(brute_force->offsets);
+
+    InfraredBruteForceRecordDict_it_t it;
+    for(InfraredBruteForceRecordDict_it(it, brute_force->records);
+        !InfraredBruteForceRecordDict_end_p(it);
+        InfraredBruteForceRecordDict_next(it)) {
+        InfraredBruteForceRecordDict_itref_t* record = InfraredBruteForceRecordDict_ref(it);
+        record->value.count = 0;
+        record->value.first = 0;
+    }
+}
+
+// Reserves space for the offsets if the group belongs to one of the records
+static uint32_t* infrared_brute_force_add_group(
+    InfraredBruteForce* brute_force,
+    string_t name,
+    uint32_t count) {
+    InfraredBruteForceRecord* record =
+        InfraredBruteForceRecordDict_get(brute_force->records, name);
+    if(!record || !count) return NULL;
+
+    record->first = InfraredBruteForceOffsetArray_size(brute_force->offsets);
+    record->count = count;
+    InfraredBruteForceOffsetArray_resize(brute_force->offsets, record->first + count);
+    return InfraredBruteForceOffsetArray_get(brute_force->offsets, record->first);
+}
+
+static bool infrared_brute_force_index_load(
+    InfraredBruteForce* brute_force,
+    Storage* storage,
+    const char* index_path,
+    const FileInfo* db_info) {
+    Stream* stream = buffered_file_stream_alloc(storage);
+    InfraredBruteForceIndexHeader header;
+    char name_buffer[UINT8_MAX];
+    string_t name;
+    string_init(name);
     bool success = false;
 
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    do {
+        if(!buffered_file_stream_open(stream, index_path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) break;
+        if(memcmp(header.magic, INFRARED_BRUTE_FORCE_INDEX_MAGIC, sizeof(header.magic)) != 0) {
+            break;
+        }
+        if(header.db_size != db_info->size || header.db_mtime != db_info->mtime) {
+            FURI_LOG_I(TAG, "Database changed, index is outdated");
+            break;
+        }
+
+        while(true) {
+            uint8_t name_size;
+            uint32_t count;
+            if(stream_read(stream, &name_size, sizeof(name_size)) != sizeof(name_size)) {
+                success = true;
+                break;
+            }
+            if(stream_read(stream, (uint8_t*)name_buffer, name_size) != name_size) break;
+            if(stream_read(stream, (uint8_t*)&count, sizeof(count)) != sizeof(count)) break;
+            string_set_strn(name, name_buffer, name_size);
+
+            // Damaged count must not be trusted to size the offsets array
+            const size_t bytes_left = stream_size(stream) - stream_tell(stream);
+            if(count > bytes_left / sizeof(uint32_t)) break;
+
+            const size_t offsets_size = count * sizeof(uint32_t);
+            uint32_t* offsets = infrared_brute_force_add_group(brute_force, name, count);
+            if(offsets) {
+                if(stream_read(stream, (uint8_t*)offsets, offsets_size) != offsets_size) break;
+                uint32_t i = 0;
+                while(i < count && offsets[i] < db_info->size) i++;
+                if(i < count) break;
+            } else if(!stream_seek(stream, offsets_size, StreamOffsetFromCurrent)) {
+                break;
+            }
+        }
+    } while(false);
+
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    string_clear(name);
+
+    if(!success) {
+        infrared_brute_force_reset_offsets(brute_force);
+    }
+    return success;
+}
+
+static void infrared_brute_force_index_save(
+    InfraredBruteForceIndexDict_t index,
+    Storage* storage,
+    const char* index_path,
+    const FileInfo* db_info) {
+    Stream* stream = buffered_file_stream_alloc(storage);
+    InfraredBruteForceIndexHeader header;
+    memcpy(header.magic, INFRARED_BRUTE_FORCE_INDEX_MAGIC, sizeof(header.magic));
+    header.db_size = db_info->size;
+    header.db_mtime = db_info->mtime;
+
+    bool success =
+        buffered_file_stream_open(stream, index_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+        stream_write(stream, (const uint8_t*)&header, sizeof(header)) == sizeof(header);
+
+    InfraredBruteForceIndexDict_it_t it;
+    for(InfraredBruteForceIndexDict_it(it, index);
+        success && !InfraredBruteForceIndexDict_end_p(it);
+        InfraredBruteForceIndexDict_next(it)) {
+        const InfraredBruteForceIndexDict_itref_t* group = InfraredBruteForceIndexDict_cref(it);
+        if(string_size(group->key) > UINT8_MAX) {
+            success = false;
+            break;
+        }
+
+        uint8_t name_size = string_size(group->key);
+        uint32_t count = InfraredBruteForceOffsetArray_size(group->value);
+        const size_t offsets_size = count * sizeof(uint32_t);
+        success = stream_write(stream, &name_size, sizeof(name_size)) == sizeof(name_size) &&
+                  stream_write(stream, (const uint8_t*)string_get_cstr(group->key), name_size) ==
+                      name_size &&
+                  stream_write(stream, (const uint8_t*)&count, sizeof(count)) == sizeof(count) &&
+                  stream_write(
+                      stream,
+                      (const uint8_t*)InfraredBruteForceOffsetArray_cget(group->value, 0),
+                      offsets_size) == offsets_size;
+    }
+
+    success = buffered_file_stream_close(stream) && success;
+    stream_free(stream);
+
+    if(!success) {
+        FURI_LOG_W(TAG, "Failed to save index");
+        storage_simply_remove(storage, index_path);
+    }
+}
+
+// Scans the whole database once, the index is saved only if it can be validated later
+static bool infrared_brute_force_index_build(
+    InfraredBruteForce* brute_force,
+    Storage* storage,
+    const char* index_path,
+    const FileInfo* db_info) {
+    FlipperFormat* ff = flipper_format_buffered_file_alloc_ex(
+        storage, INFRARED_BRUTE_FORCE_CACHE_SIZE, BufferedFileStreamAccessSequential);
+    InfraredBruteForceIndexDict_t index;
+    InfraredBruteForceIndexDict_init(index);
 
-    success = flipper_format_buffered_file_open_existing(ff, brute_force->db_filename);
+    bool success = flipper_format_buffered_file_open_existing(ff, brute_force->db_filename);
     if(success) {
+        Stream* stream = flipper_format_get_raw_stream(ff);
         string_t signal_name;
         string_init(signal_name);
+        // Offset points right after the name, where the signal body starts
         while(flipper_format_read_string(ff, "name", signal_name)) {
-            InfraredBruteForceRecord* record =
-                InfraredBruteForceRecordDict_get(brute_force->records, signal_name);
-            if(record) {
-                ++(record->count);
-            }
+            InfraredBruteForceOffsetArray_t* offsets =
+                InfraredBruteForceIndexDict_safe_get(index, signal_name);
+            InfraredBruteForceOffsetArray_push_back(*offsets, stream_tell(stream));
         }
         string_clear(signal_name);
     }
-
     flipper_format_free(ff);
+
+    if(success) {
+        InfraredBruteForceIndexDict_it_t it;
+        for(InfraredBruteForceIndexDict_it(it, index); !InfraredBruteForceIndexDict_end_p(it);
+            InfraredBruteForceIndexDict_next(it)) {
+            InfraredBruteForceIndexDict_itref_t* group = InfraredBruteForceIndexDict_ref(it);
+            uint32_t count = InfraredBruteForceOffsetArray_size(group->value);
+            uint32_t* offsets = infrared_brute_force_add_group(brute_force, group->key, count);
+            if(offsets) {
+                memcpy(
+                    offsets,
+                    InfraredBruteForceOffsetArray_cget(group->value, 0),
+                    count * sizeof(uint32_t));
+            }
+        }
+
+        if(db_info) {
+            infrared_brute_force_index_save(index, storage, index_path, db_info);
+        }
+    }
+
+    InfraredBruteForceIndexDict_clear(index);
+    return success;
+}
+
+bool infrared_brute_force_calculate_messages(InfraredBruteForce* brute_force) {
+    furi_assert(brute_force->db_filename);
+    bool success = false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    string_t index_path;
+    string_init_printf(
+        index_path, "%s%s", brute_force->db_filename, INFRARED_BRUTE_FORCE_INDEX_EXTENSION);
+    infrared_brute_force_reset_offsets(brute_force);
+
+    FileInfo db_info;
+    if(storage_common_stat(storage, brute_force->db_filename, &db_info) == FSE_OK) {
+        // Without modification time an outdated index can't be detected
+        bool cacheable = (db_info.mtime != 0);
+        const char* path = string_get_cstr(index_path);
+        success = cacheable &&
+                  infrared_brute_force_index_load(brute_force, storage, path, &db_info);
+        if(!success) {
+            success = infrared_brute_force_index_build(
+                brute_force, storage, path, cacheable ? &db_info : NULL);
+        }
+    }
+
+    string_clear(index_path);
     furi_record_close(RECORD_STORAGE);
     return success;
 }
@@ -88,6 +378,10 @@ bool infrared_brute_force_start(
             *record_count = record->value.count;
             if(*record_count) {
                 string_set(brute_force->current_record_name, record->key);
+                brute_force->current_first = record->value.first;
+                brute_force->current_count = record->value.count;
+                brute_force->current_sent = 0;
+                brute_force->current_loaded = 0;
             }
             break;
         }
@@ -95,10 +389,21 @@ bool infrared_brute_force_start(
 
     if(*record_count) {
         Storage* storage = furi_record_open(RECORD_STORAGE);
-        brute_force->ff = flipper_format_buffered_file_alloc(storage);
+        // Signals are read by offset, non-matching ones in between are skipped
+        brute_force->ff = flipper_format_buffered_file_alloc_ex(
+            storage, INFRARED_BRUTE_FORCE_CACHE_SIZE, BufferedFileStreamAccessRandom);
         success =
             flipper_format_buffered_file_open_existing(brute_force->ff, brute_force->db_filename);
-        if(!success) {
+        if(success) {
+            furi_message_queue_reset(brute_force->ready_queue);
+            furi_message_queue_reset(brute_force->free_queue);
+            for(size_t i = 0; i < INFRARED_BRUTE_FORCE_SLOTS; ++i) {
+                InfraredBruteForceSlot* slot = &brute_force->slots[i];
+                furi_message_queue_put(brute_force->free_queue, &slot, FuriWaitForever);
+            }
+            brute_force->loader_cancel = false;
+            furi_thread_start(brute_force->loader_thread);
+        } else {
             flipper_format_free(brute_force->ff);
             brute_force->ff = NULL;
             furi_record_close(RECORD_STORAGE);
@@ -115,6 +420,16 @@ void infrared_brute_force_stop(InfraredBruteForce* brute_force) {
     furi_assert(string_size(brute_force->current_record_name));
     furi_assert(brute_force->ff);
 
+    // Loader waiting for a free slot is woken up by the returned ready ones
+    brute_force->loader_cancel = true;
+    InfraredBruteForceSlot* slot;
+    while(furi_thread_get_state(brute_force->loader_thread) != FuriThreadStateStopped) {
+        if(furi_message_queue_get(brute_force->ready_queue, &slot, 10) == FuriStatusOk) {
+            furi_message_queue_put(brute_force->free_queue, &slot, FuriWaitForever);
+        }
+    }
+    furi_thread_join(brute_force->loader_thread);
+
     string_reset(brute_force->current_record_name);
     flipper_format_free(brute_force->ff);
     furi_record_close(RECORD_STORAGE);
@@ -126,20 +441,23 @@ bool infrared_brute_force_send_next(InfraredBruteForce* brute_force) {
     furi_assert(brute_force->ff);
     bool success = false;
 
-    string_t signal_name;
-    string_init(signal_name);
-    InfraredSignal* signal = infrared_signal_alloc();
+    if(brute_force->current_sent < brute_force->current_count) {
+        InfraredBruteForceSlot* slot;
+        furi_check(
+            furi_message_queue_get(brute_force->ready_queue, &slot, FuriWaitForever) ==
+            FuriStatusOk);
+        brute_force->current_sent++;
 
-    do {
-        success = infrared_signal_read(signal, brute_force->ff, signal_name);
-    } while(success && !string_equal_p(brute_force->current_record_name, signal_name));
+        success = slot->success;
+        if(success) {
+            infrared_signal_transmit(slot->signal);
+        }
 
-    if(success) {
-        infrared_signal_transmit(signal);
+        furi_check(
+            furi_message_queue_put(brute_force->free_queue, &slot, FuriWaitForever) ==
+            FuriStatusOk);
     }
 
-    infrared_signal_free(signal);
-    string_clear(signal_name);
     return success;
 }
 
@@ -147,7 +465,7 @@ void infrared_brute_force_add_record(
     InfraredBruteForce* brute_force,
     uint32_t index,
     const char* name) {
-    InfraredBruteForceRecord value = {.index = index, .count = 0};
+    InfraredBruteForceRecord value = {.index = index, .count = 0, .first = 0};
     string_t key;
     string_init_set_str(key, name);
     InfraredBruteForceRecordDict_set_at(brute_force->records, key, value);
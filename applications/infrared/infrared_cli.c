@@ -3,13 +3,23 @@
 #include <infrared.h>
 #include <infrared_worker.h>
 #include <furi_hal_infrared.h>
+#include <furi_hal_cortex.h>
+#include <flipper_format/flipper_format.h>
 
 #include "infrared_signal.h"
 
 #define INFRARED_CLI_BUF_SIZE 10
 
+typedef struct {
+    uint32_t signals;
+    uint32_t messages;
+    uint32_t timings;
+    uint64_t cycles;
+} InfraredCliDecodeStats;
+
 static void infrared_cli_start_ir_rx(Cli* cli, string_t args);
 static void infrared_cli_start_ir_tx(Cli* cli, string_t args);
+static void infrared_cli_decode_file(Cli* cli, string_t args);
 
 static const struct {
     const char* cmd;
@@ -17,6 +27,7 @@ static const struct {
 } infrared_cli_commands[] = {
     {.cmd = "rx", .process_function = infrared_cli_start_ir_rx},
     {.cmd = "tx", .process_function = infrared_cli_start_ir_tx},
+    {.cmd = "decode", .process_function = infrared_cli_decode_file},
 };
 
 static void signal_received_callback(void* context, InfraredWorkerSignal* received_signal) {
@@ -74,6 +85,7 @@ static void infrared_cli_print_usage(void) {
     printf("Usage:\r\n");
     printf("\tir rx\r\n");
     printf("\tir tx <protocol> <address> <command>\r\n");
+    printf("\tir decode <file.ir|file.irtest>\r\n");
     printf("\t<command> and <address> are hex-formatted\r\n");
     printf("\tAvailable protocols:");
     for(int i = 0; infrared_is_protocol_valid((InfraredProtocol)i); ++i) {
@@ -162,6 +174,135 @@ static void infrared_cli_start_ir_tx(Cli* cli, string_t args) {
     infrared_signal_free(signal);
 }
 
+/* Replays timings the same way the worker does: check on long silence, then decode the edge */
+static void infrared_cli_decode_signal(
+    InfraredDecoderHandler* decoder,
+    const char* name,
+    const uint32_t* timings,
+    size_t timings_count,
+    bool level,
+    InfraredCliDecodeStats* stats) {
+    InfraredMessage first_message;
+    uint32_t messages = 0;
+
+    infrared_reset_decoder(decoder);
+    uint32_t start = furi_hal_cortex_get_cycle_count();
+    for(size_t i = 0; i <= timings_count; ++i) {
+        const InfraredMessage* message = NULL;
+        if((i == timings_count) || (timings[i] > INFRARED_RAW_RX_TIMING_DELAY_US)) {
+            message = infrared_check_decoder_ready(decoder);
+            if(message && !messages++) first_message = *message;
+        }
+        if(i < timings_count) {
+            message = infrared_decode(decoder, level, timings[i]);
+            if(message && !messages++) first_message = *message;
+            level = !level;
+        }
+    }
+    uint32_t cycles = furi_hal_cortex_get_cycle_count() - start;
+
+    InfraredProtocol protocol = messages ? first_message.protocol : InfraredProtocolMAX;
+    stats[protocol].signals++;
+    stats[protocol].messages += messages;
+    stats[protocol].timings += timings_count;
+    stats[protocol].cycles += cycles;
+
+    if(messages) {
+        printf(
+            "%s: %s, A:0x%0*lX, C:0x%0*lX, %lu messages\r\n",
+            name,
+            infrared_get_protocol_name(protocol),
+            ROUND_UP_TO(infrared_get_protocol_address_length(protocol), 4),
+            first_message.address,
+            ROUND_UP_TO(infrared_get_protocol_command_length(protocol), 4),
+            first_message.command,
+            messages);
+    } else {
+        printf("%s: not decoded\r\n", name);
+    }
+}
+
+static void infrared_cli_decode_file(Cli* cli, string_t args) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    InfraredDecoderHandler* decoder = infrared_alloc_decoder();
+    InfraredSignal* signal = infrared_signal_alloc();
+    // Signals without decoded messages are counted in the last element
+    InfraredCliDecodeStats* stats =
+        malloc(sizeof(InfraredCliDecodeStats) * (InfraredProtocolMAX + 1));
+    string_t name, buf;
+    string_init(name);
+    string_init(buf);
+
+    do {
+        uint32_t version;
+        if(!flipper_format_buffered_file_open_existing(ff, string_get_cstr(args)) ||
+           !flipper_format_read_header(ff, buf, &version)) {
+            printf("Failed to open %s\r\n", string_get_cstr(args));
+            break;
+        }
+        // Test inputs start with silence, recorded signals start with a mark
+        bool start_level = (string_cmp_str(buf, "IR tests file") != 0);
+
+        while(!cli_cmd_interrupt_received(cli) && flipper_format_read_string(ff, "name", name)) {
+            if(start_level) {
+                // Recorded signals can be stored as patterns, they are expanded to raw timings
+                if(infrared_signal_read_body(signal, ff) && infrared_signal_is_raw(signal)) {
+                    InfraredRawSignal* raw = infrared_signal_get_raw_signal(signal);
+                    infrared_cli_decode_signal(
+                        decoder,
+                        string_get_cstr(name),
+                        raw->timings,
+                        raw->timings_size,
+                        start_level,
+                        stats);
+                }
+                continue;
+            }
+
+            uint32_t timings_count;
+            if(!flipper_format_read_string(ff, "type", buf) || string_cmp_str(buf, "raw")) {
+                continue;
+            }
+            if(!flipper_format_get_value_count(ff, "data", &timings_count) || !timings_count) {
+                continue;
+            }
+
+            uint32_t* timings = malloc(sizeof(uint32_t) * timings_count);
+            if(flipper_format_read_uint32(ff, "data", timings, timings_count)) {
+                infrared_cli_decode_signal(
+                    decoder, string_get_cstr(name), timings, timings_count, start_level, stats);
+            }
+            free(timings);
+        }
+
+        const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+        for(int32_t i = 0; i <= InfraredProtocolMAX; ++i) {
+            if(!stats[i].signals) continue;
+            uint64_t timings_per_s = 0;
+            if(stats[i].cycles) {
+                timings_per_s =
+                    (uint64_t)stats[i].timings * cycles_per_us * 1000000 / stats[i].cycles;
+            }
+            printf(
+                "%s: %lu signals, %lu messages, %lu timings, %lu timings/s\r\n",
+                (i < InfraredProtocolMAX) ? infrared_get_protocol_name(i) : "Not decoded",
+                stats[i].signals,
+                stats[i].messages,
+                stats[i].timings,
+                (uint32_t)timings_per_s);
+        }
+    } while(false);
+
+    string_clear(buf);
+    string_clear(name);
+    free(stats);
+    infrared_signal_free(signal);
+    infrared_free_decoder(decoder);
+    flipper_format_free(ff);
+    furi_record_close(RECORD_STORAGE);
+}
+
 static void infrared_cli_start_ir(Cli* cli, string_t args, void* context) {
     UNUSED(context);
     if(furi_hal_infrared_is_busy()) {
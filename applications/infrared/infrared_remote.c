@@ -11,12 +11,18 @@
 
 #define TAG "InfraredRemote"
 
+#define INFRARED_REMOTE_FILE_TYPE "IR signals file"
+#define INFRARED_REMOTE_FILE_VERSION 1
+// Raw signals can be stored as patterns, older firmware can't read them
+#define INFRARED_REMOTE_FILE_VERSION_COMPACT 2
+
 ARRAY_DEF(InfraredButtonArray, InfraredRemoteButton*, M_PTR_OPLIST);
 
 struct InfraredRemote {
     InfraredButtonArray_t buttons;
     string_t name;
     string_t path;
+    bool is_compact;
 };
 
 static void infrared_remote_clear_buttons(InfraredRemote* remote) {
@@ -48,6 +54,7 @@ void infrared_remote_reset(InfraredRemote* remote) {
     infrared_remote_clear_buttons(remote);
     string_reset(remote->name);
     string_reset(remote->path);
+    remote->is_compact = false;
 }
 
 void infrared_remote_set_name(InfraredRemote* remote, const char* name) {
@@ -109,6 +116,18 @@ bool infrared_remote_delete_button(InfraredRemote* remote, size_t index) {
     return infrared_remote_store(remote);
 }
 
+bool infrared_remote_is_compact(InfraredRemote* remote) {
+    return remote->is_compact;
+}
+
+bool infrared_remote_compact(InfraredRemote* remote) {
+    remote->is_compact = true;
+    // Remote stays in the old format if it could not be rewritten
+    bool success = infrared_remote_store(remote);
+    if(!success) remote->is_compact = false;
+    return success;
+}
+
 bool infrared_remote_store(InfraredRemote* remote) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     FlipperFormat* ff = flipper_format_file_alloc(storage);
@@ -116,17 +135,19 @@ bool infrared_remote_store(InfraredRemote* remote) {
 
     FURI_LOG_I(TAG, "store file: \'%s\'", path);
 
+    const uint32_t version = remote->is_compact ? INFRARED_REMOTE_FILE_VERSION_COMPACT :
+                                                  INFRARED_REMOTE_FILE_VERSION;
     bool success = flipper_format_file_open_always(ff, path) &&
-                   flipper_format_write_header_cstr(ff, "IR signals file", 1);
+                   flipper_format_write_header_cstr(ff, INFRARED_REMOTE_FILE_TYPE, version);
     if(success) {
         InfraredButtonArray_it_t it;
         for(InfraredButtonArray_it(it, remote->buttons); !InfraredButtonArray_end_p(it);
             InfraredButtonArray_next(it)) {
             InfraredRemoteButton* button = *InfraredButtonArray_cref(it);
-            success = infrared_signal_save(
-                infrared_remote_button_get_signal(button),
-                ff,
-                infrared_remote_button_get_name(button));
+            InfraredSignal* signal = infrared_remote_button_get_signal(button);
+            const char* name = infrared_remote_button_get_name(button);
+            success = remote->is_compact ? infrared_signal_save_compact(signal, ff, name) :
+                                           infrared_signal_save(signal, ff, name);
             if(!success) {
                 break;
             }
@@ -148,13 +169,16 @@ bool infrared_remote_load(InfraredRemote* remote, string_t path) {
     FURI_LOG_I(TAG, "load file: \'%s\'", string_get_cstr(path));
     bool success = flipper_format_buffered_file_open_existing(ff, string_get_cstr(path));
 
+    uint32_t version = 0;
     if(success) {
-        uint32_t version;
         success = flipper_format_read_header(ff, buf, &version) &&
-                  !string_cmp_str(buf, "IR signals file") && (version == 1);
+                  !string_cmp_str(buf, INFRARED_REMOTE_FILE_TYPE) &&
+                  (version == INFRARED_REMOTE_FILE_VERSION ||
+                   version == INFRARED_REMOTE_FILE_VERSION_COMPACT);
     }
 
     if(success) {
+        remote->is_compact = (version == INFRARED_REMOTE_FILE_VERSION_COMPACT);
         path_extract_filename(path, buf, true);
         infrared_remote_clear_buttons(remote);
         infrared_remote_set_name(remote, string_get_cstr(buf));
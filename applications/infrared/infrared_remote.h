@@ -24,6 +24,10 @@ bool infrared_remote_add_button(InfraredRemote* remote, const char* name, Infrar
 bool infrared_remote_rename_button(InfraredRemote* remote, const char* new_name, size_t index);
 bool infrared_remote_delete_button(InfraredRemote* remote, size_t index);
 
+bool infrared_remote_is_compact(InfraredRemote* remote);
+/* Store raw signals as patterns from now on, file version is raised to 2 */
+bool infrared_remote_compact(InfraredRemote* remote);
+
 bool infrared_remote_store(InfraredRemote* remote);
 bool infrared_remote_load(InfraredRemote* remote, string_t path);
 bool infrared_remote_remove(InfraredRemote* remote);
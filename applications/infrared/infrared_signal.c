@@ -5,6 +5,7 @@
 #include <core/check.h>
 #include <infrared_worker.h>
 #include <infrared_transmit.h>
+#include <infrared_analyzer.h>
 
 #define TAG "InfraredSignal"
 
@@ -99,6 +100,41 @@ static inline bool infrared_signal_save_raw(InfraredRawSignal* raw, FlipperForma
            flipper_format_write_uint32(ff, "data", raw->timings, raw->timings_size);
 }
 
+static bool infrared_signal_save_pattern(
+    InfraredAnalyzerPattern* pattern,
+    InfraredRawSignal* raw,
+    FlipperFormat* ff) {
+    const char* encoding_name = infrared_analyzer_get_encoding_name(pattern->encoding);
+    const size_t frames_count = pattern->frames_count;
+    uint32_t values[INFRARED_ANALYZER_MAX_FRAMES];
+
+    bool success = flipper_format_write_string_cstr(ff, "type", "pattern") &&
+                   flipper_format_write_uint32(ff, "frequency", &raw->frequency, 1) &&
+                   flipper_format_write_float(ff, "duty_cycle", &raw->duty_cycle, 1) &&
+                   flipper_format_write_string_cstr(ff, "encoding", encoding_name) &&
+                   flipper_format_write_uint32(ff, "bit_mark", pattern->bit_mark, 2) &&
+                   flipper_format_write_uint32(ff, "bit_space", pattern->bit_space, 2) &&
+                   flipper_format_write_uint32(ff, "stop_mark", &pattern->stop_mark, 1);
+
+    for(size_t i = 0; i < frames_count; ++i) values[i] = pattern->frames[i].header_mark;
+    success = success && flipper_format_write_uint32(ff, "header_mark", values, frames_count);
+    for(size_t i = 0; i < frames_count; ++i) values[i] = pattern->frames[i].header_space;
+    success = success && flipper_format_write_uint32(ff, "header_space", values, frames_count);
+    for(size_t i = 0; i < frames_count; ++i) values[i] = pattern->frames[i].bits;
+    success = success && flipper_format_write_uint32(ff, "bits", values, frames_count);
+    for(size_t i = 0; i < frames_count; ++i) values[i] = pattern->frames[i].repeat;
+    success = success && flipper_format_write_uint32(ff, "repeat", values, frames_count);
+    for(size_t i = 0; i < frames_count; ++i) values[i] = pattern->frames[i].gap;
+    success = success && flipper_format_write_uint32(ff, "gap", values, frames_count);
+
+    if(pattern->data_bits) {
+        const uint16_t data_size = (pattern->data_bits + 7) / 8;
+        success = success && flipper_format_write_hex(ff, "data", pattern->data, data_size);
+    }
+
+    return success;
+}
+
 static inline bool infrared_signal_read_message(InfraredSignal* signal, FlipperFormat* ff) {
     string_t buf;
     string_init(buf);
@@ -146,6 +182,79 @@ static inline bool infrared_signal_read_raw(InfraredSignal* signal, FlipperForma
     return success;
 }
 
+static bool infrared_signal_read_pattern(InfraredSignal* signal, FlipperFormat* ff) {
+    InfraredAnalyzerPattern* pattern = malloc(sizeof(InfraredAnalyzerPattern));
+    uint32_t values[INFRARED_ANALYZER_MAX_FRAMES];
+    uint32_t* timings = NULL;
+    uint32_t frequency, frames_count;
+    float duty_cycle;
+    string_t buf;
+    string_init(buf);
+    bool success = false;
+
+    do {
+        if(!flipper_format_read_uint32(ff, "frequency", &frequency, 1) ||
+           !flipper_format_read_float(ff, "duty_cycle", &duty_cycle, 1) ||
+           !flipper_format_read_string(ff, "encoding", buf)) {
+            break;
+        }
+
+        pattern->encoding = infrared_analyzer_get_encoding_by_name(string_get_cstr(buf));
+        if(pattern->encoding == InfraredAnalyzerEncodingMAX) {
+            FURI_LOG_E(TAG, "Unknown pattern encoding: %s", string_get_cstr(buf));
+            break;
+        }
+
+        if(!flipper_format_read_uint32(ff, "bit_mark", pattern->bit_mark, 2) ||
+           !flipper_format_read_uint32(ff, "bit_space", pattern->bit_space, 2) ||
+           !flipper_format_read_uint32(ff, "stop_mark", &pattern->stop_mark, 1) ||
+           !flipper_format_get_value_count(ff, "header_mark", &frames_count)) {
+            break;
+        }
+        if(!frames_count || frames_count > INFRARED_ANALYZER_MAX_FRAMES) break;
+        pattern->frames_count = frames_count;
+
+        if(!flipper_format_read_uint32(ff, "header_mark", values, frames_count)) break;
+        for(size_t i = 0; i < frames_count; ++i) pattern->frames[i].header_mark = values[i];
+        if(!flipper_format_read_uint32(ff, "header_space", values, frames_count)) break;
+        for(size_t i = 0; i < frames_count; ++i) pattern->frames[i].header_space = values[i];
+
+        if(!flipper_format_read_uint32(ff, "bits", values, frames_count)) break;
+        for(size_t i = 0; i < frames_count; ++i) {
+            pattern->frames[i].bits = MIN(values[i], (uint32_t)UINT16_MAX);
+            pattern->data_bits += pattern->frames[i].bits;
+        }
+        if(pattern->data_bits > INFRARED_ANALYZER_MAX_DATA_SIZE * 8) break;
+
+        if(!flipper_format_read_uint32(ff, "repeat", values, frames_count)) break;
+        for(size_t i = 0; i < frames_count; ++i) {
+            pattern->frames[i].repeat = MIN(values[i], (uint32_t)UINT16_MAX);
+        }
+        if(!flipper_format_read_uint32(ff, "gap", values, frames_count)) break;
+        for(size_t i = 0; i < frames_count; ++i) pattern->frames[i].gap = values[i];
+
+        if(pattern->data_bits &&
+           !flipper_format_read_hex(ff, "data", pattern->data, (pattern->data_bits + 7) / 8)) {
+            break;
+        }
+
+        timings = malloc(sizeof(uint32_t) * MAX_TIMINGS_AMOUNT);
+        size_t timings_size = infrared_analyzer_encode(pattern, timings, MAX_TIMINGS_AMOUNT);
+        if(!timings_size) {
+            FURI_LOG_E(TAG, "Invalid pattern");
+            break;
+        }
+
+        infrared_signal_set_raw_signal(signal, timings, timings_size, frequency, duty_cycle);
+        success = true;
+    } while(false);
+
+    string_clear(buf);
+    free(timings);
+    free(pattern);
+    return success;
+}
+
 InfraredSignal* infrared_signal_alloc() {
     InfraredSignal* signal = malloc(sizeof(InfraredSignal));
 
@@ -226,21 +335,39 @@ bool infrared_signal_save(InfraredSignal* signal, FlipperFormat* ff, const char*
     }
 }
 
-bool infrared_signal_read(InfraredSignal* signal, FlipperFormat* ff, string_t name) {
+bool infrared_signal_save_compact(InfraredSignal* signal, FlipperFormat* ff, const char* name) {
+    if(!signal->is_raw) {
+        return infrared_signal_save(signal, ff, name);
+    } else if(!flipper_format_write_comment_cstr(ff, "") ||
+              !flipper_format_write_string_cstr(ff, "name", name)) {
+        return false;
+    }
+
+    // Signals that can't be described with a pattern are kept raw
+    InfraredRawSignal* raw = &signal->payload.raw;
+    InfraredAnalyzerPattern* pattern = malloc(sizeof(InfraredAnalyzerPattern));
+    bool success = infrared_analyzer_analyze(pattern, raw->timings, raw->timings_size) ?
+                       infrared_signal_save_pattern(pattern, raw, ff) :
+                       infrared_signal_save_raw(raw, ff);
+    free(pattern);
+    return success;
+}
+
+bool infrared_signal_read_body(InfraredSignal* signal, FlipperFormat* ff) {
     string_t buf;
     string_init(buf);
     bool success = false;
 
     do {
-        if(!flipper_format_read_string(ff, "name", buf)) break;
-        string_set(name, buf);
         if(!flipper_format_read_string(ff, "type", buf)) break;
         if(!string_cmp_str(buf, "raw")) {
             success = infrared_signal_read_raw(signal, ff);
         } else if(!string_cmp_str(buf, "parsed")) {
             success = infrared_signal_read_message(signal, ff);
+        } else if(!string_cmp_str(buf, "pattern")) {
+            success = infrared_signal_read_pattern(signal, ff);
         } else {
-            FURI_LOG_E(TAG, "Unknown type of signal (allowed - raw/parsed) ");
+            FURI_LOG_E(TAG, "Unknown type of signal (allowed - raw/parsed/pattern) ");
         }
     } while(0);
 
@@ -248,6 +375,20 @@ bool infrared_signal_read(InfraredSignal* signal, FlipperFormat* ff, string_t na
     return success;
 }
 
+bool infrared_signal_read(InfraredSignal* signal, FlipperFormat* ff, string_t name) {
+    string_t buf;
+    string_init(buf);
+    bool success = false;
+
+    if(flipper_format_read_string(ff, "name", buf)) {
+        string_set(name, buf);
+        success = infrared_signal_read_body(signal, ff);
+    }
+
+    string_clear(buf);
+    return success;
+}
+
 void infrared_signal_transmit(InfraredSignal* signal) {
     if(signal->is_raw) {
         InfraredRawSignal* raw_signal = &signal->payload.raw;
@@ -36,6 +36,12 @@ void infrared_signal_set_message(InfraredSignal* signal, const InfraredMessage*
 InfraredMessage* infrared_signal_get_message(InfraredSignal* signal);
 
 bool infrared_signal_save(InfraredSignal* signal, FlipperFormat* ff, const char* name);
+/* Save raw signal as a pattern when possible. Durations are replaced with the averages
+ * of their groups, so the signal read back is close to the captured one, not identical.
+ * Patterns are only allowed in version 2 files */
+bool infrared_signal_save_compact(InfraredSignal* signal, FlipperFormat* ff, const char* name);
 bool infrared_signal_read(InfraredSignal* signal, FlipperFormat* ff, string_t name);
+/* Read the signal that follows the name at the current position */
+bool infrared_signal_read_body(InfraredSignal* signal, FlipperFormat* ff);
 
 void infrared_signal_transmit(InfraredSignal* signal);
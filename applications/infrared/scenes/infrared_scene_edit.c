@@ -6,6 +6,7 @@ typedef enum {
     SubmenuIndexDeleteButton,
     SubmenuIndexRenameRemote,
     SubmenuIndexDeleteRemote,
+    SubmenuIndexCompactRemote,
 } SubmenuIndex;
 
 static void infrared_scene_edit_submenu_callback(void* context, uint32_t index) {
@@ -48,6 +49,14 @@ void infrared_scene_edit_on_enter(void* context) {
         SubmenuIndexDeleteRemote,
         infrared_scene_edit_submenu_callback,
         context);
+    if(!infrared_remote_is_compact(infrared->remote)) {
+        submenu_add_item(
+            submenu,
+            "Compact Remote",
+            SubmenuIndexCompactRemote,
+            infrared_scene_edit_submenu_callback,
+            context);
+    }
 
     const uint32_t submenu_index = scene_manager_get_scene_state(scene_manager, InfraredSceneEdit);
     submenu_set_selected_item(submenu, submenu_index);
@@ -89,6 +98,16 @@ bool infrared_scene_edit_on_event(void* context, SceneManagerEvent event) {
             infrared->app_state.edit_mode = InfraredEditModeDelete;
             scene_manager_next_scene(scene_manager, InfraredSceneEditDelete);
             consumed = true;
+        } else if(submenu_index == SubmenuIndexCompactRemote) {
+            infrared->app_state.edit_target = InfraredEditTargetRemote;
+            infrared->app_state.edit_mode = InfraredEditModeNone;
+            if(infrared_remote_compact(infrared->remote)) {
+                scene_manager_next_scene(scene_manager, InfraredSceneEditRenameDone);
+            } else {
+                scene_manager_search_and_switch_to_previous_scene(
+                    scene_manager, InfraredSceneRemoteList);
+            }
+            consumed = true;
         }
     }
 
@@ -3,20 +3,92 @@
 #include <furi_hal.h>
 #include <stm32wbxx_ll_cortex.h>
 
+#define TAG "RfidReader"
+
+// Edge is a period in CPU clocks, polarity is kept in the top bit
+constexpr uint32_t edge_polarity = 1UL << 31;
+constexpr uint32_t edge_period_max = edge_polarity - 1;
+constexpr size_t edge_buffer_count = 1024;
+// Decoder thread wakes up for a batch of edges or after the timeout
+constexpr size_t edge_batch_count = 32;
+constexpr uint32_t decoder_timeout_ms = 10;
+
 /**
  * @brief private violation assistant for RfidReader
  */
 struct RfidReaderAccessor {
-    static void decode(RfidReader& rfid_reader, bool polarity) {
-        rfid_reader.decode(polarity);
+    static void capture(RfidReader& rfid_reader, bool polarity) {
+        rfid_reader.capture(polarity);
     }
 };
 
-void RfidReader::decode(bool polarity) {
+void RfidReader::capture(bool polarity) {
     uint32_t current_dwt_value = DWT->CYCCNT;
     uint32_t period = current_dwt_value - last_dwt_value;
     last_dwt_value = current_dwt_value;
 
+    uint32_t edge = MIN(period, edge_period_max) | (polarity ? edge_polarity : 0);
+    BaseType_t task_woken = pdFALSE;
+    if(xStreamBufferSendFromISR(edge_stream, &edge, sizeof(uint32_t), &task_woken) !=
+       sizeof(uint32_t)) {
+        dropped_edges = dropped_edges + 1;
+    }
+    portYIELD_FROM_ISR(task_woken);
+}
+
+int32_t RfidReader::decoder_thread_callback(void* context) {
+    RfidReader* _this = static_cast<RfidReader*>(context);
+    uint32_t edges[edge_batch_count];
+    uint32_t dropped_reported = 0;
+
+    while(_this->decoder_running) {
+        size_t size = xStreamBufferReceive(
+            _this->edge_stream, edges, sizeof(edges), furi_ms_to_ticks(decoder_timeout_ms));
+
+        for(size_t i = 0; i < size / sizeof(uint32_t); i++) {
+            _this->decode(edges[i] & edge_polarity, edges[i] & edge_period_max);
+        }
+
+        uint32_t dropped = _this->dropped_edges;
+        if(dropped != dropped_reported) {
+            FURI_LOG_W(TAG, "Dropped %lu edges", dropped - dropped_reported);
+            dropped_reported = dropped;
+        }
+    }
+
+    return 0;
+}
+
+void RfidReader::start_decoder() {
+    if(decoder_thread) return;
+
+    dropped_edges = 0;
+    edge_stream = xStreamBufferCreate(sizeof(uint32_t) * edge_buffer_count, sizeof(uint32_t));
+    furi_check(edge_stream);
+    xStreamBufferSetTriggerLevel(edge_stream, sizeof(uint32_t) * edge_batch_count);
+
+    decoder_running = true;
+    decoder_thread = furi_thread_alloc();
+    furi_thread_set_name(decoder_thread, "RfidReaderDecoder");
+    furi_thread_set_stack_size(decoder_thread, 2048);
+    furi_thread_set_context(decoder_thread, this);
+    furi_thread_set_callback(decoder_thread, decoder_thread_callback);
+    furi_thread_start(decoder_thread);
+}
+
+void RfidReader::stop_decoder() {
+    if(!decoder_thread) return;
+
+    decoder_running = false;
+    furi_thread_join(decoder_thread);
+    furi_thread_free(decoder_thread);
+    decoder_thread = NULL;
+
+    vStreamBufferDelete(edge_stream);
+    edge_stream = NULL;
+}
+
+void RfidReader::decode(bool polarity, uint32_t period) {
 #ifdef RFID_GPIO_DEBUG
     decoder_gpio_out.process_front(polarity, period);
 #endif
@@ -65,7 +137,7 @@ void RfidReader::switch_mode() {
 static void comparator_trigger_callback(bool level, void* comp_ctx) {
     RfidReader* _this = static_cast<RfidReader*>(comp_ctx);
 
-    RfidReaderAccessor::decode(*_this, !level);
+    RfidReaderAccessor::capture(*_this, !level);
 }
 
 RfidReader::RfidReader() {
@@ -74,6 +146,8 @@ RfidReader::RfidReader() {
 void RfidReader::start() {
     type = Type::Normal;
 
+    start_decoder();
+
     furi_hal_rfid_pins_read();
     furi_hal_rfid_tim_read(125000, 0.5);
     furi_hal_rfid_tim_read_start();
@@ -95,6 +169,8 @@ void RfidReader::stop() {
     furi_hal_rfid_tim_read_stop();
     furi_hal_rfid_tim_reset();
     stop_comparator();
+
+    stop_decoder();
 }
 
 bool RfidReader::read(LfrfidKeyType* _type, uint8_t* data, uint8_t data_size, bool switch_enable) {
@@ -162,6 +238,10 @@ bool RfidReader::any_read() {
     return last_read_count > 0;
 }
 
+uint32_t RfidReader::get_dropped_edges() {
+    return dropped_edges;
+}
+
 void RfidReader::start_comparator(void) {
     furi_hal_rfid_comp_set_callback(comparator_trigger_callback, this);
     last_dwt_value = DWT->CYCCNT;
@@ -1,4 +1,6 @@
 #pragma once
+#include <furi.h>
+#include <stream_buffer.h>
 //#include "decoder_analyzer.h"
 #include "decoder_gpio_out.h"
 #include "decoder_emmarin.h"
@@ -25,6 +27,9 @@ public:
     bool detect();
     bool any_read();
 
+    /** Edges lost because the decoder thread didn't keep up, counted since start */
+    uint32_t get_dropped_edges();
+
 private:
     friend struct RfidReaderAccessor;
 
@@ -42,7 +47,17 @@ private:
     void start_comparator(void);
     void stop_comparator(void);
 
-    void decode(bool polarity);
+    // Comparator edges are timestamped in the ISR and decoded in a thread
+    FuriThread* decoder_thread = NULL;
+    StreamBufferHandle_t edge_stream = NULL;
+    volatile bool decoder_running = false;
+    volatile uint32_t dropped_edges = 0;
+
+    void capture(bool polarity);
+    void decode(bool polarity, uint32_t period);
+    static int32_t decoder_thread_callback(void* context);
+    void start_decoder();
+    void stop_decoder();
 
     uint32_t detect_ticks;
 
@@ -100,6 +100,11 @@ static void lfrfid_cli_read(Cli* cli, string_t args) {
     printf("Reading stopped\r\n");
     reader.stop();
 
+    uint32_t dropped_edges = reader.get_dropped_edges();
+    if(dropped_edges) {
+        printf("Dropped edges: %lu\r\n", dropped_edges);
+    }
+
     string_clear(type_string);
 }
 
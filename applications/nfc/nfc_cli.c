@@ -5,6 +5,10 @@
 
 #include <lib/nfc/nfc_types.h>
 #include <lib/nfc/nfc_device.h>
+#include <lib/nfc/helpers/mfkey32_log.h>
+#include <lib/nfc/helpers/mf_classic_dict.h>
+#include <lib/nfc/protocols/nfc_util.h>
+#include <lib/toolbox/stream/buffered_file_stream.h>
 
 static void nfc_cli_print_usage() {
     printf("Usage:\r\n");
@@ -12,6 +16,7 @@ static void nfc_cli_print_usage() {
     printf("Cmd list:\r\n");
     printf("\tdetect\t - detect nfc device\r\n");
     printf("\temulate\t - emulate predefined nfca card\r\n");
+    printf("\tmfkey32 [memory_kb]\t - recover keys from nonces collected during emulation\r\n");
     if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
         printf("\tfield\t - turn field on\r\n");
     }
@@ -98,6 +103,78 @@ static void nfc_cli_field(Cli* cli, string_t args) {
     furi_hal_nfc_sleep();
 }
 
+static bool nfc_cli_mfkey32_add_key(MfClassicDict* dict, uint64_t key) {
+    uint64_t dict_key = 0;
+    mf_classic_dict_rewind(dict);
+    while(mf_classic_dict_get_next_key(dict, &dict_key)) {
+        if(dict_key == key) return false;
+    }
+    uint8_t key_bytes[6];
+    nfc_util_num2bytes(key, sizeof(key_bytes), key_bytes);
+    return mf_classic_dict_add_key(dict, key_bytes);
+}
+
+static void nfc_cli_mfkey32(Cli* cli, string_t args) {
+    // Bigger budget means fewer passes over all states, default is lowered to fit free heap
+    int memory_kb_max = memmgr_get_free_heap() / 1024;
+    int memory_kb = MIN(MFKEY32_MEMORY_DEFAULT / 1024, memory_kb_max);
+    if(string_size(args) && !args_read_int_and_trim(args, &memory_kb)) {
+        printf("Invalid memory size\r\n");
+        return;
+    }
+    if(memory_kb < MFKEY32_MEMORY_MIN / 1024 || memory_kb > memory_kb_max) {
+        printf(
+            "Memory size must be from %d to %d KB\r\n", MFKEY32_MEMORY_MIN / 1024, memory_kb_max);
+        return;
+    }
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    MfClassicDict* dict = mf_classic_dict_alloc(MfClassicDictTypeUser);
+    string_t line;
+    string_init(line);
+
+    do {
+        if(!buffered_file_stream_open(stream, MFKEY32_LOG_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            printf("No nonces collected, emulate Mifare Classic to a reader first\r\n");
+            break;
+        }
+        printf("Press Ctrl+C to abort after current key\r\n");
+        uint32_t found_count = 0;
+        uint32_t added_count = 0;
+        // Log is processed line by line, nonces are never loaded at once
+        while(stream_read_line(stream, line) && !cli_cmd_interrupt_received(cli)) {
+            Mfkey32Params params;
+            if(!mfkey32_parse_line(string_get_cstr(line), &params)) continue;
+            printf(
+                "cuid %08lX sector %d key %c: ",
+                params.cuid,
+                params.sector,
+                (params.key_type == MfClassicKeyA) ? 'A' : 'B');
+            uint64_t key = 0;
+            uint32_t start = furi_get_tick();
+            Mfkey32Result result = mfkey32_recover(&params, memory_kb * 1024, &key);
+            if(result == Mfkey32ResultFound) {
+                found_count++;
+                printf("%04lX%08lX", (uint32_t)(key >> 32), (uint32_t)key);
+                if(dict && nfc_cli_mfkey32_add_key(dict, key)) added_count++;
+            } else if(result == Mfkey32ResultOutOfMemory) {
+                printf("not found, out of memory, try a bigger memory size");
+            } else {
+                printf("not found");
+            }
+            printf(" in %lu ms\r\n", furi_get_tick() - start);
+        }
+        printf("Keys found: %lu, added to user dictionary: %lu\r\n", found_count, added_count);
+    } while(false);
+
+    string_clear(line);
+    if(dict) mf_classic_dict_free(dict);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+}
+
 static void nfc_cli(Cli* cli, string_t args, void* context) {
     UNUSED(context);
     string_t cmd;
@@ -116,6 +193,10 @@ static void nfc_cli(Cli* cli, string_t args, void* context) {
             nfc_cli_emulate(cli, args);
             break;
         }
+        if(string_cmp_str(cmd, "mfkey32") == 0) {
+            nfc_cli_mfkey32(cli, args);
+            break;
+        }
 
         if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
             if(string_cmp_str(cmd, "field") == 0) {
@@ -37,6 +37,7 @@ static void nfc_scene_mf_classic_dict_attack_prepare_view(Nfc* nfc, DictAttackSt
     NfcMfClassicDictAttackData* dict_attack_data = &nfc->dev->dev_data.mf_classic_dict_attack_data;
     NfcWorkerState worker_state = NfcWorkerStateReady;
     MfClassicDict* dict = NULL;
+    bool is_user_dict_done = (state == DictAttackStateUserDictInProgress);
 
     // Identify scene state
     if(state == DictAttackStateIdle) {
@@ -68,6 +69,9 @@ static void nfc_scene_mf_classic_dict_attack_prepare_view(Nfc* nfc, DictAttackSt
         if(!dict) {
             FURI_LOG_E(TAG, "Flipper dictionary not found");
             // Pass through to let worker handle the failure
+        } else if(is_user_dict_done && dict_attack_data->dict) {
+            // Keys of user dictionary were tried already
+            mf_classic_dict_remove_keys_of(dict, dict_attack_data->dict);
         }
     }
     // Free previous dictionary
@@ -26,6 +26,11 @@ typedef enum {
 
 #define RPC_ALL_EVENTS (RpcEvtNewData | RpcEvtDisconnect)
 
+/* Message header and file fields around the data chunk */
+#define RPC_FRAME_OVERHEAD (64)
+/* Max size of varint length prefix for a message */
+#define RPC_LENGTH_PREFIX_SIZE (5)
+
 DICT_DEF2(RpcHandlerDict, pb_size_t, M_DEFAULT_OPLIST, RpcHandler, M_POD_OPLIST)
 
 typedef struct {
@@ -67,8 +72,12 @@ struct RpcSession {
     bool terminate;
     void** system_contexts;
     bool decode_error;
+    size_t max_chunk_size;
+    size_t max_message_size;
 
     FuriMutex* callbacks_mutex;
+    uint8_t* tx_buffer;
+    size_t tx_buffer_size;
     RpcSendBytesCallback send_bytes_callback;
     RpcBufferIsEmptyCallback buffer_is_empty_callback;
     RpcSessionClosedCallback closed_callback;
@@ -400,6 +409,25 @@ void rpc_session_set_terminated_callback(
     furi_mutex_release(session->callbacks_mutex);
 }
 
+void rpc_session_set_max_chunk_size(RpcSession* session, size_t size) {
+    furi_assert(session);
+    furi_assert(size > 0);
+    furi_assert(size <= RPC_MAX_CHUNK_SIZE);
+
+    furi_mutex_acquire(session->callbacks_mutex, FuriWaitForever);
+    session->max_chunk_size = size;
+    session->max_message_size = MAX(RPC_MAX_MESSAGE_SIZE, size + RPC_FRAME_OVERHEAD);
+    free(session->tx_buffer);
+    session->tx_buffer_size = session->max_message_size + RPC_LENGTH_PREFIX_SIZE;
+    session->tx_buffer = malloc(session->tx_buffer_size);
+    furi_mutex_release(session->callbacks_mutex);
+}
+
+size_t rpc_session_get_max_chunk_size(RpcSession* session) {
+    furi_assert(session);
+    return session->max_chunk_size;
+}
+
 /* Doesn't forbid using rpc_feed_bytes() after session close - it's safe.
  * Because any bytes received in buffer will be flushed before next session.
  * If bytes get into stream buffer before it's get epmtified and this
@@ -494,7 +522,7 @@ static int32_t rpc_session_worker(void* context) {
             .callback = rpc_pb_stream_read,
             .state = session,
             .errmsg = NULL,
-            .bytes_left = RPC_MAX_MESSAGE_SIZE, /* max incoming message size */
+            .bytes_left = session->max_message_size, /* max incoming message size */
         };
 
         bool message_decode_failed = false;
@@ -593,6 +621,7 @@ static void rpc_session_free_callback(FuriThreadState thread_state, void* contex
         furi_mutex_release(session->callbacks_mutex);
 
         furi_mutex_free(session->callbacks_mutex);
+        free(session->tx_buffer);
         furi_thread_free(session->thread);
         free(session);
     }
@@ -607,6 +636,7 @@ RpcSession* rpc_session_open(Rpc* rpc) {
     session->rpc = rpc;
     session->terminate = false;
     session->decode_error = false;
+    rpc_session_set_max_chunk_size(session, RPC_DEFAULT_CHUNK_SIZE);
     RpcHandlerDict_init(session->handlers);
 
     session->decoded_message = malloc(sizeof(PB_Main));
@@ -674,32 +704,51 @@ void rpc_send(RpcSession* session, PB_Main* message) {
     furi_assert(session);
     furi_assert(message);
 
-    pb_ostream_t ostream = PB_OSTREAM_SIZING;
-
 #if SRV_RPC_DEBUG
     FURI_LOG_I(TAG, "OUTPUT:");
     rpc_print_message(message);
 #endif
 
-    bool result = pb_encode_ex(&ostream, &PB_Main_msg, message, PB_ENCODE_DELIMITED);
-    furi_check(result && ostream.bytes_written);
+    furi_mutex_acquire(session->callbacks_mutex, FuriWaitForever);
 
-    uint8_t* buffer = malloc(ostream.bytes_written);
-    ostream = pb_ostream_from_buffer(buffer, ostream.bytes_written);
+    /* Message is encoded in one pass into session buffer after the space
+     * reserved for length prefix, prefix is put before it afterwards.
+     * Messages that don't fit are encoded into temporary buffer. */
+    uint8_t* buffer = session->tx_buffer;
+    size_t buffer_size = session->tx_buffer_size;
+    pb_ostream_t ostream = pb_ostream_from_buffer(
+        buffer + RPC_LENGTH_PREFIX_SIZE, buffer_size - RPC_LENGTH_PREFIX_SIZE);
+    bool result = pb_encode(&ostream, &PB_Main_msg, message);
+    if(!result) {
+        ostream = (pb_ostream_t)PB_OSTREAM_SIZING;
+        furi_check(pb_encode(&ostream, &PB_Main_msg, message));
+        buffer_size = ostream.bytes_written + RPC_LENGTH_PREFIX_SIZE;
+        buffer = malloc(buffer_size);
+        ostream = pb_ostream_from_buffer(
+            buffer + RPC_LENGTH_PREFIX_SIZE, buffer_size - RPC_LENGTH_PREFIX_SIZE);
+        result = pb_encode(&ostream, &PB_Main_msg, message);
+    }
+    furi_check(result && ostream.bytes_written);
 
-    pb_encode_ex(&ostream, &PB_Main_msg, message, PB_ENCODE_DELIMITED);
+    uint8_t prefix[RPC_LENGTH_PREFIX_SIZE];
+    pb_ostream_t prefix_stream = pb_ostream_from_buffer(prefix, sizeof(prefix));
+    pb_encode_varint(&prefix_stream, ostream.bytes_written);
+    uint8_t* frame = buffer + RPC_LENGTH_PREFIX_SIZE - prefix_stream.bytes_written;
+    memcpy(frame, prefix, prefix_stream.bytes_written);
+    size_t frame_size = prefix_stream.bytes_written + ostream.bytes_written;
 
 #if SRV_RPC_DEBUG
-    rpc_print_data("OUTPUT", buffer, ostream.bytes_written);
+    rpc_print_data("OUTPUT", frame, frame_size);
 #endif
 
-    furi_mutex_acquire(session->callbacks_mutex, FuriWaitForever);
     if(session->send_bytes_callback) {
-        session->send_bytes_callback(session->context, buffer, ostream.bytes_written);
+        session->send_bytes_callback(session->context, frame, frame_size);
     }
-    furi_mutex_release(session->callbacks_mutex);
 
-    free(buffer);
+    if(buffer != session->tx_buffer) {
+        free(buffer);
+    }
+    furi_mutex_release(session->callbacks_mutex);
 }
 
 void rpc_send_and_release(RpcSession* session, PB_Main* message) {
@@ -7,6 +7,8 @@
 
 #define RPC_BUFFER_SIZE (1024)
 #define RPC_MAX_MESSAGE_SIZE (1536)
+#define RPC_DEFAULT_CHUNK_SIZE (512)
+#define RPC_MAX_CHUNK_SIZE (2048)
 
 #define RECORD_RPC "rpc"
 
@@ -96,6 +98,15 @@ void rpc_session_set_terminated_callback(
     RpcSession* session,
     RpcSessionTerminatedCallback callback);
 
+/** Set max size of data chunk in one message
+ * Default is RPC_DEFAULT_CHUNK_SIZE, transport with high throughput can
+ * use bigger frames. Bigger incoming messages are accepted too.
+ *
+ * @param   session     pointer to RpcSession descriptor
+ * @param   size        chunk size, up to RPC_MAX_CHUNK_SIZE
+ */
+void rpc_session_set_max_chunk_size(RpcSession* session, size_t size);
+
 /** Give bytes to RPC service to decode them and perform command
  *
  * @param   session     pointer to RpcSession descriptor
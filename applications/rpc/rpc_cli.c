@@ -55,6 +55,7 @@ void rpc_cli_command_start_session(Cli* cli, string_t args, void* context) {
     CliRpc cli_rpc = {.cli = cli, .session_close_request = false};
     cli_rpc.terminate_semaphore = furi_semaphore_alloc(1, 0);
     rpc_session_set_context(rpc_session, &cli_rpc);
+    rpc_session_set_max_chunk_size(rpc_session, RPC_MAX_CHUNK_SIZE);
     rpc_session_set_send_bytes_callback(rpc_session, rpc_send_bytes_callback);
     rpc_session_set_close_callback(rpc_session, rpc_session_close_callback);
     rpc_session_set_terminated_callback(rpc_session, rpc_session_terminated_callback);
@@ -5,6 +5,9 @@
 
 #define TAG "RpcGui"
 
+// Frames are sent not more often than this, commits in between are coalesced
+#define RPC_GUI_FRAME_INTERVAL_MIN_MS 33
+
 typedef enum {
     RpcGuiWorkerFlagTransmit = (1 << 0),
     RpcGuiWorkerFlagExit = (1 << 1),
@@ -23,6 +26,13 @@ typedef struct {
     // Transmit
     PB_Main* transmit_frame;
     FuriThread* transmit_thread;
+    FuriMutex* transmit_mutex;
+    uint8_t* transmit_pending;
+    bool transmit_frame_valid;
+    uint32_t transmit_interval;
+    uint32_t transmit_last_tick;
+    uint32_t transmit_sent;
+    uint32_t transmit_skipped;
 
     bool virtual_display_not_empty;
     bool is_streaming;
@@ -34,15 +44,31 @@ static void
     furi_assert(context);
 
     RpcGuiSystem* rpc_gui = (RpcGuiSystem*)context;
-    uint8_t* buffer = rpc_gui->transmit_frame->content.gui_screen_frame.data->bytes;
 
     furi_assert(size == rpc_gui->transmit_frame->content.gui_screen_frame.data->size);
 
-    memcpy(buffer, data, size);
+    // Frame being sent is not touched, GUI thread never waits for the link
+    furi_check(furi_mutex_acquire(rpc_gui->transmit_mutex, FuriWaitForever) == FuriStatusOk);
+    memcpy(rpc_gui->transmit_pending, data, size);
+    furi_check(furi_mutex_release(rpc_gui->transmit_mutex) == FuriStatusOk);
 
     furi_thread_flags_set(furi_thread_get_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagTransmit);
 }
 
+static bool rpc_system_gui_screen_stream_frame_take(RpcGuiSystem* rpc_gui) {
+    pb_bytes_array_t* data = rpc_gui->transmit_frame->content.gui_screen_frame.data;
+    bool changed = !rpc_gui->transmit_frame_valid;
+
+    furi_check(furi_mutex_acquire(rpc_gui->transmit_mutex, FuriWaitForever) == FuriStatusOk);
+    if(changed || memcmp(data->bytes, rpc_gui->transmit_pending, data->size) != 0) {
+        memcpy(data->bytes, rpc_gui->transmit_pending, data->size);
+        changed = true;
+    }
+    furi_check(furi_mutex_release(rpc_gui->transmit_mutex) == FuriStatusOk);
+
+    return changed;
+}
+
 static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context) {
     furi_assert(context);
 
@@ -51,17 +77,69 @@ static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context)
     while(true) {
         uint32_t flags =
             furi_thread_flags_wait(RpcGuiWorkerFlagAny, FuriFlagWaitAny, FuriWaitForever);
-        if(flags & RpcGuiWorkerFlagTransmit) {
-            rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
-        }
         if(flags & RpcGuiWorkerFlagExit) {
             break;
         }
+        if(flags & RpcGuiWorkerFlagTransmit) {
+            uint32_t elapsed = furi_get_tick() - rpc_gui->transmit_last_tick;
+            if(elapsed < rpc_gui->transmit_interval) {
+                flags = furi_thread_flags_wait(
+                    RpcGuiWorkerFlagExit,
+                    FuriFlagWaitAny,
+                    rpc_gui->transmit_interval - elapsed);
+                if(!(flags & FuriFlagError) && (flags & RpcGuiWorkerFlagExit)) {
+                    break;
+                }
+            }
+            // Commits made while waiting are sent as one frame
+            furi_thread_flags_clear(RpcGuiWorkerFlagTransmit);
+
+            // Unchanged screen is not sent again
+            if(!rpc_system_gui_screen_stream_frame_take(rpc_gui)) {
+                rpc_gui->transmit_skipped++;
+                continue;
+            }
+
+            uint32_t start = furi_get_tick();
+            rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
+            rpc_gui->transmit_last_tick = furi_get_tick();
+            rpc_gui->transmit_frame_valid = true;
+            rpc_gui->transmit_sent++;
+
+            // Slow link: leave as much time for other session traffic as one frame takes
+            uint32_t duration = rpc_gui->transmit_last_tick - start;
+            rpc_gui->transmit_interval =
+                MAX(furi_ms_to_ticks(RPC_GUI_FRAME_INTERVAL_MIN_MS), duration);
+        }
     }
 
     return 0;
 }
 
+static void rpc_system_gui_screen_stream_stop(RpcGuiSystem* rpc_gui) {
+    rpc_gui->is_streaming = false;
+    // Remove GUI framebuffer callback
+    gui_remove_framebuffer_callback(
+        rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, rpc_gui);
+    // Stop and release worker thread
+    furi_thread_flags_set(furi_thread_get_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
+    furi_thread_join(rpc_gui->transmit_thread);
+    furi_thread_free(rpc_gui->transmit_thread);
+    FURI_LOG_D(
+        TAG,
+        "Frames sent: %lu, unchanged: %lu",
+        rpc_gui->transmit_sent,
+        rpc_gui->transmit_skipped);
+    // Release frame
+    pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
+    free(rpc_gui->transmit_frame);
+    rpc_gui->transmit_frame = NULL;
+    free(rpc_gui->transmit_pending);
+    rpc_gui->transmit_pending = NULL;
+    furi_mutex_free(rpc_gui->transmit_mutex);
+    rpc_gui->transmit_mutex = NULL;
+}
+
 static void rpc_system_gui_start_screen_stream_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(context);
@@ -87,6 +165,13 @@ static void rpc_system_gui_start_screen_stream_process(const PB_Main* request, v
         rpc_gui->transmit_frame->content.gui_screen_frame.data =
             malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(framebuffer_size));
         rpc_gui->transmit_frame->content.gui_screen_frame.data->size = framebuffer_size;
+        rpc_gui->transmit_pending = malloc(framebuffer_size);
+        rpc_gui->transmit_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+        rpc_gui->transmit_frame_valid = false;
+        rpc_gui->transmit_interval = furi_ms_to_ticks(RPC_GUI_FRAME_INTERVAL_MIN_MS);
+        rpc_gui->transmit_last_tick = furi_get_tick() - rpc_gui->transmit_interval;
+        rpc_gui->transmit_sent = 0;
+        rpc_gui->transmit_skipped = 0;
         // Transmission thread for async TX
         rpc_gui->transmit_thread = furi_thread_alloc();
         furi_thread_set_name(rpc_gui->transmit_thread, "GuiRpcWorker");
@@ -112,18 +197,7 @@ static void rpc_system_gui_stop_screen_stream_process(const PB_Main* request, vo
     furi_assert(session);
 
     if(rpc_gui->is_streaming) {
-        rpc_gui->is_streaming = false;
-        // Remove GUI framebuffer callback
-        gui_remove_framebuffer_callback(
-            rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, context);
-        // Stop and release worker thread
-        furi_thread_flags_set(furi_thread_get_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
-        furi_thread_join(rpc_gui->transmit_thread);
-        furi_thread_free(rpc_gui->transmit_thread);
-        // Release frame
-        pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
-        free(rpc_gui->transmit_frame);
-        rpc_gui->transmit_frame = NULL;
+        rpc_system_gui_screen_stream_stop(rpc_gui);
     }
 
     rpc_send_and_release_empty(session, request->command_id, PB_CommandStatus_OK);
@@ -361,18 +435,7 @@ void rpc_system_gui_free(void* context) {
     }
 
     if(rpc_gui->is_streaming) {
-        rpc_gui->is_streaming = false;
-        // Remove GUI framebuffer callback
-        gui_remove_framebuffer_callback(
-            rpc_gui->gui, rpc_system_gui_screen_stream_frame_callback, context);
-        // Stop and release worker thread
-        furi_thread_flags_set(furi_thread_get_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagExit);
-        furi_thread_join(rpc_gui->transmit_thread);
-        furi_thread_free(rpc_gui->transmit_thread);
-        // Release frame
-        pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
-        free(rpc_gui->transmit_frame);
-        rpc_gui->transmit_frame = NULL;
+        rpc_system_gui_screen_stream_stop(rpc_gui);
     }
     furi_record_close(RECORD_GUI);
     free(rpc_gui);
@@ -25,6 +25,8 @@ void rpc_send_and_release_empty(RpcSession* session, uint32_t command_id, PB_Com
 
 void rpc_add_handler(RpcSession* session, pb_size_t message_tag, RpcHandler* handler);
 
+size_t rpc_session_get_max_chunk_size(RpcSession* session);
+
 void* rpc_system_system_alloc(RpcSession* session);
 void* rpc_system_storage_alloc(RpcSession* session);
 void rpc_system_storage_free(void* ctx);
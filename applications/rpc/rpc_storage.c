@@ -17,7 +17,8 @@
 
 #define MAX_NAME_LENGTH 255
 
-static const size_t MAX_DATA_SIZE = 512;
+#define READER_BUFFERS 2
+#define READER_STACK_SIZE 1024
 
 typedef enum {
     RpcStorageStateIdle = 0,
@@ -279,6 +280,71 @@ static void rpc_system_storage_list_process(const PB_Main* request, void* contex
     furi_record_close(RECORD_STORAGE);
 }
 
+typedef struct {
+    File* file;
+    size_t size_left;
+    size_t chunk_size;
+    pb_bytes_array_t* buffers[READER_BUFFERS];
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* ready_queue;
+    FuriThread* thread;
+} RpcStorageReader;
+
+/* Reads next chunks while session thread sends previous ones */
+static int32_t rpc_system_storage_reader_worker(void* context) {
+    RpcStorageReader* reader = context;
+
+    while(reader->size_left) {
+        pb_bytes_array_t* data;
+        furi_check(
+            furi_message_queue_get(reader->free_queue, &data, FuriWaitForever) == FuriStatusOk);
+
+        size_t read_size = MIN(reader->size_left, reader->chunk_size);
+        data->size = storage_file_read(reader->file, data->bytes, read_size);
+        bool success = (data->size == read_size);
+        reader->size_left -= data->size;
+
+        furi_check(
+            furi_message_queue_put(reader->ready_queue, &data, FuriWaitForever) == FuriStatusOk);
+        if(!success) break;
+    }
+
+    return 0;
+}
+
+static RpcStorageReader* rpc_system_storage_reader_alloc(File* file, size_t chunk_size) {
+    RpcStorageReader* reader = malloc(sizeof(RpcStorageReader));
+    reader->file = file;
+    reader->size_left = storage_file_size(file);
+    reader->chunk_size = chunk_size;
+    reader->free_queue = furi_message_queue_alloc(READER_BUFFERS, sizeof(pb_bytes_array_t*));
+    reader->ready_queue = furi_message_queue_alloc(READER_BUFFERS, sizeof(pb_bytes_array_t*));
+    for(size_t i = 0; i < READER_BUFFERS; ++i) {
+        reader->buffers[i] = malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(chunk_size));
+        furi_message_queue_put(reader->free_queue, &reader->buffers[i], FuriWaitForever);
+    }
+
+    reader->thread = furi_thread_alloc();
+    furi_thread_set_name(reader->thread, "RpcStorageReader");
+    furi_thread_set_stack_size(reader->thread, READER_STACK_SIZE);
+    furi_thread_set_context(reader->thread, reader);
+    furi_thread_set_callback(reader->thread, rpc_system_storage_reader_worker);
+    furi_thread_start(reader->thread);
+
+    return reader;
+}
+
+static void rpc_system_storage_reader_free(RpcStorageReader* reader) {
+    furi_thread_join(reader->thread);
+    furi_thread_free(reader->thread);
+    for(size_t i = 0; i < READER_BUFFERS; ++i) {
+        free(reader->buffers[i]);
+    }
+    furi_message_queue_free(reader->free_queue);
+    furi_message_queue_free(reader->ready_queue);
+    free(reader);
+}
+
 static void rpc_system_storage_read_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(context);
@@ -294,6 +360,11 @@ static void rpc_system_storage_read_process(const PB_Main* request, void* contex
 
     /* use same message memory to send reponse */
     PB_Main* response = malloc(sizeof(PB_Main));
+    response->command_id = request->command_id;
+    response->which_content = PB_Main_storage_read_response_tag;
+    response->command_status = PB_CommandStatus_OK;
+    response->content.storage_read_response.has_file = true;
+
     const char* path = request->content.storage_read_request.path;
     Storage* fs_api = furi_record_open(RECORD_STORAGE);
     File* file = storage_file_alloc(fs_api);
@@ -301,37 +372,38 @@ static void rpc_system_storage_read_process(const PB_Main* request, void* contex
 
     if(fs_operation_success) {
         size_t size_left = storage_file_size(file);
-        do {
-            response->command_id = request->command_id;
-            response->which_content = PB_Main_storage_read_response_tag;
-            response->command_status = PB_CommandStatus_OK;
-
-            size_t read_size = MIN(size_left, MAX_DATA_SIZE);
-            if(read_size) {
-                response->content.storage_read_response.has_file = true;
-                response->content.storage_read_response.file.data =
-                    malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(read_size));
-                uint8_t* buffer = &response->content.storage_read_response.file.data->bytes[0];
-                uint16_t* read_size_msg = &response->content.storage_read_response.file.data->size;
-
-                *read_size_msg = storage_file_read(file, buffer, read_size);
-                size_left -= *read_size_msg;
-                fs_operation_success = (*read_size_msg == read_size);
-
-                response->has_next = fs_operation_success && (size_left > 0);
-            } else {
-                response->content.storage_read_response.file.data =
-                    malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(0));
-                response->content.storage_read_response.file.data->size = 0;
-                response->content.storage_read_response.has_file = true;
-                response->has_next = false;
-                fs_operation_success = true;
-            }
+        if(size_left == 0) {
+            pb_bytes_array_t empty_data = {.size = 0};
+            response->content.storage_read_response.file.data = &empty_data;
+            response->has_next = false;
+            rpc_send(session, response);
+        } else {
+            /* Chunk buffers are reused, they aren't released with the message */
+            RpcStorageReader* reader =
+                rpc_system_storage_reader_alloc(file, rpc_session_get_max_chunk_size(session));
+            do {
+                pb_bytes_array_t* data;
+                furi_check(
+                    furi_message_queue_get(reader->ready_queue, &data, FuriWaitForever) ==
+                    FuriStatusOk);
+
+                size_t read_size = MIN(size_left, reader->chunk_size);
+                fs_operation_success = (data->size == read_size);
+                size_left -= data->size;
+
+                if(fs_operation_success) {
+                    response->content.storage_read_response.file.data = data;
+                    response->has_next = (size_left > 0);
+                    rpc_send(session, response);
+                }
 
-            if(fs_operation_success) {
-                rpc_send_and_release(session, response);
-            }
-        } while((size_left != 0) && fs_operation_success);
+                furi_check(
+                    furi_message_queue_put(reader->free_queue, &data, FuriWaitForever) ==
+                    FuriStatusOk);
+            } while((size_left != 0) && fs_operation_success);
+            rpc_system_storage_reader_free(reader);
+        }
+        response->content.storage_read_response.file.data = NULL;
     }
 
     if(!fs_operation_success) {
@@ -47,6 +47,7 @@ typedef struct File File;
 typedef struct {
     uint8_t flags; /**< flags from FS_Flags enum */
     uint64_t size; /**< file size */
+    uint32_t mtime; /**< modification time, unix timestamp, 0 if not supported */
 } FileInfo;
 
 /** Gets the error text from FS_Error
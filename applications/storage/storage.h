@@ -300,6 +300,150 @@ FS_Error storage_int_backup(Storage* api, const char* dstname);
  */
 FS_Error storage_int_restore(Storage* api, const char* dstname, Storage_name_converter converter);
 
+/******************* Batch Functions *******************/
+
+/** Batch of storage operations, executed by the storage thread in one request.
+ * Operations are done in order. Operations on a file are skipped after an operation
+ * on this file failed, except close, which is done for an opened file.
+ * Opening a file that is already open is not retried, it fails with FSE_ALREADY_OPEN.
+ * Paths, buffers and result pointers must be valid until the batch is submitted.
+ */
+typedef struct StorageBatch StorageBatch;
+
+/** Allocates an empty batch
+ * @param storage pointer to the api
+ * @return StorageBatch* 
+ */
+StorageBatch* storage_batch_alloc(Storage* storage);
+
+/** Frees the batch
+ * @param batch 
+ */
+void storage_batch_free(StorageBatch* batch);
+
+/** Removes all operations from the batch
+ * @param batch 
+ */
+void storage_batch_reset(StorageBatch* batch);
+
+/** Adds storage_file_open to the batch, the result is in the file error
+ * @param batch 
+ * @param file pointer to file object.
+ * @param path path to file
+ * @param access_mode access mode from FS_AccessMode
+ * @param open_mode open mode from FS_OpenMode 
+ */
+void storage_batch_file_open(
+    StorageBatch* batch,
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+
+/** Adds storage_file_close to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ */
+void storage_batch_file_close(StorageBatch* batch, File* file);
+
+/** Adds storage_file_read to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ * @param buff pointer to a buffer, for reading
+ * @param bytes_to_read how many bytes to read
+ * @param bytes_read how many bytes were actually read, may be NULL
+ */
+void storage_batch_file_read(
+    StorageBatch* batch,
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    uint16_t* bytes_read);
+
+/** Adds storage_file_write to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ * @param buff pointer to buffer, for writing
+ * @param bytes_to_write how many bytes to write
+ * @param bytes_written how many bytes were actually written, may be NULL
+ */
+void storage_batch_file_write(
+    StorageBatch* batch,
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    uint16_t* bytes_written);
+
+/** Adds storage_file_seek to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ * @param offset offset to move the r/w pointer
+ * @param from_start set an offset from the start or from the current position
+ */
+void storage_batch_file_seek(StorageBatch* batch, File* file, uint32_t offset, bool from_start);
+
+/** Adds storage_dir_open to the batch, the result is in the file error
+ * @param batch 
+ * @param file pointer to file object.
+ * @param path path to directory
+ */
+void storage_batch_dir_open(StorageBatch* batch, File* file, const char* path);
+
+/** Adds storage_dir_close to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ */
+void storage_batch_dir_close(StorageBatch* batch, File* file);
+
+/** Adds storage_dir_read to the batch
+ * @param batch 
+ * @param file pointer to file object.
+ * @param fileinfo pointer to the read FileInfo, may be NULL
+ * @param name pointer to name buffer, may be NULL
+ * @param name_length name buffer length
+ * @param result success flag, may be NULL
+ */
+void storage_batch_dir_read(
+    StorageBatch* batch,
+    File* file,
+    FileInfo* fileinfo,
+    char* name,
+    uint16_t name_length,
+    bool* result);
+
+/** Adds storage_common_stat to the batch
+ * @param batch 
+ * @param path path to a file or a directory
+ * @param fileinfo pointer to the readed FileInfo, may be NULL
+ * @param error operation result, may be NULL
+ */
+void storage_batch_common_stat(
+    StorageBatch* batch,
+    const char* path,
+    FileInfo* fileinfo,
+    FS_Error* error);
+
+/** Adds storage_common_remove to the batch
+ * @param batch 
+ * @param path path to a file or a directory
+ * @param error operation result, may be NULL
+ */
+void storage_batch_common_remove(StorageBatch* batch, const char* path, FS_Error* error);
+
+/** Adds storage_common_mkdir to the batch
+ * @param batch 
+ * @param path path to a directory
+ * @param error operation result, may be NULL
+ */
+void storage_batch_common_mkdir(StorageBatch* batch, const char* path, FS_Error* error);
+
+/** Executes all operations of the batch in one storage request.
+ * Operations are kept, the same batch can be submitted again.
+ * @param batch 
+ * @return true if all operations succeeded (reading past the last directory entry is a failure)
+ */
+bool storage_batch_submit(StorageBatch* batch);
+
 /***************** Simplified Functions ******************/
 
 /**
@@ -5,10 +5,13 @@
 #include <lib/toolbox/args.h>
 #include <lib/toolbox/md5.h>
 #include <lib/toolbox/dir_walk.h>
+#include <lib/toolbox/dir_manifest.h>
 #include <storage/storage.h>
 #include <storage/storage_sd_api.h>
 #include <power/power_service/power.h>
 
+#define TAG "StorageCli"
+
 #define MAX_NAME_LENGTH 255
 
 static void storage_cli_print_usage() {
@@ -31,6 +34,7 @@ static void storage_cli_print_usage() {
     printf("\trename\t - move file to new file, <args> must contain new path\r\n");
     printf("\tmkdir\t - creates a new directory\r\n");
     printf("\tmd5\t - md5 hash of the file\r\n");
+    printf("\tmanifest\t - list files recursive with md5, mtime and size\r\n");
     printf("\tstat\t - info about file or dir\r\n");
 };
 
@@ -70,6 +74,11 @@ static void storage_cli_info(Cli* cli, string_t path) {
                 sd_api_get_fs_type_text(sd_info.fs_type),
                 sd_info.kb_total,
                 sd_info.kb_free);
+            printf(
+                "Cache: %lu hits, %lu misses, %lu write-backs\r\n",
+                sd_info.cache_hits,
+                sd_info.cache_misses,
+                sd_info.cache_write_backs);
         }
     } else {
         storage_cli_print_usage();
@@ -487,6 +496,51 @@ static void storage_cli_md5(Cli* cli, string_t path) {
     furi_record_close(RECORD_STORAGE);
 }
 
+static void storage_cli_manifest(Cli* cli, string_t path) {
+    Storage* api = furi_record_open(RECORD_STORAGE);
+    DirManifest* manifest = dir_manifest_alloc(api);
+    string_t name;
+    string_init(name);
+
+    if(dir_manifest_open(manifest, string_get_cstr(path))) {
+        DirManifestEntry entry;
+        DirWalkResult result;
+
+        while((result = dir_manifest_read(manifest, name, &entry)) == DirWalkOK) {
+            if(entry.fileinfo.flags & FSF_DIRECTORY) {
+                printf("\t[D] %s\r\n", string_get_cstr(name));
+            } else {
+                printf("\t[F] ");
+                for(uint8_t i = 0; i < DIR_MANIFEST_HASH_SIZE; i++) {
+                    printf("%02x", entry.md5[i]);
+                }
+                printf(
+                    " %lu %lu %s\r\n",
+                    entry.fileinfo.mtime,
+                    (uint32_t)(entry.fileinfo.size),
+                    string_get_cstr(name));
+            }
+
+            if(cli_cmd_interrupt_received(cli)) break;
+        }
+
+        if(result == DirWalkError) {
+            storage_cli_print_error(dir_manifest_get_error(manifest));
+        }
+
+        DirManifestStats stats;
+        dir_manifest_get_stats(manifest, &stats);
+        FURI_LOG_I(TAG, "Manifest: %u cached, %u hashed", stats.cached, stats.hashed);
+    } else {
+        storage_cli_print_error(dir_manifest_get_error(manifest));
+    }
+
+    dir_manifest_close(manifest);
+    string_clear(name);
+    dir_manifest_free(manifest);
+    furi_record_close(RECORD_STORAGE);
+}
+
 void storage_cli(Cli* cli, string_t args, void* context) {
     UNUSED(context);
     string_t cmd;
@@ -575,6 +629,11 @@ void storage_cli(Cli* cli, string_t args, void* context) {
             break;
         }
 
+        if(string_cmp_str(cmd, "manifest") == 0) {
+            storage_cli_manifest(cli, path);
+            break;
+        }
+
         storage_cli_print_usage();
     } while(false);
 
@@ -1,6 +1,7 @@
 #include <core/log.h>
 #include <core/record.h>
 #include <m-string.h>
+#include <m-array.h>
 #include "storage.h"
 #include "storage_i.h"
 #include "storage_message.h"
@@ -13,9 +14,7 @@
 
 #define TAG "StorageAPI"
 
-#define S_API_PROLOGUE                                     \
-    FuriSemaphore* semaphore = furi_semaphore_alloc(1, 0); \
-    furi_check(semaphore != NULL);
+#define S_API_PROLOGUE FuriThreadId thread_id = furi_thread_get_current_id();
 
 #define S_FILE_API_PROLOGUE           \
     Storage* storage = file->storage; \
@@ -25,13 +24,12 @@
     furi_check(                                                                      \
         furi_message_queue_put(storage->message_queue, &message, FuriWaitForever) == \
         FuriStatusOk);                                                               \
-    furi_semaphore_acquire(semaphore, FuriWaitForever);                              \
-    furi_semaphore_free(semaphore);
+    furi_check(furi_thread_signal_wait(FuriWaitForever));
 
 #define S_API_MESSAGE(_command)      \
     SAReturn return_data;            \
     StorageMessage message = {       \
-        .semaphore = semaphore,      \
+        .thread_id = thread_id,      \
         .command = _command,         \
         .data = &data,               \
         .return_data = &return_data, \
@@ -597,6 +595,202 @@ FS_Error storage_common_fs_info(
     return S_RETURN_ERROR;
 }
 
+/****************** BATCH ******************/
+
+ARRAY_DEF(StorageBatchOperationArray, StorageBatchOperation, M_POD_OPLIST);
+
+struct StorageBatch {
+    Storage* storage;
+    StorageBatchOperationArray_t operations;
+};
+
+StorageBatch* storage_batch_alloc(Storage* storage) {
+    furi_assert(storage);
+    StorageBatch* batch = malloc(sizeof(StorageBatch));
+    batch->storage = storage;
+    StorageBatchOperationArray_init(batch->operations);
+    return batch;
+}
+
+void storage_batch_free(StorageBatch* batch) {
+    furi_assert(batch);
+    StorageBatchOperationArray_clear(batch->operations);
+    free(batch);
+}
+
+void storage_batch_reset(StorageBatch* batch) {
+    furi_assert(batch);
+    StorageBatchOperationArray_reset(batch->operations);
+}
+
+static StorageBatchOperation*
+    storage_batch_push(StorageBatch* batch, StorageCommand command, void* result) {
+    furi_assert(batch);
+    StorageBatchOperation* operation = StorageBatchOperationArray_push_new(batch->operations);
+    memset(operation, 0, sizeof(StorageBatchOperation));
+    operation->command = command;
+    operation->result = result;
+    return operation;
+}
+
+void storage_batch_file_open(
+    StorageBatch* batch,
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandFileOpen, NULL);
+    operation->data.fopen.file = file;
+    operation->data.fopen.path = path;
+    operation->data.fopen.access_mode = access_mode;
+    operation->data.fopen.open_mode = open_mode;
+}
+
+void storage_batch_file_close(StorageBatch* batch, File* file) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandFileClose, NULL);
+    operation->data.file.file = file;
+}
+
+void storage_batch_file_read(
+    StorageBatch* batch,
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    uint16_t* bytes_read) {
+    StorageBatchOperation* operation =
+        storage_batch_push(batch, StorageCommandFileRead, bytes_read);
+    operation->data.fread.file = file;
+    operation->data.fread.buff = buff;
+    operation->data.fread.bytes_to_read = bytes_to_read;
+}
+
+void storage_batch_file_write(
+    StorageBatch* batch,
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    uint16_t* bytes_written) {
+    StorageBatchOperation* operation =
+        storage_batch_push(batch, StorageCommandFileWrite, bytes_written);
+    operation->data.fwrite.file = file;
+    operation->data.fwrite.buff = buff;
+    operation->data.fwrite.bytes_to_write = bytes_to_write;
+}
+
+void storage_batch_file_seek(StorageBatch* batch, File* file, uint32_t offset, bool from_start) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandFileSeek, NULL);
+    operation->data.fseek.file = file;
+    operation->data.fseek.offset = offset;
+    operation->data.fseek.from_start = from_start;
+}
+
+void storage_batch_dir_open(StorageBatch* batch, File* file, const char* path) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandDirOpen, NULL);
+    operation->data.dopen.file = file;
+    operation->data.dopen.path = path;
+}
+
+void storage_batch_dir_close(StorageBatch* batch, File* file) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandDirClose, NULL);
+    operation->data.file.file = file;
+}
+
+void storage_batch_dir_read(
+    StorageBatch* batch,
+    File* file,
+    FileInfo* fileinfo,
+    char* name,
+    uint16_t name_length,
+    bool* result) {
+    StorageBatchOperation* operation = storage_batch_push(batch, StorageCommandDirRead, result);
+    operation->data.dread.file = file;
+    operation->data.dread.fileinfo = fileinfo;
+    operation->data.dread.name = name;
+    operation->data.dread.name_length = name_length;
+}
+
+void storage_batch_common_stat(
+    StorageBatch* batch,
+    const char* path,
+    FileInfo* fileinfo,
+    FS_Error* error) {
+    StorageBatchOperation* operation =
+        storage_batch_push(batch, StorageCommandCommonStat, error);
+    operation->data.cstat.path = path;
+    operation->data.cstat.fileinfo = fileinfo;
+}
+
+void storage_batch_common_remove(StorageBatch* batch, const char* path, FS_Error* error) {
+    StorageBatchOperation* operation =
+        storage_batch_push(batch, StorageCommandCommonRemove, error);
+    operation->data.path.path = path;
+}
+
+void storage_batch_common_mkdir(StorageBatch* batch, const char* path, FS_Error* error) {
+    StorageBatchOperation* operation =
+        storage_batch_push(batch, StorageCommandCommonMkDir, error);
+    operation->data.path.path = path;
+}
+
+bool storage_batch_submit(StorageBatch* batch) {
+    furi_assert(batch);
+    Storage* storage = batch->storage;
+    size_t count = StorageBatchOperationArray_size(batch->operations);
+    if(count == 0) {
+        return true;
+    }
+
+    S_API_PROLOGUE;
+    SAData data = {
+        .batch = {
+            .operations = StorageBatchOperationArray_get(batch->operations, 0),
+            .count = count,
+        }};
+    S_API_MESSAGE(StorageCommandBatch);
+    S_API_EPILOGUE;
+
+    bool result = true;
+    for(size_t i = 0; i < count; i++) {
+        StorageBatchOperation* operation = StorageBatchOperationArray_get(batch->operations, i);
+        result &= (operation->error == FSE_OK);
+
+        switch(operation->command) {
+        case StorageCommandFileOpen:
+            operation->data.fopen.file->type = FileTypeOpenFile;
+            break;
+        case StorageCommandDirOpen:
+            operation->data.dopen.file->type = FileTypeOpenDir;
+            break;
+        case StorageCommandFileClose:
+        case StorageCommandDirClose:
+            operation->data.file.file->type = FileTypeClosed;
+            break;
+        case StorageCommandFileRead:
+        case StorageCommandFileWrite:
+            if(operation->result) {
+                *(uint16_t*)operation->result = operation->return_data.uint16_value;
+            }
+            break;
+        case StorageCommandDirRead:
+            if(operation->result) {
+                *(bool*)operation->result = operation->return_data.bool_value;
+            }
+            break;
+        case StorageCommandCommonStat:
+        case StorageCommandCommonRemove:
+        case StorageCommandCommonMkDir:
+            if(operation->result) {
+                *(FS_Error*)operation->result = operation->error;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return result;
+}
+
 /****************** ERROR ******************/
 
 const char* storage_error_get_desc(FS_Error error_id) {
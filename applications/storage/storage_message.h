@@ -69,6 +69,13 @@ typedef struct {
     SDInfo* info;
 } SAInfo;
 
+typedef struct StorageBatchOperation StorageBatchOperation;
+
+typedef struct {
+    StorageBatchOperation* operations;
+    size_t count;
+} SADataBatch;
+
 typedef union {
     SADataFOpen fopen;
     SADataFRead fread;
@@ -87,6 +94,8 @@ typedef union {
     SADataPath path;
 
     SAInfo sdinfo;
+
+    SADataBatch batch;
 } SAData;
 
 typedef union {
@@ -120,10 +129,20 @@ typedef enum {
     StorageCommandSDUnmount,
     StorageCommandSDInfo,
     StorageCommandSDStatus,
+    StorageCommandBatch,
 } StorageCommand;
 
+struct StorageBatchOperation {
+    StorageCommand command;
+    SAData data;
+    SAReturn return_data;
+    FS_Error error;
+    // Caller side result pointer, not used by the storage thread
+    void* result;
+};
+
 typedef struct {
-    FuriSemaphore* semaphore;
+    FuriThreadId thread_id;
     StorageCommand command;
     SAData* data;
     SAReturn* return_data;
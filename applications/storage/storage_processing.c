@@ -466,118 +466,176 @@ static FS_Error storage_process_sd_status(Storage* app) {
 }
 
 /****************** API calls processing ******************/
-void storage_process_message_internal(Storage* app, StorageMessage* message) {
-    switch(message->command) {
+static void storage_process_batch(Storage* app, StorageBatchOperation* operations, size_t count);
+
+static void storage_process_command(
+    Storage* app,
+    StorageCommand command,
+    SAData* data,
+    SAReturn* return_data) {
+    switch(command) {
     case StorageCommandFileOpen:
-        message->return_data->bool_value = storage_process_file_open(
+        return_data->bool_value = storage_process_file_open(
             app,
-            message->data->fopen.file,
-            message->data->fopen.path,
-            message->data->fopen.access_mode,
-            message->data->fopen.open_mode);
+            data->fopen.file,
+            data->fopen.path,
+            data->fopen.access_mode,
+            data->fopen.open_mode);
         break;
     case StorageCommandFileClose:
-        message->return_data->bool_value =
-            storage_process_file_close(app, message->data->fopen.file);
+        return_data->bool_value = storage_process_file_close(app, data->fopen.file);
         break;
     case StorageCommandFileRead:
-        message->return_data->uint16_value = storage_process_file_read(
-            app,
-            message->data->fread.file,
-            message->data->fread.buff,
-            message->data->fread.bytes_to_read);
+        return_data->uint16_value = storage_process_file_read(
+            app, data->fread.file, data->fread.buff, data->fread.bytes_to_read);
         break;
     case StorageCommandFileWrite:
-        message->return_data->uint16_value = storage_process_file_write(
-            app,
-            message->data->fwrite.file,
-            message->data->fwrite.buff,
-            message->data->fwrite.bytes_to_write);
+        return_data->uint16_value = storage_process_file_write(
+            app, data->fwrite.file, data->fwrite.buff, data->fwrite.bytes_to_write);
         break;
     case StorageCommandFileSeek:
-        message->return_data->bool_value = storage_process_file_seek(
-            app,
-            message->data->fseek.file,
-            message->data->fseek.offset,
-            message->data->fseek.from_start);
+        return_data->bool_value = storage_process_file_seek(
+            app, data->fseek.file, data->fseek.offset, data->fseek.from_start);
         break;
     case StorageCommandFileTell:
-        message->return_data->uint64_value =
-            storage_process_file_tell(app, message->data->file.file);
+        return_data->uint64_value = storage_process_file_tell(app, data->file.file);
         break;
     case StorageCommandFileTruncate:
-        message->return_data->bool_value =
-            storage_process_file_truncate(app, message->data->file.file);
+        return_data->bool_value = storage_process_file_truncate(app, data->file.file);
         break;
     case StorageCommandFileSync:
-        message->return_data->bool_value =
-            storage_process_file_sync(app, message->data->file.file);
+        return_data->bool_value = storage_process_file_sync(app, data->file.file);
         break;
     case StorageCommandFileSize:
-        message->return_data->uint64_value =
-            storage_process_file_size(app, message->data->file.file);
+        return_data->uint64_value = storage_process_file_size(app, data->file.file);
         break;
     case StorageCommandFileEof:
-        message->return_data->bool_value = storage_process_file_eof(app, message->data->file.file);
+        return_data->bool_value = storage_process_file_eof(app, data->file.file);
         break;
 
     case StorageCommandDirOpen:
-        message->return_data->bool_value =
-            storage_process_dir_open(app, message->data->dopen.file, message->data->dopen.path);
+        return_data->bool_value = storage_process_dir_open(
+            app, data->dopen.file, data->dopen.path);
         break;
     case StorageCommandDirClose:
-        message->return_data->bool_value =
-            storage_process_dir_close(app, message->data->file.file);
+        return_data->bool_value = storage_process_dir_close(app, data->file.file);
         break;
     case StorageCommandDirRead:
-        message->return_data->bool_value = storage_process_dir_read(
+        return_data->bool_value = storage_process_dir_read(
             app,
-            message->data->dread.file,
-            message->data->dread.fileinfo,
-            message->data->dread.name,
-            message->data->dread.name_length);
+            data->dread.file,
+            data->dread.fileinfo,
+            data->dread.name,
+            data->dread.name_length);
         break;
     case StorageCommandDirRewind:
-        message->return_data->bool_value =
-            storage_process_dir_rewind(app, message->data->file.file);
+        return_data->bool_value = storage_process_dir_rewind(app, data->file.file);
         break;
     case StorageCommandCommonStat:
-        message->return_data->error_value = storage_process_common_stat(
-            app, message->data->cstat.path, message->data->cstat.fileinfo);
+        return_data->error_value = storage_process_common_stat(
+            app, data->cstat.path, data->cstat.fileinfo);
         break;
     case StorageCommandCommonRemove:
-        message->return_data->error_value =
-            storage_process_common_remove(app, message->data->path.path);
+        return_data->error_value = storage_process_common_remove(app, data->path.path);
         break;
     case StorageCommandCommonMkDir:
-        message->return_data->error_value =
-            storage_process_common_mkdir(app, message->data->path.path);
+        return_data->error_value = storage_process_common_mkdir(app, data->path.path);
         break;
     case StorageCommandCommonFSInfo:
-        message->return_data->error_value = storage_process_common_fs_info(
-            app,
-            message->data->cfsinfo.fs_path,
-            message->data->cfsinfo.total_space,
-            message->data->cfsinfo.free_space);
+        return_data->error_value = storage_process_common_fs_info(
+            app, data->cfsinfo.fs_path, data->cfsinfo.total_space, data->cfsinfo.free_space);
         break;
     case StorageCommandSDFormat:
-        message->return_data->error_value = storage_process_sd_format(app);
+        return_data->error_value = storage_process_sd_format(app);
         break;
     case StorageCommandSDUnmount:
-        message->return_data->error_value = storage_process_sd_unmount(app);
+        return_data->error_value = storage_process_sd_unmount(app);
         break;
     case StorageCommandSDInfo:
-        message->return_data->error_value =
-            storage_process_sd_info(app, message->data->sdinfo.info);
+        return_data->error_value = storage_process_sd_info(app, data->sdinfo.info);
         break;
     case StorageCommandSDStatus:
-        message->return_data->error_value = storage_process_sd_status(app);
+        return_data->error_value = storage_process_sd_status(app);
+        break;
+    case StorageCommandBatch:
+        storage_process_batch(app, data->batch.operations, data->batch.count);
+        return_data->bool_value = true;
         break;
     }
+}
 
-    furi_semaphore_release(message->semaphore);
+static File* storage_batch_operation_get_file(StorageBatchOperation* operation) {
+    switch(operation->command) {
+    case StorageCommandFileOpen:
+        return operation->data.fopen.file;
+    case StorageCommandFileRead:
+        return operation->data.fread.file;
+    case StorageCommandFileWrite:
+        return operation->data.fwrite.file;
+    case StorageCommandFileSeek:
+        return operation->data.fseek.file;
+    case StorageCommandDirOpen:
+        return operation->data.dopen.file;
+    case StorageCommandDirRead:
+        return operation->data.dread.file;
+    case StorageCommandFileClose:
+    case StorageCommandFileTell:
+    case StorageCommandFileTruncate:
+    case StorageCommandFileSize:
+    case StorageCommandFileSync:
+    case StorageCommandFileEof:
+    case StorageCommandDirClose:
+    case StorageCommandDirRewind:
+        return operation->data.file.file;
+    default:
+        return NULL;
+    }
+}
+
+static void storage_process_batch(Storage* app, StorageBatchOperation* operations, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        StorageBatchOperation* operation = &operations[i];
+        File* file = storage_batch_operation_get_file(operation);
+        furi_check(operation->command != StorageCommandBatch);
+
+        memset(&operation->return_data, 0, sizeof(SAReturn));
+        operation->error = FSE_OK;
+
+        if(file) {
+            if(operation->command == StorageCommandFileClose ||
+               operation->command == StorageCommandDirClose) {
+                // Close only what is open, the error of a failed open is kept in the file
+                if(get_storage_by_file(file, app->storage) == NULL) {
+                    operation->error = FSE_INVALID_PARAMETER;
+                    continue;
+                }
+            } else {
+                // Operations on a file are skipped after a failed one, with the same error
+                for(size_t j = 0; j < i; j++) {
+                    if(storage_batch_operation_get_file(&operations[j]) == file &&
+                       operations[j].error != FSE_OK) {
+                        operation->error = operations[j].error;
+                    }
+                }
+                if(operation->error != FSE_OK) continue;
+            }
+        }
+
+        storage_process_command(
+            app, operation->command, &operation->data, &operation->return_data);
+
+        if(file) {
+            operation->error = file->error_id;
+        } else if(
+            operation->command == StorageCommandCommonStat ||
+            operation->command == StorageCommandCommonRemove ||
+            operation->command == StorageCommandCommonMkDir) {
+            operation->error = operation->return_data.error_value;
+        }
+    }
 }
 
 void storage_process_message(Storage* app, StorageMessage* message) {
-    storage_process_message_internal(app, message);
+    storage_process_command(app, message->command, message->data, message->return_data);
+    furi_thread_signal(message->thread_id);
 }
@@ -106,6 +106,8 @@ FS_Error sd_unmount_card(StorageData* storage) {
     // TODO do i need to close the files?
 
     f_mount(0, sd_data->path, 0);
+    // Cached sectors can't be written to a removed card
+    USER_cache_reset(hal_sd_detect());
     storage_data_unlock(storage);
     return storage_ext_parse_error(error);
 }
@@ -162,8 +164,14 @@ FS_Error sd_card_info(StorageData* storage, SDInfo* sd_info) {
         error = f_getfree(sd_data->path, &free_clusters, &fs);
 #endif
     }
+    SectorCacheStats cache_stats;
+    USER_cache_get_stats(&cache_stats);
     storage_data_unlock(storage);
 
+    sd_info->cache_hits = cache_stats.hits + cache_stats.read_ahead_hits;
+    sd_info->cache_misses = cache_stats.misses;
+    sd_info->cache_write_backs = cache_stats.write_backs;
+
     if(error == FR_OK) {
         // calculate size
 #ifndef FURI_RAM_EXEC
@@ -300,6 +308,24 @@ static FS_Error storage_ext_parse_error(SDError error) {
     return result;
 }
 
+static uint32_t storage_ext_parse_timestamp(WORD fdate, WORD ftime) {
+    FuriHalRtcDateTime datetime = {
+        .year = 1980 + (fdate >> 9),
+        .month = (fdate >> 5) & 0x0F,
+        .day = fdate & 0x1F,
+        .hour = ftime >> 11,
+        .minute = (ftime >> 5) & 0x3F,
+        .second = (ftime & 0x1F) * 2,
+    };
+
+    // Entries written without a clock have zero date
+    if(datetime.month < 1 || datetime.month > 12 || datetime.day < 1) {
+        return 0;
+    }
+
+    return furi_hal_rtc_datetime_to_timestamp(&datetime);
+}
+
 /******************* File Functions *******************/
 
 static bool storage_ext_file_open(
@@ -478,6 +504,7 @@ static bool storage_ext_dir_read(
 
     if(fileinfo != NULL) {
         fileinfo->size = _fileinfo.fsize;
+        fileinfo->mtime = storage_ext_parse_timestamp(_fileinfo.fdate, _fileinfo.ftime);
         fileinfo->flags = 0;
 
         if(_fileinfo.fattrib & AM_DIR) fileinfo->flags |= FSF_DIRECTORY;
@@ -511,6 +538,7 @@ static FS_Error storage_ext_common_stat(void* ctx, const char* path, FileInfo* f
 
     if(fileinfo != NULL) {
         fileinfo->size = _fileinfo.fsize;
+        fileinfo->mtime = storage_ext_parse_timestamp(_fileinfo.fdate, _fileinfo.ftime);
         fileinfo->flags = 0;
 
         if(_fileinfo.fattrib & AM_DIR) fileinfo->flags |= FSF_DIRECTORY;
@@ -620,6 +620,7 @@ static bool storage_int_dir_read(
 
         if(fileinfo != NULL) {
             fileinfo->size = _fileinfo.size;
+            fileinfo->mtime = 0;
             fileinfo->flags = 0;
             if(_fileinfo.type & LFS_TYPE_DIR) fileinfo->flags |= FSF_DIRECTORY;
         }
@@ -665,6 +666,7 @@ static FS_Error storage_int_common_stat(void* ctx, const char* path, FileInfo* f
 
     if(fileinfo != NULL) {
         fileinfo->size = _fileinfo.size;
+        fileinfo->mtime = 0;
         fileinfo->flags = 0;
         if(_fileinfo.type & LFS_TYPE_DIR) fileinfo->flags |= FSF_DIRECTORY;
     }
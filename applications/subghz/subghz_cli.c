@@ -10,6 +10,7 @@
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_file_decoder.h>
 
 #include "helpers/subghz_chat.h"
 
@@ -305,6 +306,25 @@ void subghz_cli_command_rx(Cli* cli, string_t args, void* context) {
     free(instance);
 }
 
+static void subghz_cli_command_print_decoder_stats(SubGhzReceiver* receiver) {
+    SubGhzReceiverDecoderStats stats;
+    printf(
+        "Active decoders: %u of %u\r\n",
+        subghz_receiver_get_active_decoder_count(receiver),
+        subghz_receiver_get_decoder_count(receiver));
+    for(size_t i = 0; i < subghz_receiver_get_decoder_count(receiver); i++) {
+        subghz_receiver_get_decoder_stats(receiver, i, &stats);
+        if(stats.feed_count) {
+            printf(
+                "%-20s feed: %-8lu cycles: %-10lu avg: %lu\r\n",
+                stats.name,
+                stats.feed_count,
+                stats.cycle_count,
+                stats.cycle_count / stats.feed_count);
+        }
+    }
+}
+
 void subghz_cli_command_decode_raw(Cli* cli, string_t args, void* context) {
     UNUSED(context);
     string_t file_name;
@@ -340,7 +360,8 @@ void subghz_cli_command_decode_raw(Cli* cli, string_t args, void* context) {
         }
 
         if(!strcmp(string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE) &&
-           temp_data32 == SUBGHZ_KEY_FILE_VERSION) {
+           (temp_data32 == SUBGHZ_RAW_FILE_VERSION ||
+            temp_data32 == SUBGHZ_RAW_FILE_VERSION_PACKED)) {
         } else {
             printf("subghz decode_raw \033[0;31mType or version mismatch\033[0m\r\n");
             break;
@@ -379,6 +400,7 @@ void subghz_cli_command_decode_raw(Cli* cli, string_t args, void* context) {
         SubGhzReceiver* receiver = subghz_receiver_alloc_init(environment);
         subghz_receiver_set_filter(receiver, SubGhzProtocolFlag_Decodable);
         subghz_receiver_set_rx_callback(receiver, subghz_cli_command_rx_callback, instance);
+        subghz_receiver_set_profiling(receiver, true);
 
         SubGhzFileEncoderWorker* file_worker_encoder = subghz_file_encoder_worker_alloc();
         if(subghz_file_encoder_worker_start(file_worker_encoder, string_get_cstr(file_name))) {
@@ -404,6 +426,7 @@ void subghz_cli_command_decode_raw(Cli* cli, string_t args, void* context) {
         }
 
         printf("\r\nPackets recieved \033[0;32m%u\033[0m\r\n", instance->packet_count);
+        subghz_cli_command_print_decoder_stats(receiver);
 
         // Cleanup
         subghz_receiver_free(receiver);
@@ -418,6 +441,78 @@ void subghz_cli_command_decode_raw(Cli* cli, string_t args, void* context) {
     string_clear(file_name);
 }
 
+static void subghz_cli_command_decode_bench_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    UNUSED(decoder_base);
+    UNUSED(context);
+    subghz_receiver_reset(receiver);
+}
+
+void subghz_cli_command_decode_bench(Cli* cli, string_t args, void* context) {
+    UNUSED(cli);
+    UNUSED(context);
+    string_t file_name;
+    string_init(file_name);
+
+    do {
+        if(!args_read_string_and_trim(args, file_name)) {
+            cli_print_usage(
+                "subghz decode_bench", "<file_name: path_RAW_file>", string_get_cstr(args));
+            break;
+        }
+
+        SubGhzEnvironment* environment = subghz_environment_alloc();
+        subghz_environment_load_keystore(environment, EXT_PATH("subghz/assets/keeloq_mfcodes"));
+        subghz_environment_load_keystore(
+            environment, EXT_PATH("subghz/assets/keeloq_mfcodes_user"));
+        subghz_environment_set_came_atomo_rainbow_table_file_name(
+            environment, EXT_PATH("subghz/assets/came_atomo"));
+        subghz_environment_set_nice_flor_s_rainbow_table_file_name(
+            environment, EXT_PATH("subghz/assets/nice_flor_s"));
+
+        SubGhzFileDecoder* file_decoder = subghz_file_decoder_alloc(environment);
+        subghz_file_decoder_set_rx_callback(
+            file_decoder, subghz_cli_command_decode_bench_callback, NULL);
+
+        if(subghz_file_decoder_run(file_decoder, string_get_cstr(file_name))) {
+            uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+            uint32_t decode_us =
+                (uint32_t)(subghz_file_decoder_get_decode_cycles(file_decoder) / cycles_per_us);
+            uint32_t sample_count = subghz_file_decoder_get_sample_count(file_decoder);
+            printf(
+                "Samples: %lu, packets: %lu, decode time: %lu us, %llu samples/s\r\n",
+                sample_count,
+                subghz_file_decoder_get_packet_count(file_decoder),
+                decode_us,
+                decode_us ? (uint64_t)sample_count * 1000000 / decode_us : 0);
+
+            SubGhzFileDecoderProtocolStats stats;
+            for(size_t i = 0; i < subghz_file_decoder_get_protocol_count(file_decoder); i++) {
+                subghz_file_decoder_get_protocol_stats(file_decoder, i, &stats);
+                if(!stats.feed_count) continue;
+                uint32_t protocol_us = stats.cycle_count / cycles_per_us;
+                printf(
+                    "%-20s packets: %-4lu time: %-8lu us %llu samples/s\r\n",
+                    stats.name,
+                    stats.packet_count,
+                    protocol_us,
+                    protocol_us ? (uint64_t)stats.feed_count * 1000000 / protocol_us : 0);
+            }
+        } else {
+            printf(
+                "subghz decode_bench \033[0;31mError decoding file\033[0m %s\r\n",
+                string_get_cstr(file_name));
+        }
+
+        subghz_file_decoder_free(file_decoder);
+        subghz_environment_free(environment);
+    } while(false);
+
+    string_clear(file_name);
+}
+
 static void subghz_cli_command_print_usage() {
     printf("Usage:\r\n");
     printf("subghz <cmd> <args>\r\n");
@@ -428,6 +523,7 @@ static void subghz_cli_command_print_usage() {
         "\ttx <3 byte Key: in hex> <frequency: in Hz> <repeat: count>\t - Transmitting key\r\n");
     printf("\trx <frequency:in Hz>\t - Reception key\r\n");
     printf("\tdecode_raw <file_name: path_RAW_file>\t - Testing\r\n");
+    printf("\tdecode_bench <file_name: path_RAW_file>\t - Decoder throughput\r\n");
 
     if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
         printf("\r\n");
@@ -733,6 +829,11 @@ static void subghz_cli_command(Cli* cli, string_t args, void* context) {
             break;
         }
 
+        if(string_cmp_str(cmd, "decode_bench") == 0) {
+            subghz_cli_command_decode_bench(cli, args, context);
+            break;
+        }
+
         if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
             if(string_cmp_str(cmd, "encrypt_keeloq") == 0) {
                 subghz_cli_command_encrypt_keeloq(cli, args);
@@ -260,9 +260,11 @@ bool subghz_key_load(SubGhz* subghz, const char* file_path, bool show_dialog) {
             break;
         }
 
-        if(((!strcmp(string_get_cstr(temp_str), SUBGHZ_KEY_FILE_TYPE)) ||
-            (!strcmp(string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE))) &&
-           temp_data32 == SUBGHZ_KEY_FILE_VERSION) {
+        if(((!strcmp(string_get_cstr(temp_str), SUBGHZ_KEY_FILE_TYPE)) &&
+            temp_data32 == SUBGHZ_KEY_FILE_VERSION) ||
+           ((!strcmp(string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE)) &&
+            (temp_data32 == SUBGHZ_RAW_FILE_VERSION ||
+             temp_data32 == SUBGHZ_RAW_FILE_VERSION_PACKED))) {
         } else {
             FURI_LOG_E(TAG, "Type or version mismatch");
             break;
@@ -180,6 +180,7 @@ struct SubGhzSetting {
     FrequencyList_t frequencies;
     FrequencyList_t hopper_frequencies;
     SubGhzSettingCustomPresetStruct* preset;
+    bool raw_packed;
 };
 
 SubGhzSetting* subghz_setting_alloc(void) {
@@ -283,6 +284,7 @@ static void subghz_setting_load_default_region(
 }
 
 void subghz_setting_load_default(SubGhzSetting* instance) {
+    instance->raw_packed = false;
     switch(furi_hal_version_get_hw_region()) {
     case FuriHalVersionRegionEuRu:
         subghz_setting_load_default_region(
@@ -313,6 +315,7 @@ void subghz_setting_load(SubGhzSetting* instance, const char* file_path) {
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
     FlipperFormat* fff_data_file = flipper_format_file_alloc(storage);
+    flipper_format_set_key_index(fff_data_file, true);
 
     string_t temp_str;
     string_init(temp_str);
@@ -396,6 +399,15 @@ void subghz_setting_load(SubGhzSetting* instance, const char* file_path) {
                     }
             }
 
+            // Packed RAW recordings (optional)
+            if(!flipper_format_rewind(fff_data_file)) {
+                FURI_LOG_E(TAG, "Rewind error");
+                break;
+            }
+            if(flipper_format_read_bool(fff_data_file, "Raw_packed", &temp_bool, 1)) {
+                instance->raw_packed = temp_bool;
+            }
+
             // custom preset (optional)
             if(!flipper_format_rewind(fff_data_file)) {
                 FURI_LOG_E(TAG, "Rewind error");
@@ -565,3 +577,8 @@ uint32_t subghz_setting_get_default_frequency(SubGhzSetting* instance) {
     return subghz_setting_get_frequency(
         instance, subghz_setting_get_frequency_default_index(instance));
 }
+
+bool subghz_setting_get_raw_packed(SubGhzSetting* instance) {
+    furi_assert(instance);
+    return instance->raw_packed;
+}
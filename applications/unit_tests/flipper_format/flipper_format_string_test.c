@@ -267,6 +267,51 @@ MU_TEST_1(flipper_format_read_and_update_test, FlipperFormat* flipper_format) {
         flipper_format, test_uint_key, ARRAY_W_COUNT(uint32_updated_data)));
 }
 
+static const char* test_data_batch_updated = "Filetype: Flipper Format test\n"
+                                             "Version: 666\n"
+                                             "# This is comment\n"
+                                             "String data: New string\n"
+                                             "Int32 data: -1337 69\n"
+                                             "Uint32 data: 1234 0 5678 9098 7654321\n"
+                                             "Hex data: FE CA\n";
+
+MU_TEST_1(flipper_format_update_batch_test, FlipperFormat* flipper_format) {
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    char data[256];
+
+    stream_clean(stream);
+    stream_write_cstring(stream, test_data_nix);
+
+    flipper_format_update_begin(flipper_format);
+    mu_check(flipper_format_update_string_cstr(
+        flipper_format, test_string_key, test_string_updated_data));
+    mu_check(flipper_format_update_int32(
+        flipper_format, test_int_key, ARRAY_W_COUNT(test_int_updated_data)));
+    mu_check(flipper_format_update_hex(
+        flipper_format, test_hex_key, ARRAY_W_COUNT(test_hex_updated_data)));
+    mu_check(flipper_format_delete_key(flipper_format, test_float_key));
+    // queued updates are not visible yet
+    mu_assert_int_eq(strlen(test_data_nix), stream_size(stream));
+    mu_check(flipper_format_update_commit(flipper_format));
+
+    memset(data, 0, sizeof(data));
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(strlen(test_data_batch_updated), stream_read(stream, (uint8_t*)data, 255));
+    mu_assert_string_eq(test_data_batch_updated, data);
+
+    // nothing is changed if one of the keys is missing
+    flipper_format_update_begin(flipper_format);
+    mu_check(flipper_format_update_string_cstr(
+        flipper_format, test_string_key, test_string_updated_2_data));
+    mu_check(flipper_format_update_string_cstr(flipper_format, "Key that doesn't exist", ""));
+    mu_check(!flipper_format_update_commit(flipper_format));
+
+    memset(data, 0, sizeof(data));
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(strlen(test_data_batch_updated), stream_read(stream, (uint8_t*)data, 255));
+    mu_assert_string_eq(test_data_batch_updated, data);
+}
+
 MU_TEST(flipper_format_string_test) {
     FlipperFormat* flipper_format = flipper_format_string_alloc();
     Stream* stream = flipper_format_get_raw_stream(flipper_format);
@@ -292,6 +337,24 @@ MU_TEST(flipper_format_string_test) {
     stream_write_cstring(stream, test_data_win);
     MU_RUN_TEST_1(flipper_format_read_and_update_test, flipper_format);
 
+    MU_RUN_TEST_1(flipper_format_update_batch_test, flipper_format);
+
+    flipper_format_free(flipper_format);
+}
+
+MU_TEST(flipper_format_key_index_test) {
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+
+    stream_write_cstring(stream, test_data_nix);
+    flipper_format_set_key_index(flipper_format, true);
+    MU_RUN_TEST_1(flipper_format_read_and_update_test, flipper_format);
+
+    stream_clean(stream);
+    stream_write_cstring(stream, test_data_win);
+    flipper_format_set_key_index(flipper_format, true);
+    MU_RUN_TEST_1(flipper_format_read_and_update_test, flipper_format);
+
     flipper_format_free(flipper_format);
 }
 
@@ -322,6 +385,8 @@ MU_TEST(flipper_format_file_test) {
     stream_write_cstring(stream, test_data_win);
     MU_RUN_TEST_1(flipper_format_read_and_update_test, flipper_format);
 
+    MU_RUN_TEST_1(flipper_format_update_batch_test, flipper_format);
+
     flipper_format_free(flipper_format);
     furi_record_close(RECORD_STORAGE);
 }
@@ -329,6 +394,7 @@ MU_TEST(flipper_format_file_test) {
 MU_TEST_SUITE(flipper_format_string_suite) {
     MU_RUN_TEST(flipper_format_string_test);
     MU_RUN_TEST(flipper_format_file_test);
+    MU_RUN_TEST(flipper_format_key_index_test);
 }
 
 int run_minunit_test_flipper_format_string() {
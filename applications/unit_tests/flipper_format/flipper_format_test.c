@@ -4,6 +4,8 @@
 #include <toolbox/stream/stream.h>
 #include "../minunit.h"
 
+#define TAG "FlipperFormatTest"
+
 #define TEST_DIR TEST_DIR_NAME "/"
 #define TEST_DIR_NAME EXT_PATH("unit_tests_tmp")
 
@@ -57,6 +59,7 @@ static const char* test_data_win = "Filetype: Flipper File test\r\n"
                                    "Hex data: DE AD BE";
 
 #define READ_TEST_FLP "ff_flp.test"
+#define READ_TEST_BIN "ff_bin.test"
 
 // data created by user on linux machine
 static const char* test_file_linux = TEST_DIR READ_TEST_NIX;
@@ -64,6 +67,8 @@ static const char* test_file_linux = TEST_DIR READ_TEST_NIX;
 static const char* test_file_windows = TEST_DIR READ_TEST_WIN;
 // data created by flipper itself
 static const char* test_file_flipper = TEST_DIR READ_TEST_FLP;
+// data created by flipper itself, binary container
+static const char* test_file_binary = TEST_DIR READ_TEST_BIN;
 
 static bool storage_write_string(const char* path, const char* data) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -237,10 +242,11 @@ static bool test_read_updated(const char* file_name) {
     return result;
 }
 
-static bool test_write(const char* file_name) {
+static bool test_write(const char* file_name, bool binary) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     bool result = false;
     FlipperFormat* file = flipper_format_file_alloc(storage);
+    flipper_format_set_binary(file, binary);
 
     do {
         if(!flipper_format_file_open_always(file, file_name)) break;
@@ -437,65 +443,258 @@ static bool test_read_multikey(const char* file_name) {
     return result;
 }
 
+// Values read with another type are converted the same way for text and binary files
+static bool test_read_converted(const char* file_name) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool result = false;
+
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    string_t string_value;
+    string_init(string_value);
+    uint32_t uint32_value[COUNT_OF(test_int_data)];
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+
+        if(!flipper_format_read_string(file, test_int_key, string_value)) break;
+        if(string_cmp_str(string_value, "1234 -6345 7813 0") != 0) break;
+
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_uint32(file, test_int_key, uint32_value, COUNT_OF(uint32_value)))
+            break;
+        if(memcmp(uint32_value, test_int_data, sizeof(uint32_value)) != 0) break;
+
+        if(!flipper_format_read_string(file, test_bool_key, string_value)) break;
+        if(string_cmp_str(string_value, "true false") != 0) break;
+
+        if(!flipper_format_read_string(file, test_hex_key, string_value)) break;
+        if(string_cmp_str(string_value, "DE AD BE") != 0) break;
+
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_hex(file, test_string_key, (uint8_t*)uint32_value, 1)) {
+            // "String" is not a hex value
+            result = true;
+        }
+    } while(false);
+
+    string_clear(string_value);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return result;
+}
+
+#define BENCHMARK_IR_SIGNALS 100
+#define BENCHMARK_IR_SAMPLES 128
+#define BENCHMARK_NFC_BLOCKS 64
+
+static void test_benchmark_sample(uint32_t* data, size_t count, uint32_t seed) {
+    for(size_t i = 0; i < count; i++) {
+        data[i] = 300 + (seed * 7919 + i * 104729) % 2000;
+    }
+}
+
+static bool test_benchmark_write(const char* file_name, bool binary) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool result = false;
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    flipper_format_set_binary(file, binary);
+    uint32_t* samples = malloc(BENCHMARK_IR_SAMPLES * sizeof(uint32_t));
+    string_t key;
+    string_init(key);
+
+    do {
+        if(!flipper_format_file_open_always(file, file_name)) break;
+        if(!flipper_format_write_header_cstr(file, "IR library file", 1)) break;
+
+        // Raw infrared signals
+        bool error = false;
+        const uint32_t frequency = 38000;
+        const float duty_cycle = 0.33f;
+        for(uint32_t i = 0; i < BENCHMARK_IR_SIGNALS && !error; i++) {
+            test_benchmark_sample(samples, BENCHMARK_IR_SAMPLES, i);
+            error = !flipper_format_write_comment_cstr(file, "") ||
+                    !flipper_format_write_string_cstr(file, "name", "Power") ||
+                    !flipper_format_write_string_cstr(file, "type", "raw") ||
+                    !flipper_format_write_uint32(file, "frequency", &frequency, 1) ||
+                    !flipper_format_write_float(file, "duty_cycle", &duty_cycle, 1) ||
+                    !flipper_format_write_uint32(file, "data", samples, BENCHMARK_IR_SAMPLES);
+        }
+        if(error) break;
+
+        // Mifare Classic dump
+        uint8_t block[16];
+        for(uint32_t i = 0; i < BENCHMARK_NFC_BLOCKS && !error; i++) {
+            memset(block, i, sizeof(block));
+            string_printf(key, "Block %lu", i);
+            error = !flipper_format_write_hex(file, string_get_cstr(key), block, sizeof(block));
+        }
+        if(error) break;
+
+        result = true;
+    } while(false);
+
+    string_clear(key);
+    free(samples);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return result;
+}
+
+static bool test_benchmark_read(const char* file_name, uint32_t* checksum, uint32_t* time) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool result = false;
+    FlipperFormat* file = flipper_format_buffered_file_alloc(storage);
+    uint32_t* samples = malloc(BENCHMARK_IR_SAMPLES * sizeof(uint32_t));
+    string_t value;
+    string_init(value);
+    uint32_t start = furi_get_tick();
+
+    *checksum = 0;
+    do {
+        if(!flipper_format_buffered_file_open_existing(file, file_name)) break;
+        uint32_t version;
+        if(!flipper_format_read_header(file, value, &version)) break;
+
+        uint32_t signals = 0;
+        while(flipper_format_read_string(file, "name", value)) {
+            uint32_t frequency;
+            float duty_cycle;
+            uint32_t count;
+            if(!flipper_format_read_string(file, "type", value)) break;
+            if(!flipper_format_read_uint32(file, "frequency", &frequency, 1)) break;
+            if(!flipper_format_read_float(file, "duty_cycle", &duty_cycle, 1)) break;
+            if(!flipper_format_get_value_count(file, "data", &count)) break;
+            if(count != BENCHMARK_IR_SAMPLES) break;
+            if(!flipper_format_read_uint32(file, "data", samples, count)) break;
+
+            *checksum += frequency + (uint32_t)(duty_cycle * 100);
+            for(size_t i = 0; i < count; i++) {
+                *checksum += samples[i];
+            }
+            signals++;
+        }
+        if(signals != BENCHMARK_IR_SIGNALS) break;
+
+        if(!flipper_format_rewind(file)) break;
+        uint8_t block[16];
+        uint32_t blocks;
+        for(blocks = 0; blocks < BENCHMARK_NFC_BLOCKS; blocks++) {
+            string_printf(value, "Block %lu", blocks);
+            if(!flipper_format_read_hex(file, string_get_cstr(value), block, sizeof(block))) break;
+            for(size_t i = 0; i < sizeof(block); i++) {
+                *checksum += block[i];
+            }
+        }
+        if(blocks != BENCHMARK_NFC_BLOCKS) break;
+
+        result = true;
+    } while(false);
+
+    *time = furi_get_tick() - start;
+
+    string_clear(value);
+    free(samples);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return result;
+}
+
 MU_TEST(flipper_format_write_test) {
     mu_assert(storage_write_string(test_file_linux, test_data_nix), "Write test error [Linux]");
     mu_assert(
         storage_write_string(test_file_windows, test_data_win), "Write test error [Windows]");
-    mu_assert(test_write(test_file_flipper), "Write test error [Flipper]");
+    mu_assert(test_write(test_file_flipper, false), "Write test error [Flipper]");
+    mu_assert(test_write(test_file_binary, true), "Write test error [Binary]");
 }
 
 MU_TEST(flipper_format_read_test) {
     mu_assert(test_read(test_file_linux), "Read test error [Linux]");
     mu_assert(test_read(test_file_windows), "Read test error [Windows]");
     mu_assert(test_read(test_file_flipper), "Read test error [Flipper]");
+    mu_assert(test_read(test_file_binary), "Read test error [Binary]");
 }
 
 MU_TEST(flipper_format_delete_test) {
     mu_assert(test_delete_last_key(test_file_linux), "Cannot delete key [Linux]");
     mu_assert(test_delete_last_key(test_file_windows), "Cannot delete key [Windows]");
     mu_assert(test_delete_last_key(test_file_flipper), "Cannot delete key [Flipper]");
+    mu_assert(test_delete_last_key(test_file_binary), "Cannot delete key [Binary]");
 }
 
 MU_TEST(flipper_format_delete_result_test) {
     mu_assert(!test_read(test_file_linux), "Key deleted incorrectly [Linux]");
     mu_assert(!test_read(test_file_windows), "Key deleted incorrectly [Windows]");
     mu_assert(!test_read(test_file_flipper), "Key deleted incorrectly [Flipper]");
+    mu_assert(!test_read(test_file_binary), "Key deleted incorrectly [Binary]");
 }
 
 MU_TEST(flipper_format_append_test) {
     mu_assert(test_append_key(test_file_linux), "Cannot append data [Linux]");
     mu_assert(test_append_key(test_file_windows), "Cannot append data [Windows]");
     mu_assert(test_append_key(test_file_flipper), "Cannot append data [Flipper]");
+    mu_assert(test_append_key(test_file_binary), "Cannot append data [Binary]");
 }
 
 MU_TEST(flipper_format_append_result_test) {
     mu_assert(test_read(test_file_linux), "Data appended incorrectly [Linux]");
     mu_assert(test_read(test_file_windows), "Data appended incorrectly [Windows]");
     mu_assert(test_read(test_file_flipper), "Data appended incorrectly [Flipper]");
+    mu_assert(test_read(test_file_binary), "Data appended incorrectly [Binary]");
 }
 
 MU_TEST(flipper_format_update_1_test) {
     mu_assert(test_update(test_file_linux), "Cannot update data #1 [Linux]");
     mu_assert(test_update(test_file_windows), "Cannot update data #1 [Windows]");
     mu_assert(test_update(test_file_flipper), "Cannot update data #1 [Flipper]");
+    mu_assert(test_update(test_file_binary), "Cannot update data #1 [Binary]");
 }
 
 MU_TEST(flipper_format_update_1_result_test) {
     mu_assert(test_read_updated(test_file_linux), "Data #1 updated incorrectly [Linux]");
     mu_assert(test_read_updated(test_file_windows), "Data #1 updated incorrectly [Windows]");
     mu_assert(test_read_updated(test_file_flipper), "Data #1 updated incorrectly [Flipper]");
+    mu_assert(test_read_updated(test_file_binary), "Data #1 updated incorrectly [Binary]");
 }
 
 MU_TEST(flipper_format_update_2_test) {
     mu_assert(test_update_backward(test_file_linux), "Cannot update data #2 [Linux]");
     mu_assert(test_update_backward(test_file_windows), "Cannot update data #2 [Windows]");
     mu_assert(test_update_backward(test_file_flipper), "Cannot update data #2 [Flipper]");
+    mu_assert(test_update_backward(test_file_binary), "Cannot update data #2 [Binary]");
 }
 
 MU_TEST(flipper_format_update_2_result_test) {
     mu_assert(test_read(test_file_linux), "Data #2 updated incorrectly [Linux]");
     mu_assert(test_read(test_file_windows), "Data #2 updated incorrectly [Windows]");
     mu_assert(test_read(test_file_flipper), "Data #2 updated incorrectly [Flipper]");
+    mu_assert(test_read(test_file_binary), "Data #2 updated incorrectly [Binary]");
+}
+
+MU_TEST(flipper_format_converted_read_test) {
+    mu_assert(test_read_converted(test_file_flipper), "Converted read error [Flipper]");
+    mu_assert(test_read_converted(test_file_binary), "Converted read error [Binary]");
+}
+
+MU_TEST(flipper_format_binary_benchmark_test) {
+    uint32_t text_checksum, text_time;
+    uint32_t binary_checksum, binary_time;
+
+    mu_assert(test_benchmark_write(TEST_DIR "ff_bench.test", false), "Benchmark write error");
+    mu_assert(
+        test_benchmark_write(TEST_DIR "ff_bench_bin.test", true),
+        "Benchmark write error [Binary]");
+    mu_assert(
+        test_benchmark_read(TEST_DIR "ff_bench.test", &text_checksum, &text_time),
+        "Benchmark read error");
+    mu_assert(
+        test_benchmark_read(TEST_DIR "ff_bench_bin.test", &binary_checksum, &binary_time),
+        "Benchmark read error [Binary]");
+    mu_assert_int_eq(text_checksum, binary_checksum);
+
+    FURI_LOG_I(TAG, "Load time: text %lu ms, binary %lu ms", text_time, binary_time);
 }
 
 MU_TEST(flipper_format_multikey_test) {
@@ -507,6 +706,7 @@ MU_TEST_SUITE(flipper_format) {
     tests_setup();
     MU_RUN_TEST(flipper_format_write_test);
     MU_RUN_TEST(flipper_format_read_test);
+    MU_RUN_TEST(flipper_format_converted_read_test);
     MU_RUN_TEST(flipper_format_delete_test);
     MU_RUN_TEST(flipper_format_delete_result_test);
     MU_RUN_TEST(flipper_format_append_test);
@@ -516,6 +716,7 @@ MU_TEST_SUITE(flipper_format) {
     MU_RUN_TEST(flipper_format_update_2_test);
     MU_RUN_TEST(flipper_format_update_2_result_test);
     MU_RUN_TEST(flipper_format_multikey_test);
+    MU_RUN_TEST(flipper_format_binary_benchmark_test);
     tests_teardown();
 }
 
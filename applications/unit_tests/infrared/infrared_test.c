@@ -1,12 +1,18 @@
 #include <furi.h>
 #include <flipper_format.h>
 #include <infrared.h>
+#include <infrared_analyzer.h>
 #include <common/infrared_common_i.h>
+#include <applications/infrared/infrared_brute_force.h>
 #include "../minunit.h"
 
 #define IR_TEST_FILES_DIR EXT_PATH("unit_tests/infrared/")
 #define IR_TEST_FILE_PREFIX "test_"
 #define IR_TEST_FILE_SUFFIX ".irtest"
+#define IR_TEST_BRUTE_FORCE_DB IR_TEST_FILES_DIR "test_brute_force.ir"
+#define IR_TEST_BRUTE_FORCE_INDEX IR_TEST_BRUTE_FORCE_DB ".idx"
+// Index header: magic, database size and modification time
+#define IR_TEST_BRUTE_FORCE_INDEX_HEADER_SIZE 16
 
 typedef struct {
     InfraredDecoderHandler* decoder_handler;
@@ -396,6 +402,190 @@ static void infrared_test_run_decoder(InfraredProtocol protocol, uint32_t test_i
     mu_assert(message_counter == messages_count, "decoded less than expected");
 }
 
+static void infrared_test_check_pattern(
+    const InfraredAnalyzerPattern* pattern,
+    const uint32_t* timings,
+    uint32_t timings_count,
+    uint32_t tolerance_percent) {
+    uint32_t* encoded = malloc(sizeof(uint32_t) * timings_count);
+    InfraredAnalyzerPattern* analyzed = malloc(sizeof(InfraredAnalyzerPattern));
+
+    mu_check(infrared_analyzer_encode(pattern, encoded, timings_count) == timings_count);
+    for(size_t i = 0; i < timings_count; ++i) {
+        uint32_t delta = timings[i] * tolerance_percent / 100;
+        mu_check((encoded[i] >= timings[i] - delta) && (encoded[i] <= timings[i] + delta));
+    }
+
+    /* Pattern timings are described with the same pattern */
+    mu_check(infrared_analyzer_analyze(analyzed, encoded, timings_count));
+    mu_check(!memcmp(analyzed, pattern, sizeof(InfraredAnalyzerPattern)));
+
+    free(analyzed);
+    free(encoded);
+}
+
+static void infrared_test_run_analyzer(InfraredProtocol protocol, uint32_t test_index) {
+    uint32_t* timings;
+    uint32_t timings_count = 200;
+    InfraredMessage* input_messages;
+    uint32_t input_messages_count;
+    bool level = false;
+
+    string_t buf;
+    string_init(buf);
+
+    const char* protocol_name = infrared_get_protocol_name(protocol);
+    mu_assert(infrared_test_prepare_file(protocol_name), "Failed to prepare test file");
+
+    string_printf(buf, "encoder_decoder_input%d", test_index);
+    mu_assert(
+        infrared_test_load_messages(
+            test->ff, string_get_cstr(buf), &input_messages, &input_messages_count),
+        "Failed to load messages from file");
+
+    flipper_format_buffered_file_close(test->ff);
+    string_clear(buf);
+
+    timings = malloc(sizeof(uint32_t) * timings_count);
+    InfraredAnalyzerPattern* pattern = malloc(sizeof(InfraredAnalyzerPattern));
+
+    for(uint32_t message_counter = 0; message_counter < input_messages_count; ++message_counter) {
+        const InfraredMessage* message = &input_messages[message_counter];
+        infrared_reset_encoder(test->encoder_handler, message);
+
+        timings_count = 200;
+        infrared_test_run_encoder_fill_array(
+            test->encoder_handler, timings, &timings_count, &level);
+        furi_check(timings_count <= 200);
+
+        /* Raw signal starts with a mark. Short messages can fit several encodings,
+         * so only the exact round-trip is checked */
+        uint32_t start = level ? 0 : 1;
+        mu_assert(
+            infrared_analyzer_analyze(pattern, &timings[start], timings_count - start),
+            "Encoded signal is not analyzed");
+        infrared_test_check_pattern(pattern, &timings[start], timings_count - start, 0);
+    }
+
+    free(pattern);
+    free(input_messages);
+    free(timings);
+}
+
+static void infrared_test_run_analyzer_capture(
+    InfraredProtocol protocol,
+    uint32_t test_index,
+    InfraredAnalyzerEncoding encoding) {
+    uint32_t* timings;
+    uint32_t timings_count;
+
+    string_t buf;
+    string_init(buf);
+
+    mu_assert(
+        infrared_test_prepare_file(infrared_get_protocol_name(protocol)),
+        "Failed to prepare test file");
+
+    string_printf(buf, "decoder_input%d", test_index);
+    mu_assert(
+        infrared_test_load_raw_signal(test->ff, string_get_cstr(buf), &timings, &timings_count),
+        "Failed to load raw signal from file");
+
+    flipper_format_buffered_file_close(test->ff);
+    string_clear(buf);
+
+    /* Silence before the first mark is skipped, noisy durations are replaced with symbol ones */
+    InfraredAnalyzerPattern* pattern = malloc(sizeof(InfraredAnalyzerPattern));
+    mu_assert(
+        infrared_analyzer_analyze(pattern, &timings[1], timings_count - 1),
+        "Captured signal is not analyzed");
+    mu_check(pattern->encoding == encoding);
+    infrared_test_check_pattern(pattern, &timings[1], timings_count - 1, 25);
+
+    free(pattern);
+    free(timings);
+}
+
+static const char* infrared_test_brute_force_signal =
+    "#\nname: %s\ntype: parsed\nprotocol: NEC\naddress: 04 00 00 00\ncommand: %02X 00 00 00\n";
+
+static bool infrared_test_brute_force_write(FS_OpenMode open_mode, string_t text) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool success =
+        storage_file_open(file, IR_TEST_BRUTE_FORCE_DB, FSAM_WRITE, open_mode) &&
+        storage_file_write(file, string_get_cstr(text), string_size(text)) == string_size(text);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+// Overwrites count or the first offset of the first group in the index
+// Reads or writes count or first offset of the first group in the index
+static bool infrared_test_brute_force_index_value(bool is_offset, uint32_t* value, bool is_write) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t name_size = 0;
+    bool success = false;
+
+    do {
+        if(!storage_file_open(
+               file, IR_TEST_BRUTE_FORCE_INDEX, FSAM_READ_WRITE, FSOM_OPEN_EXISTING))
+            break;
+        if(!storage_file_seek(file, IR_TEST_BRUTE_FORCE_INDEX_HEADER_SIZE, true)) break;
+        if(storage_file_read(file, &name_size, sizeof(name_size)) != sizeof(name_size)) break;
+        uint32_t position = IR_TEST_BRUTE_FORCE_INDEX_HEADER_SIZE + sizeof(name_size) + name_size;
+        if(is_offset) position += sizeof(uint32_t);
+        if(!storage_file_seek(file, position, true)) break;
+        if(is_write) {
+            if(storage_file_write(file, value, sizeof(*value)) != sizeof(*value)) break;
+        } else {
+            if(storage_file_read(file, value, sizeof(*value)) != sizeof(*value)) break;
+        }
+        success = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+static uint32_t infrared_test_brute_force_count(InfraredBruteForce* brute_force, uint32_t index) {
+    uint32_t record_count = 0;
+    if(infrared_brute_force_start(brute_force, index, &record_count)) {
+        infrared_brute_force_stop(brute_force);
+    }
+    return record_count;
+}
+
+static void infrared_test_brute_force_check(
+    InfraredBruteForce* brute_force,
+    uint32_t power_count,
+    uint32_t mute_count) {
+    mu_assert(
+        infrared_brute_force_calculate_messages(brute_force),
+        "infrared_brute_force_calculate_messages() failed");
+    mu_assert_int_eq(power_count, infrared_test_brute_force_count(brute_force, 0));
+    mu_assert_int_eq(mute_count, infrared_test_brute_force_count(brute_force, 1));
+}
+
+MU_TEST(infrared_test_analyzer_all) {
+    infrared_test_run_analyzer(InfraredProtocolNEC, 1);
+    infrared_test_run_analyzer(InfraredProtocolSamsung32, 1);
+    infrared_test_run_analyzer(InfraredProtocolSIRC, 1);
+    infrared_test_run_analyzer(InfraredProtocolRC5, 1);
+}
+
+MU_TEST(infrared_test_analyzer_capture) {
+    infrared_test_run_analyzer_capture(
+        InfraredProtocolNEC, 1, InfraredAnalyzerEncodingPulseDistance);
+    infrared_test_run_analyzer_capture(
+        InfraredProtocolSIRC, 3, InfraredAnalyzerEncodingPulseWidth);
+    infrared_test_run_analyzer_capture(InfraredProtocolRC5, 7, InfraredAnalyzerEncodingManchester);
+}
+
 MU_TEST(infrared_test_decoder_samsung32) {
     infrared_test_run_decoder(InfraredProtocolSamsung32, 1);
 }
@@ -496,6 +686,53 @@ MU_TEST(infrared_test_encoder_decoder_all) {
     infrared_test_run_encoder_decoder(InfraredProtocolSIRC, 1);
 }
 
+MU_TEST(infrared_test_brute_force_index) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    string_t text;
+    string_init_set_str(text, "Filetype: IR signals file\nVersion: 1\n");
+    string_cat_printf(text, infrared_test_brute_force_signal, "Power", 0x08);
+    string_cat_printf(text, infrared_test_brute_force_signal, "Mute", 0x0D);
+    string_cat_printf(text, infrared_test_brute_force_signal, "Power", 0x09);
+    mu_assert(
+        infrared_test_brute_force_write(FSOM_CREATE_ALWAYS, text), "Failed to write database");
+    storage_simply_remove(storage, IR_TEST_BRUTE_FORCE_INDEX);
+
+    InfraredBruteForce* brute_force = infrared_brute_force_alloc();
+    infrared_brute_force_set_db_filename(brute_force, IR_TEST_BRUTE_FORCE_DB);
+    infrared_brute_force_add_record(brute_force, 0, "Power");
+    infrared_brute_force_add_record(brute_force, 1, "Mute");
+
+    // Index is built and saved on the first scan, then loaded
+    infrared_test_brute_force_check(brute_force, 2, 1);
+    mu_assert(
+        storage_common_stat(storage, IR_TEST_BRUTE_FORCE_INDEX, NULL) == FSE_OK,
+        "Index is not saved");
+    infrared_test_brute_force_check(brute_force, 2, 1);
+
+    // Damaged index is rebuilt
+    for(size_t i = 0; i < 2; ++i) {
+        const bool is_offset = (i == 1);
+        uint32_t saved = 0;
+        uint32_t value = UINT32_MAX;
+        mu_assert(infrared_test_brute_force_index_value(is_offset, &saved, false), "Bad index");
+        mu_assert(infrared_test_brute_force_index_value(is_offset, &value, true), "Bad index");
+        infrared_test_brute_force_check(brute_force, 2, 1);
+        mu_assert(infrared_test_brute_force_index_value(is_offset, &value, false), "Bad index");
+        mu_assert_int_eq(saved, value);
+    }
+
+    // Changed database makes the index outdated
+    string_printf(text, infrared_test_brute_force_signal, "Mute", 0x0E);
+    mu_assert(infrared_test_brute_force_write(FSOM_OPEN_APPEND, text), "Failed to append signal");
+    infrared_test_brute_force_check(brute_force, 2, 2);
+
+    infrared_brute_force_free(brute_force);
+    storage_simply_remove(storage, IR_TEST_BRUTE_FORCE_DB);
+    storage_simply_remove(storage, IR_TEST_BRUTE_FORCE_INDEX);
+    string_clear(text);
+    furi_record_close(RECORD_STORAGE);
+}
+
 MU_TEST_SUITE(infrared_test) {
     MU_SUITE_CONFIGURE(&infrared_test_alloc, &infrared_test_free);
 
@@ -513,6 +750,9 @@ MU_TEST_SUITE(infrared_test) {
     MU_RUN_TEST(infrared_test_decoder_necext1);
     MU_RUN_TEST(infrared_test_decoder_mixed);
     MU_RUN_TEST(infrared_test_encoder_decoder_all);
+    MU_RUN_TEST(infrared_test_analyzer_all);
+    MU_RUN_TEST(infrared_test_analyzer_capture);
+    MU_RUN_TEST(infrared_test_brute_force_index);
 }
 
 int run_minunit_test_infrared() {
@@ -3,6 +3,9 @@
 #include <applications/storage/storage.h>
 #include <lib/flipper_format/flipper_format.h>
 #include <lib/nfc/protocols/nfca.h>
+#include <lib/nfc/helpers/mf_classic_dict.h>
+#include <lib/nfc/protocols/crypto1.h>
+#include <lib/nfc/helpers/mfkey32_log.h>
 #include <lib/digital_signal/digital_signal.h>
 
 #include <lib/flipper_format/flipper_format_i.h>
@@ -170,10 +173,293 @@ MU_TEST(nfc_digital_signal_test) {
         "NFC long digital signal test failed\r\n");
 }
 
+MU_TEST(mf_classic_dict_test) {
+    MfClassicDict* dict = mf_classic_dict_alloc(MfClassicDictTypeFlipper);
+    mu_assert(dict != NULL, "mf_classic_dict_alloc() failed\r\n");
+    uint32_t total_keys = mf_classic_dict_get_total_keys(dict);
+    mu_assert(total_keys > 0, "Empty dictionary\r\n");
+
+    uint64_t* keys = malloc(total_keys * sizeof(uint64_t));
+    uint32_t key_count = 0;
+    while(key_count < total_keys && mf_classic_dict_get_next_key(dict, &keys[key_count])) {
+        key_count++;
+    }
+    mf_classic_dict_free(dict);
+    mu_assert_int_eq(total_keys, key_count);
+
+    bool is_unique = true;
+    for(uint32_t i = 0; i < key_count && is_unique; i++) {
+        for(uint32_t j = i + 1; j < key_count; j++) {
+            if(keys[i] == keys[j]) {
+                is_unique = false;
+                break;
+            }
+        }
+    }
+    mu_assert(is_unique, "Dictionary has duplicate keys\r\n");
+
+    // Second load goes through binary cache and must give the same keys in the same order
+    dict = mf_classic_dict_alloc(MfClassicDictTypeFlipper);
+    mu_assert(dict != NULL, "mf_classic_dict_alloc() failed\r\n");
+    mu_assert_int_eq(total_keys, mf_classic_dict_get_total_keys(dict));
+    uint64_t key = 0;
+    bool is_equal = true;
+    for(uint32_t i = 0; i < key_count; i++) {
+        if(!mf_classic_dict_get_next_key(dict, &key) || key != keys[i]) {
+            is_equal = false;
+            break;
+        }
+    }
+    mu_assert(!mf_classic_dict_get_next_key(dict, &key), "Extra keys after cache load\r\n");
+    mu_assert(mf_classic_dict_rewind(dict), "mf_classic_dict_rewind() failed\r\n");
+    mu_assert(mf_classic_dict_get_next_key(dict, &key), "No keys after rewind\r\n");
+    mu_assert(key == keys[0], "Wrong key after rewind\r\n");
+    mf_classic_dict_free(dict);
+    free(keys);
+
+    mu_assert(is_equal, "Cached keys mismatch\r\n");
+}
+
+typedef struct {
+    uint64_t key;
+    uint32_t odd;
+    uint32_t even;
+    uint32_t word;
+    uint32_t nr_enc;
+    uint32_t ks;
+    uint8_t byte_enc;
+    uint8_t byte;
+    uint8_t bit;
+    uint32_t final_odd;
+    uint32_t final_even;
+} NfcTestCrypto1Vector;
+
+static const NfcTestCrypto1Vector nfc_test_crypto1_vectors[] = {
+    {0xFFFFFFFFFFFF,
+     0xffffff,
+     0xffffff,
+     0xffc7bc4d,
+     0x57a85612,
+     0x2ef7c7f8,
+     0x46,
+     0x5b,
+     0,
+     0x96eda314,
+     0x1012be3d},
+    {0xA0A1A2A3A4A5,
+     0x33bb33,
+     0x08084c,
+     0x5079d654,
+     0x4a502cd3,
+     0xf80eb206,
+     0xe7,
+     0x56,
+     0,
+     0xf633ac4d,
+     0x3490e148},
+    {0x000000000000,
+     0x000000,
+     0x000000,
+     0xe03440e1,
+     0xc3268d4e,
+     0x3957aa34,
+     0x59,
+     0xd2,
+     0,
+     0x942e7032,
+     0x694a0c48},
+    {0x4D3A99C351DD,
+     0x4e5905,
+     0xd2a9bf,
+     0x30635bb8,
+     0x70ec5e0b,
+     0xa131d515,
+     0xd2,
+     0x6e,
+     1,
+     0x8d022375,
+     0x24165469},
+};
+
+#define NFC_TEST_CRYPTO1_NT (0x01200145)
+#define NFC_TEST_CRYPTO1_CUID (0xCDEF1234)
+#define NFC_TEST_CRYPTO1_NR (0x12345678)
+
+MU_TEST(crypto1_known_answer_test) {
+    Crypto1 crypto1;
+    for(size_t i = 0; i < COUNT_OF(nfc_test_crypto1_vectors); i++) {
+        const NfcTestCrypto1Vector* vector = &nfc_test_crypto1_vectors[i];
+        crypto1_init(&crypto1, vector->key);
+        mu_assert_int_eq(vector->odd, crypto1.odd);
+        mu_assert_int_eq(vector->even, crypto1.even);
+        mu_assert_int_eq(
+            vector->word, crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NT ^ NFC_TEST_CRYPTO1_CUID, 0));
+        mu_assert_int_eq(
+            vector->nr_enc, crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NR, 0) ^ NFC_TEST_CRYPTO1_NR);
+        mu_assert_int_eq(vector->ks, crypto1_word(&crypto1, 0, 0));
+        mu_assert_int_eq(vector->byte_enc, crypto1_byte(&crypto1, 0xA5, 1));
+        mu_assert_int_eq(vector->byte, crypto1_byte(&crypto1, 0, 0));
+        mu_assert_int_eq(vector->bit, crypto1_bit(&crypto1, 1, 0));
+        mu_assert_int_eq(vector->final_odd, crypto1.odd);
+        mu_assert_int_eq(vector->final_even, crypto1.even);
+    }
+    mu_assert_int_eq(0x63e5bca7, prng_successor(NFC_TEST_CRYPTO1_NT, 64));
+}
+
+MU_TEST(crypto1_bitsliced_test) {
+    uint64_t keys[CRYPTO1_BITSLICED_KEYS];
+    for(uint8_t i = 0; i < CRYPTO1_BITSLICED_KEYS; i++) {
+        keys[i] = (0x123456789ABC * (i + 3)) & 0xFFFFFFFFFFFF;
+    }
+
+    // Sniffed authentication with keys[5]
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, keys[5]);
+    crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NT ^ NFC_TEST_CRYPTO1_CUID, 0);
+    uint32_t nr_enc = crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NR, 0) ^ NFC_TEST_CRYPTO1_NR;
+    uint32_t ar_enc = crypto1_word(&crypto1, 0, 0) ^ prng_successor(NFC_TEST_CRYPTO1_NT, 64);
+
+    uint32_t cycles = furi_hal_cortex_get_cycle_count();
+    uint32_t found = crypto1_bitsliced_check_keys(
+        keys,
+        CRYPTO1_BITSLICED_KEYS,
+        NFC_TEST_CRYPTO1_CUID,
+        NFC_TEST_CRYPTO1_NT,
+        nr_enc,
+        ar_enc);
+    cycles = furi_hal_cortex_get_cycle_count() - cycles;
+    mu_assert_int_eq(1 << 5, found);
+    FURI_LOG_I(TAG, "Bitsliced check of %d keys: %lu cycles", CRYPTO1_BITSLICED_KEYS, cycles);
+
+    cycles = furi_hal_cortex_get_cycle_count();
+    uint32_t found_scalar = 0;
+    for(uint8_t i = 0; i < CRYPTO1_BITSLICED_KEYS; i++) {
+        crypto1_init(&crypto1, keys[i]);
+        crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NT ^ NFC_TEST_CRYPTO1_CUID, 0);
+        crypto1_word(&crypto1, nr_enc, 1);
+        uint32_t ar = crypto1_word(&crypto1, 0, 0) ^ ar_enc;
+        if(ar == prng_successor(NFC_TEST_CRYPTO1_NT, 64)) found_scalar |= 1UL << i;
+    }
+    cycles = furi_hal_cortex_get_cycle_count() - cycles;
+    mu_assert_int_eq(found, found_scalar);
+    FURI_LOG_I(TAG, "Scalar check of %d keys: %lu cycles", CRYPTO1_BITSLICED_KEYS, cycles);
+
+    // Keys out of count are never reported
+    mu_assert_int_eq(
+        0,
+        crypto1_bitsliced_check_keys(
+            keys, 5, NFC_TEST_CRYPTO1_CUID, NFC_TEST_CRYPTO1_NT, nr_enc, ar_enc));
+}
+
+static void nfc_test_mfkey32_auth(
+    uint64_t key,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr,
+    uint32_t* nr_enc,
+    uint32_t* ar_enc) {
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, key);
+    crypto1_word(&crypto1, nt ^ cuid, 0);
+    *nr_enc = crypto1_word(&crypto1, nr, 0) ^ nr;
+    *ar_enc = crypto1_word(&crypto1, 0, 0) ^ prng_successor(nt, 64);
+}
+
+MU_TEST(mfkey32_test) {
+    const uint64_t key = 0x4D3A99C351DD;
+    uint32_t nr_enc = 0;
+    uint32_t ar_enc = 0;
+
+    // Rollback restores initial state
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, key);
+    mu_assert(crypto1_get_key(&crypto1) == key, "crypto1_get_key() failed\r\n");
+    crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NT ^ NFC_TEST_CRYPTO1_CUID, 0);
+    crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NR, 0);
+    uint32_t ks = crypto1_word(&crypto1, 0, 0);
+    mu_assert_int_eq(ks, crypto1_rollback_word(&crypto1, 0, 0));
+    crypto1_rollback_word(&crypto1, NFC_TEST_CRYPTO1_NR, 0);
+    crypto1_rollback_word(&crypto1, NFC_TEST_CRYPTO1_NT ^ NFC_TEST_CRYPTO1_CUID, 0);
+    mu_assert(crypto1_get_key(&crypto1) == key, "crypto1_rollback_word() failed\r\n");
+
+    // Two authentications with different nonces make a pair
+    Mfkey32Log* log = mfkey32_log_alloc(NFC_TEST_CRYPTO1_CUID);
+    nfc_test_mfkey32_auth(
+        key, NFC_TEST_CRYPTO1_CUID, NFC_TEST_CRYPTO1_NT, NFC_TEST_CRYPTO1_NR, &nr_enc, &ar_enc);
+    mfkey32_log_add_auth(2, MfClassicKeyB, NFC_TEST_CRYPTO1_NT, nr_enc, ar_enc, log);
+    mfkey32_log_add_auth(2, MfClassicKeyB, NFC_TEST_CRYPTO1_NT, nr_enc, ar_enc, log);
+    mu_assert_int_eq(0, mfkey32_log_get_pairs_count(log));
+    uint32_t nt1 = prng_successor(NFC_TEST_CRYPTO1_NT, 160);
+    nfc_test_mfkey32_auth(key, NFC_TEST_CRYPTO1_CUID, nt1, ~NFC_TEST_CRYPTO1_NR, &nr_enc, &ar_enc);
+    mfkey32_log_add_auth(2, MfClassicKeyB, nt1, nr_enc, ar_enc, log);
+    mu_assert_int_eq(1, mfkey32_log_get_pairs_count(log));
+    mfkey32_log_free(log);
+
+    // Key is recovered from the pair
+    Mfkey32Params params = {
+        .cuid = NFC_TEST_CRYPTO1_CUID,
+        .sector = 2,
+        .key_type = MfClassicKeyB,
+        .nt0 = NFC_TEST_CRYPTO1_NT,
+        .nt1 = nt1,
+    };
+    nfc_test_mfkey32_auth(
+        key, params.cuid, params.nt0, NFC_TEST_CRYPTO1_NR, &params.nr0, &params.ar0);
+    nfc_test_mfkey32_auth(
+        key, params.cuid, params.nt1, ~NFC_TEST_CRYPTO1_NR, &params.nr1, &params.ar1);
+
+    // Full search takes minutes, so only 1/1024 of the initial states around the real ones
+    // is searched. They are the LFSR halves right after the first bit of ar0 keystream.
+    crypto1_init(&crypto1, key);
+    crypto1_word(&crypto1, params.nt0 ^ params.cuid, 0);
+    crypto1_word(&crypto1, NFC_TEST_CRYPTO1_NR, 0);
+    crypto1_bit(&crypto1, 0, 0);
+    Mfkey32SearchSpace space = {
+        .odd_start = crypto1.odd & 0xFFC00,
+        .odd_end = (crypto1.odd & 0xFFC00) + 0x400,
+        .even_start = crypto1.even & 0xFFC00,
+        .even_end = (crypto1.even & 0xFFC00) + 0x400,
+        .window_start = 0,
+        .window_end = MFKEY32_WINDOW_VALUES,
+        .window_size = MFKEY32_WINDOW_VALUES,
+    };
+    uint64_t key_found = 0;
+    mu_assert_int_eq(
+        Mfkey32ResultFound, mfkey32_recover_ex(&params, MFKEY32_MEMORY_MIN, &space, &key_found));
+    mu_assert(key_found == key, "mfkey32_recover_ex() returned wrong key\r\n");
+
+    // Windows too big for the budget are split until candidates fit
+    key_found = 0;
+    mu_assert_int_eq(Mfkey32ResultFound, mfkey32_recover_ex(&params, 1024, &space, &key_found));
+    mu_assert(key_found == key, "mfkey32_recover_ex() returned wrong key after split\r\n");
+
+    // Log line round trip
+    Mfkey32Params params_parsed = {};
+    string_t line;
+    string_init(line);
+    mfkey32_format_line(&params, line);
+    mu_assert(
+        mfkey32_parse_line(string_get_cstr(line), &params_parsed), "Failed to parse log line\r\n");
+    string_clear(line);
+    mu_assert_int_eq(params.cuid, params_parsed.cuid);
+    mu_assert_int_eq(params.sector, params_parsed.sector);
+    mu_assert_int_eq(params.key_type, params_parsed.key_type);
+    mu_assert_int_eq(params.nt0, params_parsed.nt0);
+    mu_assert_int_eq(params.nr0, params_parsed.nr0);
+    mu_assert_int_eq(params.ar0, params_parsed.ar0);
+    mu_assert_int_eq(params.nt1, params_parsed.nt1);
+    mu_assert_int_eq(params.nr1, params_parsed.nr1);
+    mu_assert_int_eq(params.ar1, params_parsed.ar1);
+}
+
 MU_TEST_SUITE(nfc) {
     nfc_test_alloc();
 
     MU_RUN_TEST(nfc_digital_signal_test);
+    MU_RUN_TEST(mf_classic_dict_test);
+    MU_RUN_TEST(crypto1_known_answer_test);
+    MU_RUN_TEST(crypto1_bitsliced_test);
+    MU_RUN_TEST(mfkey32_test);
 
     nfc_test_free();
 }
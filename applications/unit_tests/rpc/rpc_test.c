@@ -45,7 +45,8 @@ static RpcSessionContext rpc_session[TEST_RPC_SESSIONS];
 #define TAG "UnitTestsRpc"
 #define MAX_RECEIVE_OUTPUT_TIMEOUT 3000
 #define MAX_NAME_LENGTH 255
-#define MAX_DATA_SIZE 512u // have to be exact as in rpc_storage.c
+#define MAX_DATA_SIZE 512u // have to be exact as RPC_DEFAULT_CHUNK_SIZE
+#define BENCHMARK_FILE_SIZE (64 * 1024)
 #define TEST_DIR TEST_DIR_NAME "/"
 #define TEST_DIR_NAME EXT_PATH("unit_tests_tmp")
 #define MD5SUM_SIZE 16
@@ -274,6 +275,18 @@ static void output_bytes_callback(void* ctx, uint8_t* got_bytes, size_t got_size
     furi_check(bytes_sent == got_size);
 }
 
+/* Doesn't require output stream to fit whole frame */
+static void output_bytes_stream_callback(void* ctx, uint8_t* got_bytes, size_t got_size) {
+    RpcSessionContext* callbacks_context = ctx;
+
+    while(got_size) {
+        size_t bytes_sent = xStreamBufferSend(
+            callbacks_context->output_stream, got_bytes, got_size, FuriWaitForever);
+        got_bytes += bytes_sent;
+        got_size -= bytes_sent;
+    }
+}
+
 static void test_rpc_add_ping_to_list(MsgList_t msg_list, bool request, uint32_t command_id) {
     PB_Main* response = MsgList_push_new(msg_list);
     response->command_id = command_id;
@@ -538,6 +551,25 @@ static bool test_rpc_pb_stream_read(pb_istream_t* istream, pb_byte_t* buf, size_
     return (count == bytes_received);
 }
 
+static bool test_rpc_pb_stream_read_all(pb_istream_t* istream, pb_byte_t* buf, size_t count) {
+    RpcSessionContext* session_context = istream->state;
+    size_t bytes_received = 0;
+
+    while(bytes_received < count) {
+        TickType_t now = xTaskGetTickCount();
+        int32_t time_left = session_context->timeout - now;
+        time_left = MAX(time_left, 0);
+        size_t received = xStreamBufferReceive(
+            session_context->output_stream,
+            buf + bytes_received,
+            count - bytes_received,
+            time_left);
+        if(!received) break;
+        bytes_received += received;
+    }
+    return (count == bytes_received);
+}
+
 static void
     test_rpc_storage_list_create_expected_list_root(MsgList_t msg_list, uint32_t command_id) {
     PB_Main* message = MsgList_push_new(msg_list);
@@ -925,6 +957,61 @@ MU_TEST(test_storage_read) {
     test_storage_read_run(TEST_DIR "file4.txt", ++command_id);
 }
 
+static void test_storage_read_benchmark_run(const char* path, size_t chunk_size) {
+    PB_Main request;
+    test_rpc_create_simple_message(&request, PB_Main_storage_read_request_tag, path, ++command_id);
+    rpc_session_set_max_chunk_size(rpc_session[0].session, chunk_size);
+
+    uint32_t start = furi_get_tick();
+    test_rpc_encode_and_feed_one(&request, 0);
+
+    pb_istream_t istream = {
+        .callback = test_rpc_pb_stream_read_all,
+        .state = &rpc_session[0],
+        .errmsg = NULL,
+        .bytes_left = 0x7FFFFFFF,
+    };
+    PB_Main result = {.cb_content.funcs.decode = NULL};
+    size_t bytes_received = 0;
+    size_t frames = 0;
+    bool has_next = true;
+    while(has_next) {
+        rpc_session[0].timeout = xTaskGetTickCount() + MAX_RECEIVE_OUTPUT_TIMEOUT;
+        mu_check(pb_decode_ex(&istream, &PB_Main_msg, &result, PB_DECODE_DELIMITED));
+
+        has_next = result.has_next;
+        bool is_data = (result.command_id == command_id) &&
+                       (result.which_content == PB_Main_storage_read_response_tag) &&
+                       result.content.storage_read_response.file.data;
+        if(is_data) {
+            bytes_received += result.content.storage_read_response.file.data->size;
+            ++frames;
+        }
+        pb_release(&PB_Main_msg, &result);
+        mu_check(is_data);
+    }
+
+    uint32_t time = furi_get_tick() - start;
+    FURI_LOG_I(
+        TAG,
+        "Read %u bytes in %u frames of %u bytes: %lu ms",
+        bytes_received,
+        frames,
+        chunk_size,
+        time);
+
+    mu_assert_int_eq(BENCHMARK_FILE_SIZE, bytes_received);
+    mu_assert_int_eq((BENCHMARK_FILE_SIZE + chunk_size - 1) / chunk_size, frames);
+}
+
+MU_TEST(test_storage_read_benchmark) {
+    test_create_file(TEST_DIR "benchmark.bin", BENCHMARK_FILE_SIZE);
+
+    rpc_session_set_send_bytes_callback(rpc_session[0].session, output_bytes_stream_callback);
+    test_storage_read_benchmark_run(TEST_DIR "benchmark.bin", RPC_DEFAULT_CHUNK_SIZE);
+    test_storage_read_benchmark_run(TEST_DIR "benchmark.bin", RPC_MAX_CHUNK_SIZE);
+}
+
 static void test_storage_write_run(
     const char* path,
     size_t write_size,
@@ -1435,6 +1522,7 @@ MU_TEST_SUITE(test_rpc_storage) {
     MU_RUN_TEST(test_storage_stat);
     MU_RUN_TEST(test_storage_list);
     MU_RUN_TEST(test_storage_read);
+    MU_RUN_TEST(test_storage_read_benchmark);
     MU_RUN_TEST(test_storage_write_read);
     MU_RUN_TEST(test_storage_write);
     MU_RUN_TEST(test_storage_delete);
@@ -2,6 +2,8 @@
 #include <furi.h>
 #include <m-dict.h>
 #include <toolbox/dir_walk.h>
+#include <toolbox/dir_manifest.h>
+#include <toolbox/md5.h>
 
 static const char* const storage_test_dirwalk_paths[] = {
     "1",
@@ -254,6 +256,66 @@ MU_TEST_1(test_dirwalk_filter, Storage* storage) {
     storage_test_paths_free(paths);
 }
 
+static void test_dir_manifest_walk(Storage* storage, DirManifestStats* stats) {
+    string_t path;
+    string_init(path);
+    DirManifestEntry entry;
+    uint8_t md5_13DA[DIR_MANIFEST_HASH_SIZE];
+    md5((const unsigned char*)"13DA", 4, md5_13DA);
+    memset(stats, 0, sizeof(DirManifestStats));
+
+    StorageTestPathDict_t* paths =
+        storage_test_paths_alloc(storage_test_dirwalk_full, COUNT_OF(storage_test_dirwalk_full));
+
+    DirManifest* manifest = dir_manifest_alloc(storage);
+    mu_check(dir_manifest_open(manifest, EXT_PATH("dirwalk")));
+
+    while(dir_manifest_read(manifest, path, &entry) == DirWalkOK) {
+        string_right(path, strlen(EXT_PATH("dirwalk/")));
+        mu_check(storage_test_paths_mark(paths, path, (entry.fileinfo.flags & FSF_DIRECTORY)));
+        if(!(entry.fileinfo.flags & FSF_DIRECTORY) && entry.fileinfo.size == 4) {
+            mu_check(memcmp(entry.md5, md5_13DA, DIR_MANIFEST_HASH_SIZE) == 0);
+        }
+    }
+
+    mu_check(dir_manifest_get_error(manifest) == FSE_OK);
+    dir_manifest_get_stats(manifest, stats);
+    dir_manifest_close(manifest);
+    dir_manifest_free(manifest);
+    string_clear(path);
+
+    mu_check(storage_test_paths_check(paths) == false);
+
+    storage_test_paths_free(paths);
+}
+
+MU_TEST_1(test_dir_manifest, Storage* storage) {
+    DirManifestStats stats;
+    const size_t files_count = COUNT_OF(storage_test_dirwalk_files);
+
+    // First walk hashes everything
+    test_dir_manifest_walk(storage, &stats);
+    mu_assert_int_eq(files_count, stats.hashed);
+    mu_assert_int_eq(0, stats.cached);
+
+    // Unchanged files are taken from the index
+    test_dir_manifest_walk(storage, &stats);
+    mu_assert_int_eq(0, stats.hashed);
+    mu_assert_int_eq(files_count, stats.cached);
+
+    // Size change is detected regardless of the timestamp resolution
+    File* file = storage_file_alloc(storage);
+    mu_check(
+        storage_file_open(file, EXT_PATH("dirwalk/1/file1.test"), FSAM_WRITE, FSOM_OPEN_APPEND));
+    mu_check(storage_file_write(file, "13DA", 4) == 4);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    test_dir_manifest_walk(storage, &stats);
+    mu_assert_int_eq(1, stats.hashed);
+    mu_assert_int_eq(files_count - 1, stats.cached);
+}
+
 MU_TEST_SUITE(test_dirwalk_suite) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_dirs_create(storage, EXT_PATH("dirwalk"));
@@ -261,6 +323,7 @@ MU_TEST_SUITE(test_dirwalk_suite) {
     MU_RUN_TEST_1(test_dirwalk_full, storage);
     MU_RUN_TEST_1(test_dirwalk_no_recursive, storage);
     MU_RUN_TEST_1(test_dirwalk_filter, storage);
+    MU_RUN_TEST_1(test_dir_manifest, storage);
 
     storage_simply_remove_recursive(storage, EXT_PATH("dirwalk"));
     furi_record_close(RECORD_STORAGE);
@@ -0,0 +1,187 @@
+#include "../minunit.h"
+#include <furi.h>
+#include <sector_cache.h>
+
+#define TEST_SECTOR_SIZE 512
+#define TEST_SECTOR_COUNT 64
+#define TEST_SLOTS 8
+#define TEST_READ_AHEAD 4
+
+typedef struct {
+    uint8_t* data;
+    uint32_t reads;
+    uint32_t writes;
+} TestDisk;
+
+static bool test_disk_read(void* context, uint8_t* buff, uint32_t sector, size_t count) {
+    TestDisk* disk = context;
+    if(sector + count > TEST_SECTOR_COUNT) return false;
+    memcpy(buff, disk->data + sector * TEST_SECTOR_SIZE, count * TEST_SECTOR_SIZE);
+    disk->reads++;
+    return true;
+}
+
+static bool test_disk_write(void* context, const uint8_t* buff, uint32_t sector, size_t count) {
+    TestDisk* disk = context;
+    if(sector + count > TEST_SECTOR_COUNT) return false;
+    memcpy(disk->data + sector * TEST_SECTOR_SIZE, buff, count * TEST_SECTOR_SIZE);
+    disk->writes++;
+    return true;
+}
+
+static TestDisk* disk;
+static SectorCache* cache;
+static uint8_t* buffer;
+
+static void sector_cache_test_setup() {
+    disk = malloc(sizeof(TestDisk));
+    disk->data = malloc(TEST_SECTOR_SIZE * TEST_SECTOR_COUNT);
+    for(size_t i = 0; i < TEST_SECTOR_COUNT; i++) {
+        memset(disk->data + i * TEST_SECTOR_SIZE, i, TEST_SECTOR_SIZE);
+    }
+    buffer = malloc(TEST_SECTOR_SIZE * TEST_SECTOR_COUNT);
+    cache = sector_cache_alloc(
+        TEST_SECTOR_SIZE, TEST_SLOTS, TEST_READ_AHEAD, test_disk_read, test_disk_write, disk);
+}
+
+static void sector_cache_test_teardown() {
+    sector_cache_free(cache);
+    free(buffer);
+    free(disk->data);
+    free(disk);
+}
+
+static bool sector_cache_test_check(const uint8_t* buff, uint32_t sector, size_t count) {
+    for(size_t i = 0; i < count * TEST_SECTOR_SIZE; i++) {
+        if(buff[i] != (uint8_t)(sector + i / TEST_SECTOR_SIZE)) return false;
+    }
+    return true;
+}
+
+MU_TEST(sector_cache_test_hit) {
+    SectorCacheStats stats;
+
+    mu_check(sector_cache_read(cache, buffer, 10, 1, false));
+    mu_check(sector_cache_test_check(buffer, 10, 1));
+    mu_check(sector_cache_read(cache, buffer, 10, 1, false));
+    mu_check(sector_cache_test_check(buffer, 10, 1));
+
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(1, stats.hits);
+    mu_assert_int_eq(1, stats.misses);
+    mu_assert_int_eq(1, disk->reads);
+}
+
+MU_TEST(sector_cache_test_read_ahead) {
+    SectorCacheStats stats;
+
+    // First read starts the sequential run
+    mu_check(sector_cache_read(cache, buffer, 20, 1, false));
+    for(uint32_t sector = 21; sector < 21 + TEST_READ_AHEAD; sector++) {
+        mu_check(sector_cache_read(cache, buffer, sector, 1, false));
+        mu_check(sector_cache_test_check(buffer, sector, 1));
+    }
+
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(TEST_READ_AHEAD - 1, stats.read_ahead_hits);
+    mu_assert_int_eq(TEST_READ_AHEAD - 1, stats.read_ahead);
+    mu_assert_int_eq(2, disk->reads);
+
+    // Pinned metadata reads don't break the sequential run, the window is filled again
+    mu_check(sector_cache_read(cache, buffer, 1, 1, true));
+    for(uint32_t sector = 21 + TEST_READ_AHEAD; sector < 23 + TEST_READ_AHEAD; sector++) {
+        mu_check(sector_cache_read(cache, buffer, sector, 1, false));
+        mu_check(sector_cache_test_check(buffer, sector, 1));
+    }
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(TEST_READ_AHEAD, stats.read_ahead_hits);
+    mu_assert_int_eq((TEST_READ_AHEAD - 1) * 2, stats.read_ahead);
+    mu_assert_int_eq(4, disk->reads);
+}
+
+MU_TEST(sector_cache_test_write_back) {
+    memset(buffer, 0xAA, TEST_SECTOR_SIZE * 2);
+    mu_check(sector_cache_write(cache, buffer, 30, 2, false));
+    mu_assert_int_eq(2, sector_cache_get_dirty_count(cache));
+    mu_assert_int_eq(0, disk->writes);
+
+    // Dirty sectors are returned before they reach the device
+    memset(buffer, 0, TEST_SECTOR_SIZE * 2);
+    mu_check(sector_cache_read(cache, buffer, 30, 2, false));
+    mu_assert_int_eq(0xAA, buffer[0]);
+    mu_assert_int_eq(0xAA, buffer[TEST_SECTOR_SIZE * 2 - 1]);
+
+    // Consecutive dirty sectors are written with one request
+    mu_check(sector_cache_sync(cache));
+    mu_assert_int_eq(0, sector_cache_get_dirty_count(cache));
+    mu_assert_int_eq(1, disk->writes);
+    mu_assert_int_eq(0xAA, disk->data[30 * TEST_SECTOR_SIZE]);
+    mu_assert_int_eq(0xAA, disk->data[32 * TEST_SECTOR_SIZE - 1]);
+}
+
+MU_TEST(sector_cache_test_eviction) {
+    SectorCacheStats stats;
+
+    // Metadata sector survives a scan of data sectors
+    mu_check(sector_cache_read(cache, buffer, 0, 1, true));
+    for(uint32_t sector = 40; sector < 40 + TEST_SLOTS * 2; sector += 2) {
+        mu_check(sector_cache_read(cache, buffer, sector, 1, false));
+    }
+    sector_cache_reset_stats(cache);
+    mu_check(sector_cache_read(cache, buffer, 0, 1, true));
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(1, stats.hits);
+
+    // Evicted dirty sector is written back
+    memset(buffer, 0x55, TEST_SECTOR_SIZE);
+    mu_check(sector_cache_write(cache, buffer, 2, 1, false));
+    for(uint32_t sector = 3; sector < 3 + TEST_SLOTS * 2; sector += 2) {
+        mu_check(sector_cache_read(cache, buffer, sector, 1, false));
+    }
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(1, stats.write_backs);
+    mu_assert_int_eq(0x55, disk->data[2 * TEST_SECTOR_SIZE]);
+}
+
+MU_TEST(sector_cache_test_large_transfer) {
+    // Large reads see dirty sectors
+    memset(buffer, 0x77, TEST_SECTOR_SIZE);
+    mu_check(sector_cache_write(cache, buffer, 5, 1, false));
+    mu_check(sector_cache_read(cache, buffer, 0, 16, false));
+    mu_assert_int_eq(0x77, buffer[5 * TEST_SECTOR_SIZE]);
+    mu_check(sector_cache_test_check(buffer + 6 * TEST_SECTOR_SIZE, 6, 10));
+
+    // Large writes update cached copies
+    memset(buffer, 0x33, TEST_SECTOR_SIZE * 16);
+    mu_check(sector_cache_write(cache, buffer, 0, 16, false));
+    mu_assert_int_eq(0, sector_cache_get_dirty_count(cache));
+    memset(buffer, 0, TEST_SECTOR_SIZE);
+    mu_check(sector_cache_read(cache, buffer, 5, 1, false));
+    mu_assert_int_eq(0x33, buffer[0]);
+
+    mu_check(!sector_cache_read(cache, buffer, TEST_SECTOR_COUNT - 8, 16, false));
+}
+
+MU_TEST(sector_cache_test_invalidate) {
+    mu_check(sector_cache_read(cache, buffer, 10, 1, false));
+    memset(disk->data + 10 * TEST_SECTOR_SIZE, 0x11, TEST_SECTOR_SIZE);
+    sector_cache_invalidate(cache);
+    mu_check(sector_cache_read(cache, buffer, 10, 1, false));
+    mu_assert_int_eq(0x11, buffer[0]);
+}
+
+MU_TEST_SUITE(sector_cache_suite) {
+    MU_SUITE_CONFIGURE(&sector_cache_test_setup, &sector_cache_test_teardown);
+
+    MU_RUN_TEST(sector_cache_test_hit);
+    MU_RUN_TEST(sector_cache_test_read_ahead);
+    MU_RUN_TEST(sector_cache_test_write_back);
+    MU_RUN_TEST(sector_cache_test_eviction);
+    MU_RUN_TEST(sector_cache_test_large_transfer);
+    MU_RUN_TEST(sector_cache_test_invalidate);
+}
+
+int run_minunit_test_sector_cache() {
+    MU_RUN_SUITE(sector_cache_suite);
+    return MU_EXIT_CODE;
+}
@@ -2,6 +2,8 @@
 #include <furi.h>
 #include <storage/storage.h>
 
+#define TAG "StorageTest"
+
 #define STORAGE_LOCKED_FILE EXT_PATH("locked_file.test")
 #define STORAGE_LOCKED_DIR STORAGE_INT_PATH_PREFIX
 
@@ -309,9 +311,164 @@ MU_TEST_SUITE(storage_rename) {
     furi_record_close(RECORD_STORAGE);
 }
 
+#define STORAGE_BATCH_DIR EXT_PATH("batch.test")
+#define STORAGE_BATCH_FILE STORAGE_BATCH_DIR "/file.test"
+#define STORAGE_BATCH_MISSING_FILE STORAGE_BATCH_DIR "/missing.test"
+
+MU_TEST(storage_batch_open_read_close) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageBatch* batch = storage_batch_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    char data[10] = {0};
+    uint16_t bytes_read = 0;
+
+    mu_check(storage_simply_mkdir(storage, STORAGE_BATCH_DIR));
+    mu_check(write_file_13DA(storage, STORAGE_BATCH_FILE));
+
+    storage_batch_file_open(batch, file, STORAGE_BATCH_FILE, FSAM_READ, FSOM_OPEN_EXISTING);
+    storage_batch_file_seek(batch, file, 2, true);
+    storage_batch_file_read(batch, file, data, 4, &bytes_read);
+    storage_batch_file_close(batch, file);
+    mu_check(storage_batch_submit(batch));
+    mu_assert_int_eq(2, bytes_read);
+    mu_assert_string_eq("DA", data);
+    mu_check(!storage_file_is_open(file));
+
+    // Read is skipped after a failed open, the open error is kept
+    storage_batch_reset(batch);
+    bytes_read = 1;
+    storage_batch_file_open(
+        batch, file, STORAGE_BATCH_MISSING_FILE, FSAM_READ, FSOM_OPEN_EXISTING);
+    storage_batch_file_read(batch, file, data, 4, &bytes_read);
+    storage_batch_file_close(batch, file);
+    mu_check(!storage_batch_submit(batch));
+    mu_assert_int_eq(0, bytes_read);
+    mu_assert_int_eq(FSE_NOT_EXIST, storage_file_get_error(file));
+    mu_check(!storage_file_is_open(file));
+
+    storage_file_free(file);
+    storage_batch_free(batch);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_batch_stat_readdir) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageBatch* batch = storage_batch_alloc(storage);
+    File* dir = storage_file_alloc(storage);
+    FileInfo fileinfo[2];
+    FS_Error error[3];
+    char name[2][32];
+    bool result[2];
+
+    storage_batch_common_stat(batch, STORAGE_BATCH_DIR, &fileinfo[0], &error[0]);
+    storage_batch_common_stat(batch, STORAGE_BATCH_FILE, &fileinfo[1], &error[1]);
+    storage_batch_common_stat(batch, STORAGE_BATCH_MISSING_FILE, NULL, &error[2]);
+    mu_check(!storage_batch_submit(batch));
+    mu_assert_int_eq(FSE_OK, error[0]);
+    mu_check(fileinfo[0].flags & FSF_DIRECTORY);
+    mu_assert_int_eq(FSE_OK, error[1]);
+    mu_assert_int_eq(4, fileinfo[1].size);
+    mu_assert_int_eq(FSE_NOT_EXIST, error[2]);
+
+    storage_batch_reset(batch);
+    storage_batch_dir_open(batch, dir, STORAGE_BATCH_DIR);
+    for(size_t i = 0; i < COUNT_OF(result); i++) {
+        storage_batch_dir_read(batch, dir, &fileinfo[i], name[i], sizeof(name[i]), &result[i]);
+    }
+    storage_batch_dir_close(batch, dir);
+    // Only one entry, the second read fails
+    mu_check(!storage_batch_submit(batch));
+    mu_check(result[0]);
+    mu_assert_string_eq("file.test", name[0]);
+    mu_check(!result[1]);
+    mu_check(!storage_file_is_open(dir));
+
+    storage_file_free(dir);
+    storage_batch_free(batch);
+    furi_record_close(RECORD_STORAGE);
+}
+
+#define STORAGE_BENCHMARK_READ_SIZE 32
+#define STORAGE_BENCHMARK_BATCH_SIZE 16
+#define STORAGE_BENCHMARK_FILE_SIZE (STORAGE_BENCHMARK_READ_SIZE * STORAGE_BENCHMARK_BATCH_SIZE)
+#define STORAGE_BENCHMARK_TIME 1000
+
+MU_TEST(storage_small_read_benchmark) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageBatch* batch = storage_batch_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    uint8_t* data = malloc(STORAGE_BENCHMARK_FILE_SIZE);
+
+    mu_check(storage_file_open(file, STORAGE_BATCH_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(size_t i = 0; i < STORAGE_BENCHMARK_FILE_SIZE; i++) {
+        data[i] = i;
+    }
+    mu_assert_int_eq(
+        STORAGE_BENCHMARK_FILE_SIZE, storage_file_write(file, data, STORAGE_BENCHMARK_FILE_SIZE));
+    storage_file_close(file);
+    mu_check(storage_file_open(file, STORAGE_BATCH_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+
+    // One request per read
+    uint32_t single_reads = 0;
+    uint32_t start = furi_get_tick();
+    while(furi_get_tick() - start < STORAGE_BENCHMARK_TIME) {
+        for(size_t i = 0; i < STORAGE_BENCHMARK_BATCH_SIZE; i++) {
+            mu_assert_int_eq(
+                STORAGE_BENCHMARK_READ_SIZE,
+                storage_file_read(
+                    file, &data[STORAGE_BENCHMARK_READ_SIZE * i], STORAGE_BENCHMARK_READ_SIZE));
+        }
+        storage_file_seek(file, 0, true);
+        single_reads += STORAGE_BENCHMARK_BATCH_SIZE;
+    }
+    uint32_t single_time = furi_get_tick() - start;
+
+    // All reads of the file in one request
+    storage_batch_file_seek(batch, file, 0, true);
+    for(size_t i = 0; i < STORAGE_BENCHMARK_BATCH_SIZE; i++) {
+        uint8_t* buff = &data[STORAGE_BENCHMARK_READ_SIZE * i];
+        storage_batch_file_read(batch, file, buff, STORAGE_BENCHMARK_READ_SIZE, NULL);
+    }
+    memset(data, 0, STORAGE_BENCHMARK_FILE_SIZE);
+    uint32_t batch_reads = 0;
+    start = furi_get_tick();
+    while(furi_get_tick() - start < STORAGE_BENCHMARK_TIME) {
+        mu_check(storage_batch_submit(batch));
+        batch_reads += STORAGE_BENCHMARK_BATCH_SIZE;
+    }
+    uint32_t batch_time = furi_get_tick() - start;
+
+    for(size_t i = 0; i < STORAGE_BENCHMARK_FILE_SIZE; i++) {
+        mu_assert_int_eq((uint8_t)i, data[i]);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "%d byte reads: %lu ops/s, batched: %lu ops/s",
+        STORAGE_BENCHMARK_READ_SIZE,
+        single_reads * 1000 / single_time,
+        batch_reads * 1000 / batch_time);
+
+    free(data);
+    storage_file_free(file);
+    storage_batch_free(batch);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST_SUITE(storage_batch) {
+    MU_RUN_TEST(storage_batch_open_read_close);
+    MU_RUN_TEST(storage_batch_stat_readdir);
+    MU_RUN_TEST(storage_small_read_benchmark);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_dir_remove(storage, STORAGE_BATCH_DIR);
+    furi_record_close(RECORD_STORAGE);
+}
+
 int run_minunit_test_storage() {
     MU_RUN_SUITE(storage_file);
     MU_RUN_SUITE(storage_dir);
     MU_RUN_SUITE(storage_rename);
+    MU_RUN_SUITE(storage_batch);
     return MU_EXIT_CODE;
 }
@@ -4,8 +4,11 @@
 #include <toolbox/stream/file_stream.h>
 #include <toolbox/stream/buffered_file_stream.h>
 #include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
 #include "../minunit.h"
 
+#define TAG "StreamTest"
+
 static const char* stream_test_data = "I write differently from what I speak, "
                                       "I speak differently from what I think, "
                                       "I think differently from the way I ought to think, "
@@ -291,6 +294,20 @@ MU_TEST(stream_composite_test) {
         stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
     MU_RUN_TEST_1(stream_composite_subtest, stream);
     stream_free(stream);
+
+    // test buffered file stream with read ahead, small cache to force refills
+    stream = buffered_file_stream_alloc_ex(storage, 16, BufferedFileStreamAccessSequential);
+    mu_check(buffered_file_stream_open(
+        stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_composite_subtest, stream);
+    stream_free(stream);
+
+    // test buffered file stream with cache bypass
+    stream = buffered_file_stream_alloc_ex(storage, 16, BufferedFileStreamAccessAppend);
+    mu_check(buffered_file_stream_open(
+        stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_composite_subtest, stream);
+    stream_free(stream);
     furi_record_close(RECORD_STORAGE);
 }
 
@@ -384,6 +401,105 @@ MU_TEST(stream_split_test) {
     MU_RUN_TEST_1(stream_split_subtest, stream);
     stream_free(stream);
 
+    // test buffered stream with read ahead
+    stream = buffered_file_stream_alloc_ex(storage, 16, BufferedFileStreamAccessSequential);
+    mu_check(buffered_file_stream_open(
+        stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_split_subtest, stream);
+    stream_free(stream);
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool stream_batch_write_callback(Stream* stream, const void* context) {
+    return stream_write_cstring(stream, context) == strlen(context);
+}
+
+MU_TEST_1(stream_batch_subtest, Stream* stream) {
+    uint8_t data[64] = {0};
+
+    // same size: "0123456789" -> "0ab3456cd9"
+    stream_clean(stream);
+    stream_write_cstring(stream, "0123456789");
+    StreamEdit same_size[] = {
+        {.offset = 1,
+         .delete_size = 2,
+         .write_callback = stream_batch_write_callback,
+         .context = "ab"},
+        {.offset = 7,
+         .delete_size = 2,
+         .write_callback = stream_batch_write_callback,
+         .context = "cd"},
+    };
+    mu_check(stream_delete_and_insert_batch(stream, same_size, COUNT_OF(same_size)));
+    mu_assert_int_eq(10, stream_size(stream));
+    mu_assert_int_eq(9, stream_tell(stream));
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(10, stream_read(stream, data, sizeof(data)));
+    mu_assert_string_eq("0ab3456cd9", (const char*)data);
+
+    // shrink, then grow: "0ab3456cd9" -> "03456cd+++++9"
+    StreamEdit shrink_grow[] = {
+        {.offset = 1, .delete_size = 2, .write_callback = NULL, .context = NULL},
+        {.offset = 9,
+         .delete_size = 0,
+         .write_callback = stream_batch_write_callback,
+         .context = "+++++"},
+    };
+    mu_check(stream_delete_and_insert_batch(stream, shrink_grow, COUNT_OF(shrink_grow)));
+    mu_assert_int_eq(13, stream_size(stream));
+    mu_assert_int_eq(12, stream_tell(stream));
+    memset(data, 0, sizeof(data));
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(13, stream_read(stream, data, sizeof(data)));
+    mu_assert_string_eq("03456cd+++++9", (const char*)data);
+
+    // grow, then shrink past the end: "03456cd+++++9" -> "0xxxxx3456cd"
+    StreamEdit grow_shrink[] = {
+        {.offset = 1,
+         .delete_size = 0,
+         .write_callback = stream_batch_write_callback,
+         .context = "xxxxx"},
+        {.offset = 7, .delete_size = 9000, .write_callback = NULL, .context = NULL},
+    };
+    mu_check(stream_delete_and_insert_batch(stream, grow_shrink, COUNT_OF(grow_shrink)));
+    mu_assert_int_eq(12, stream_size(stream));
+    mu_assert_int_eq(12, stream_tell(stream));
+    memset(data, 0, sizeof(data));
+    mu_check(stream_rewind(stream));
+    mu_assert_int_eq(12, stream_read(stream, data, sizeof(data)));
+    mu_assert_string_eq("0xxxxx3456cd", (const char*)data);
+
+    // overlapping edits are rejected
+    StreamEdit overlap[] = {
+        {.offset = 1, .delete_size = 4, .write_callback = NULL, .context = NULL},
+        {.offset = 3, .delete_size = 1, .write_callback = NULL, .context = NULL},
+    };
+    mu_check(!stream_delete_and_insert_batch(stream, overlap, COUNT_OF(overlap)));
+}
+
+MU_TEST(stream_batch_test) {
+    // test string stream
+    Stream* stream;
+    stream = string_stream_alloc();
+    MU_RUN_TEST_1(stream_batch_subtest, stream);
+    stream_free(stream);
+
+    // test file stream
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    stream = file_stream_alloc(storage);
+    mu_check(
+        file_stream_open(stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_batch_subtest, stream);
+    stream_free(stream);
+
+    // test buffered stream
+    stream = buffered_file_stream_alloc(storage);
+    mu_check(buffered_file_stream_open(
+        stream, EXT_PATH("filestream.str"), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_batch_subtest, stream);
+    stream_free(stream);
+
     furi_record_close(RECORD_STORAGE);
 }
 
@@ -494,12 +610,236 @@ MU_TEST(stream_buffered_large_file_test) {
     string_clear(output_data);
 }
 
+MU_TEST(stream_slice_test) {
+    Stream* stream = string_stream_alloc();
+    stream_write_cstring(stream, "first line\r\nkey: value1 value2\n\nlast");
+    stream_rewind(stream);
+
+    string_t buffer;
+    string_init(buffer);
+    const char* slice;
+    size_t size;
+
+    mu_check(stream_read_line_slice(stream, buffer, &slice, &size));
+    mu_assert_int_eq(12, size);
+    mu_check(strncmp(slice, "first line\r\n", size) == 0);
+    // slice must point into the stream buffer, not into the storage
+    mu_assert_int_eq(0, string_size(buffer));
+
+    mu_check(stream_read_token_slice(stream, ":", buffer, &slice, &size));
+    mu_assert_int_eq(3, size);
+    mu_check(strncmp(slice, "key", size) == 0);
+    mu_assert_int_eq(15, stream_tell(stream));
+
+    mu_check(stream_seek(stream, 2, StreamOffsetFromCurrent));
+    mu_check(stream_read_token_slice(stream, " \n", buffer, &slice, &size));
+    mu_check(strncmp(slice, "value1", size) == 0);
+    mu_check(stream_seek(stream, 1, StreamOffsetFromCurrent));
+    mu_check(stream_read_token_slice(stream, " \n", buffer, &slice, &size));
+    mu_check(strncmp(slice, "value2", size) == 0);
+    mu_check(!stream_read_token_slice(stream, " \n", buffer, &slice, &size));
+
+    mu_check(stream_read_line_slice(stream, buffer, &slice, &size));
+    mu_assert_int_eq(1, size);
+    mu_check(stream_read_line_slice(stream, buffer, &slice, &size));
+    mu_assert_int_eq(1, size);
+    mu_check(stream_read_line_slice(stream, buffer, &slice, &size));
+    mu_assert_int_eq(4, size);
+    mu_check(strncmp(slice, "last", size) == 0);
+    mu_check(!stream_read_line_slice(stream, buffer, &slice, &size));
+    mu_check(stream_eof(stream));
+
+    string_clear(buffer);
+    stream_free(stream);
+}
+
+#define STREAM_TEST_IR_SIGNALS 128
+#define STREAM_TEST_IR_SAMPLES 64
+#define STREAM_TEST_NFC_BLOCKS 256
+#define STREAM_TEST_NFC_BLOCK_SIZE 16
+
+static void stream_test_generate_files(Storage* storage) {
+    Stream* stream = buffered_file_stream_alloc(storage);
+
+    buffered_file_stream_open(stream, EXT_PATH("filestream.ir"), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    stream_write_cstring(stream, "Filetype: IR signals file\nVersion: 1\n");
+    for(size_t i = 0; i < STREAM_TEST_IR_SIGNALS; i++) {
+        stream_write_format(
+            stream,
+            "# \nname: Signal_%u\ntype: raw\nfrequency: 38000\nduty_cycle: 0.330000\ndata:",
+            i);
+        for(size_t j = 0; j < STREAM_TEST_IR_SAMPLES; j++) {
+            stream_write_format(stream, " %u", 500 + i + j);
+        }
+        stream_write_char(stream, '\n');
+    }
+    buffered_file_stream_close(stream);
+
+    buffered_file_stream_open(stream, EXT_PATH("filestream.nfc"), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    stream_write_cstring(stream, "Filetype: Flipper NFC device\nVersion: 2\n");
+    stream_write_cstring(stream, "# Mifare Classic specific data\nMifare Classic type: 4K\n");
+    for(size_t i = 0; i < STREAM_TEST_NFC_BLOCKS; i++) {
+        stream_write_format(stream, "Block %u:", i);
+        for(size_t j = 0; j < STREAM_TEST_NFC_BLOCK_SIZE; j++) {
+            stream_write_format(stream, " %02X", (i + j) & 0xFF);
+        }
+        stream_write_char(stream, '\n');
+    }
+    buffered_file_stream_close(stream);
+
+    stream_free(stream);
+}
+
+static uint32_t stream_test_parse_ir(FlipperFormat* ff) {
+    string_t name;
+    string_init(name);
+    uint32_t data[STREAM_TEST_IR_SAMPLES];
+    uint32_t checksum = 0;
+    uint32_t count;
+
+    while(flipper_format_read_string(ff, "name", name)) {
+        if(!flipper_format_get_value_count(ff, "data", &count)) break;
+        if(count != STREAM_TEST_IR_SAMPLES) break;
+        if(!flipper_format_read_uint32(ff, "data", data, count)) break;
+        checksum += string_size(name) + data[0] + data[count - 1];
+    }
+
+    string_clear(name);
+    return checksum;
+}
+
+static uint32_t stream_test_parse_nfc(FlipperFormat* ff) {
+    string_t key;
+    string_init(key);
+    uint8_t data[STREAM_TEST_NFC_BLOCK_SIZE];
+    uint32_t checksum = 0;
+
+    for(size_t i = 0; i < STREAM_TEST_NFC_BLOCKS; i++) {
+        string_printf(key, "Block %u", i);
+        if(!flipper_format_read_hex(ff, string_get_cstr(key), data, sizeof(data))) break;
+        checksum += data[0] + data[STREAM_TEST_NFC_BLOCK_SIZE - 1];
+    }
+
+    string_clear(key);
+    return checksum;
+}
+
+static size_t stream_test_read_lines(Stream* stream, bool slice) {
+    string_t line;
+    string_init(line);
+    const char* data;
+    size_t size;
+    size_t total = 0;
+
+    if(slice) {
+        while(stream_read_line_slice(stream, line, &data, &size)) {
+            total += size;
+            string_reset(line);
+        }
+    } else {
+        while(stream_read_line(stream, line)) {
+            total += string_size(line);
+        }
+    }
+
+    string_clear(line);
+    return total;
+}
+
+MU_TEST(stream_parse_benchmark_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    stream_test_generate_files(storage);
+
+    const char* paths[] = {EXT_PATH("filestream.ir"), EXT_PATH("filestream.nfc")};
+    for(size_t i = 0; i < COUNT_OF(paths); i++) {
+        // file stream has no buffer and takes the copying path, as before
+        Stream* stream = file_stream_alloc(storage);
+        mu_check(file_stream_open(stream, paths[i], FSAM_READ, FSOM_OPEN_EXISTING));
+        uint32_t file_time = furi_get_tick();
+        size_t file_size = stream_test_read_lines(stream, false);
+        file_time = furi_get_tick() - file_time;
+        mu_assert_int_eq(stream_size(stream), file_size);
+        stream_free(stream);
+
+        stream = buffered_file_stream_alloc(storage);
+        mu_check(buffered_file_stream_open(stream, paths[i], FSAM_READ, FSOM_OPEN_EXISTING));
+        uint32_t buffered_time = furi_get_tick();
+        size_t buffered_size = stream_test_read_lines(stream, false);
+        buffered_time = furi_get_tick() - buffered_time;
+        mu_assert_int_eq(file_size, buffered_size);
+
+        mu_check(stream_rewind(stream));
+        uint32_t slice_time = furi_get_tick();
+        size_t slice_size = stream_test_read_lines(stream, true);
+        slice_time = furi_get_tick() - slice_time;
+        mu_assert_int_eq(file_size, slice_size);
+        stream_free(stream);
+
+        stream = buffered_file_stream_alloc_ex(storage, 4096, BufferedFileStreamAccessSequential);
+        mu_check(buffered_file_stream_open(stream, paths[i], FSAM_READ, FSOM_OPEN_EXISTING));
+        uint32_t read_ahead_time = furi_get_tick();
+        size_t read_ahead_size = stream_test_read_lines(stream, true);
+        read_ahead_time = furi_get_tick() - read_ahead_time;
+        mu_assert_int_eq(file_size, read_ahead_size);
+        stream_free(stream);
+
+        FURI_LOG_I(
+            TAG,
+            "%s lines: file %lu ms, buffered %lu ms, buffered slices %lu ms, read ahead %lu ms",
+            paths[i],
+            file_time,
+            buffered_time,
+            slice_time,
+            read_ahead_time);
+    }
+
+    FlipperFormat* ff_file = flipper_format_file_alloc(storage);
+    FlipperFormat* ff_buffered = flipper_format_buffered_file_alloc(storage);
+    uint32_t file_time;
+    uint32_t buffered_time;
+
+    mu_check(flipper_format_file_open_existing(ff_file, EXT_PATH("filestream.ir")));
+    mu_check(flipper_format_buffered_file_open_existing(ff_buffered, EXT_PATH("filestream.ir")));
+    file_time = furi_get_tick();
+    uint32_t file_checksum = stream_test_parse_ir(ff_file);
+    file_time = furi_get_tick() - file_time;
+    buffered_time = furi_get_tick();
+    uint32_t buffered_checksum = stream_test_parse_ir(ff_buffered);
+    buffered_time = furi_get_tick() - buffered_time;
+    mu_check(file_checksum != 0);
+    mu_assert_int_eq(file_checksum, buffered_checksum);
+    FURI_LOG_I(TAG, "IR parse: file %lu ms, buffered %lu ms", file_time, buffered_time);
+    flipper_format_file_close(ff_file);
+    flipper_format_buffered_file_close(ff_buffered);
+
+    mu_check(flipper_format_file_open_existing(ff_file, EXT_PATH("filestream.nfc")));
+    mu_check(flipper_format_buffered_file_open_existing(ff_buffered, EXT_PATH("filestream.nfc")));
+    file_time = furi_get_tick();
+    file_checksum = stream_test_parse_nfc(ff_file);
+    file_time = furi_get_tick() - file_time;
+    buffered_time = furi_get_tick();
+    buffered_checksum = stream_test_parse_nfc(ff_buffered);
+    buffered_time = furi_get_tick() - buffered_time;
+    mu_check(file_checksum != 0);
+    mu_assert_int_eq(file_checksum, buffered_checksum);
+    FURI_LOG_I(TAG, "NFC parse: file %lu ms, buffered %lu ms", file_time, buffered_time);
+
+    flipper_format_free(ff_file);
+    flipper_format_free(ff_buffered);
+    storage_simply_remove(storage, EXT_PATH("filestream.ir"));
+    storage_simply_remove(storage, EXT_PATH("filestream.nfc"));
+    furi_record_close(RECORD_STORAGE);
+}
+
 MU_TEST_SUITE(stream_suite) {
     MU_RUN_TEST(stream_write_read_save_load_test);
     MU_RUN_TEST(stream_composite_test);
     MU_RUN_TEST(stream_split_test);
+    MU_RUN_TEST(stream_batch_test);
     MU_RUN_TEST(stream_buffered_write_after_read_test);
     MU_RUN_TEST(stream_buffered_large_file_test);
+    MU_RUN_TEST(stream_slice_test);
+    MU_RUN_TEST(stream_parse_benchmark_test);
 }
 
 int run_minunit_test_stream() {
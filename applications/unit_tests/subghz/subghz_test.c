@@ -5,6 +5,8 @@
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_keystore.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_file_decoder.h>
+#include <lib/subghz/subghz_raw_packed.h>
 #include <lib/subghz/protocols/registry.h>
 #include <flipper_format/flipper_format_i.h>
 
@@ -15,6 +17,7 @@
 #define TEST_RANDOM_DIR_NAME EXT_PATH("unit_tests/subghz/test_random_raw.sub")
 #define TEST_RANDOM_COUNT_PARSE 188
 #define TEST_TIMEOUT 10000
+#define TEST_KEELOQ_LOOKUP_COUNT 64
 
 static SubGhzEnvironment* environment_handler;
 static SubGhzReceiver* receiver_handler;
@@ -200,12 +203,67 @@ static bool subghz_encoder_test(const char* path) {
     return subghz_test_decoder_count ? true : false;
 }
 
+static bool subghz_keeloq_lookup_test(const char* path) {
+    bool result = false;
+    string_t temp_str;
+    string_init(temp_str);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* fff_data_file = flipper_format_file_alloc(storage);
+
+    do {
+        if(!flipper_format_file_open_existing(fff_data_file, path)) {
+            FURI_LOG_E(TAG, "Error open file %s", path);
+            break;
+        }
+        SubGhzProtocolDecoderBase* decoder = subghz_receiver_search_decoder_base_by_name(
+            receiver_handler, SUBGHZ_PROTOCOL_KEELOQ_NAME);
+        if(!decoder || !subghz_protocol_decoder_base_deserialize(decoder, fff_data_file)) {
+            FURI_LOG_E(TAG, "Deserialize error");
+            break;
+        }
+
+        // First lookup scans the whole keystore, the rest must hit the serial cache
+        uint32_t test_start = furi_get_tick();
+        string_reset(temp_str);
+        subghz_protocol_decoder_base_get_string(decoder, temp_str);
+        uint32_t cold_time = furi_get_tick() - test_start;
+
+        test_start = furi_get_tick();
+        for(size_t i = 0; i < TEST_KEELOQ_LOOKUP_COUNT; i++) {
+            string_reset(temp_str);
+            subghz_protocol_decoder_base_get_string(decoder, temp_str);
+        }
+        uint32_t warm_time = furi_get_tick() - test_start;
+
+        FURI_LOG_I(
+            TAG,
+            "KeeLoq lookup: cold %lums, %d cached %lums",
+            cold_time,
+            TEST_KEELOQ_LOOKUP_COUNT,
+            warm_time);
+        result = string_search_str(temp_str, "MF:DoorHan") != STRING_FAILURE;
+    } while(false);
+
+    flipper_format_free(fff_data_file);
+    furi_record_close(RECORD_STORAGE);
+    string_clear(temp_str);
+
+    return result;
+}
+
 MU_TEST(subghz_keystore_test) {
     mu_assert(
         subghz_environment_load_keystore(environment_handler, KEYSTORE_DIR_NAME),
         "Test keystore error");
 }
 
+MU_TEST(subghz_keystore_keeloq_lookup_test) {
+    mu_assert(
+        subghz_keeloq_lookup_test(EXT_PATH("unit_tests/subghz/doorhan.sub")),
+        "Test keystore KeeLoq lookup error\r\n");
+}
+
 //test decoders
 MU_TEST(subghz_decoder_came_atomo_test) {
     mu_assert(
@@ -515,6 +573,165 @@ MU_TEST(subghz_encoder_honeywell_wdb_test) {
         "Test encoder " SUBGHZ_PROTOCOL_HONEYWELL_WDB_NAME " error\r\n");
 }
 
+static const int32_t subghz_test_raw_packed_samples[] = {
+    -1, 1, 63, -64, 64, -8191, 8192, 32700, -32700, 1000000, INT32_MAX, INT32_MIN, -400, 400};
+#define SUBGHZ_TEST_RAW_PACKED_COUNT COUNT_OF(subghz_test_raw_packed_samples)
+
+typedef struct {
+    int32_t samples[SUBGHZ_TEST_RAW_PACKED_COUNT];
+    size_t count;
+} SubGhzTestRawPacked;
+
+static void subghz_test_raw_packed_callback(void* context, int32_t duration) {
+    SubGhzTestRawPacked* unpacked = context;
+    if(unpacked->count < SUBGHZ_TEST_RAW_PACKED_COUNT) {
+        unpacked->samples[unpacked->count] = duration;
+    }
+    unpacked->count++;
+}
+
+MU_TEST(subghz_raw_packed_test) {
+    uint8_t packed[SUBGHZ_TEST_RAW_PACKED_COUNT * SUBGHZ_RAW_PACKED_SAMPLE_SIZE_MAX];
+    size_t size = subghz_raw_packed_encode(
+        subghz_test_raw_packed_samples, SUBGHZ_TEST_RAW_PACKED_COUNT, packed);
+    mu_assert(size < sizeof(packed), "Packed data is too big\r\n");
+
+    // Whole block
+    SubGhzRawPackedDecoder decoder;
+    SubGhzTestRawPacked unpacked = {.count = 0};
+    subghz_raw_packed_decoder_reset(&decoder);
+    subghz_raw_packed_decode(&decoder, packed, size, subghz_test_raw_packed_callback, &unpacked);
+    mu_assert_int_eq(SUBGHZ_TEST_RAW_PACKED_COUNT, unpacked.count);
+    mu_assert(
+        memcmp(subghz_test_raw_packed_samples, unpacked.samples, sizeof(unpacked.samples)) == 0,
+        "Unpacked samples mismatch\r\n");
+
+    // Byte by byte, samples split between reads
+    unpacked.count = 0;
+    subghz_raw_packed_decoder_reset(&decoder);
+    for(size_t i = 0; i < size; i++) {
+        subghz_raw_packed_decode(
+            &decoder, &packed[i], 1, subghz_test_raw_packed_callback, &unpacked);
+    }
+    mu_assert_int_eq(SUBGHZ_TEST_RAW_PACKED_COUNT, unpacked.count);
+    mu_assert(
+        memcmp(subghz_test_raw_packed_samples, unpacked.samples, sizeof(unpacked.samples)) == 0,
+        "Unpacked samples mismatch\r\n");
+}
+
+#define TEST_RAW_PACKED_FILE_NAME "unit_test_raw_packed"
+#define TEST_RAW_PACKED_FILE_PATH \
+    SUBGHZ_RAW_FOLDER "/" TEST_RAW_PACKED_FILE_NAME SUBGHZ_APP_EXTENSION
+// Spans several writer blocks
+#define TEST_RAW_PACKED_FILE_COUNT 1500
+
+static int32_t subghz_test_raw_packed_file_sample(size_t index) {
+    int32_t duration = 100 + (int32_t)((index * 7919) % 30000);
+    return (index & 1) ? -duration : duration;
+}
+
+typedef struct {
+    size_t count;
+    size_t mismatch;
+} SubGhzTestRawPackedFile;
+
+static void subghz_test_raw_packed_file_callback(void* context, int32_t duration) {
+    SubGhzTestRawPackedFile* unpacked = context;
+    if(duration != subghz_test_raw_packed_file_sample(unpacked->count)) {
+        unpacked->mismatch++;
+    }
+    unpacked->count++;
+}
+
+MU_TEST(subghz_raw_packed_file_test) {
+    // Record Version 2 file through RAW decoder
+    SubGhzPresetDefinition preset = {.frequency = 433920000, .data = NULL, .data_size = 0};
+    string_init_set_str(preset.name, "AM650");
+    SubGhzProtocolDecoderRAW* decoder_raw = subghz_protocol_decoder_raw_alloc(environment_handler);
+    subghz_protocol_raw_save_to_file_set_packed(decoder_raw, true);
+    bool is_init =
+        subghz_protocol_raw_save_to_file_init(decoder_raw, TEST_RAW_PACKED_FILE_NAME, &preset);
+    for(size_t i = 0; is_init && i < TEST_RAW_PACKED_FILE_COUNT; i++) {
+        int32_t sample = subghz_test_raw_packed_file_sample(i);
+        subghz_protocol_decoder_raw_feed(decoder_raw, sample > 0, abs(sample));
+    }
+    subghz_protocol_raw_save_to_file_stop(decoder_raw);
+    subghz_protocol_decoder_raw_free(decoder_raw);
+    string_clear(preset.name);
+    mu_assert(is_init, "Unable to create RAW file\r\n");
+
+    // Read it back the way file readers do
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    string_t temp_str;
+    string_init(temp_str);
+    uint32_t version = 0;
+    SubGhzTestRawPackedFile unpacked = {.count = 0, .mismatch = 0};
+
+    bool is_read = false;
+    do {
+        if(!flipper_format_file_open_existing(flipper_format, TEST_RAW_PACKED_FILE_PATH)) break;
+        if(!flipper_format_read_header(flipper_format, temp_str, &version)) break;
+        if(!flipper_format_read_string(flipper_format, "Protocol", temp_str)) break;
+
+        Stream* stream = flipper_format_get_raw_stream(flipper_format);
+        //skip the end of the previous line "\n"
+        stream_seek(stream, 1, StreamOffsetFromCurrent);
+        SubGhzRawPackedDecoder packed_decoder;
+        subghz_raw_packed_decoder_reset(&packed_decoder);
+        uint8_t packed[64];
+        size_t size;
+        while((size = stream_read(stream, packed, sizeof(packed))) > 0) {
+            subghz_raw_packed_decode(
+                &packed_decoder, packed, size, subghz_test_raw_packed_file_callback, &unpacked);
+        }
+        is_read = true;
+    } while(false);
+
+    string_clear(temp_str);
+    flipper_format_free(flipper_format);
+    storage_simply_remove(storage, TEST_RAW_PACKED_FILE_PATH);
+    furi_record_close(RECORD_STORAGE);
+
+    mu_assert(is_read, "Unable to read RAW file\r\n");
+    mu_assert_int_eq(SUBGHZ_RAW_FILE_VERSION_PACKED, version);
+    mu_assert_int_eq(TEST_RAW_PACKED_FILE_COUNT, unpacked.count);
+    mu_assert_int_eq(0, unpacked.mismatch);
+}
+
+static void subghz_test_file_decoder_rx_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    UNUSED(decoder_base);
+    UNUSED(context);
+    subghz_receiver_reset(receiver);
+}
+
+static bool subghz_file_decoder_test(const char* path) {
+    SubGhzFileDecoder* file_decoder = subghz_file_decoder_alloc(environment_handler);
+    subghz_file_decoder_set_rx_callback(file_decoder, subghz_test_file_decoder_rx_callback, NULL);
+
+    bool result = subghz_file_decoder_run(file_decoder, path);
+    uint32_t sample_count = subghz_file_decoder_get_sample_count(file_decoder);
+    uint32_t packet_count = subghz_file_decoder_get_packet_count(file_decoder);
+    uint32_t decode_us = (uint32_t)(subghz_file_decoder_get_decode_cycles(file_decoder) /
+                                     furi_hal_cortex_instructions_per_microsecond());
+    FURI_LOG_I(
+        TAG,
+        "File decoder: %lu samples, %lu packets, %lu us",
+        sample_count,
+        packet_count,
+        decode_us);
+
+    subghz_file_decoder_free(file_decoder);
+    return result && sample_count && packet_count;
+}
+
+MU_TEST(subghz_file_decoder_random_test) {
+    mu_assert(subghz_file_decoder_test(TEST_RANDOM_DIR_NAME), "File decoder test error\r\n");
+}
+
 MU_TEST(subghz_random_test) {
     mu_assert(subghz_decode_random_test(TEST_RANDOM_DIR_NAME), "Random test error\r\n");
 }
@@ -522,6 +739,7 @@ MU_TEST(subghz_random_test) {
 MU_TEST_SUITE(subghz) {
     subghz_test_init();
     MU_RUN_TEST(subghz_keystore_test);
+    MU_RUN_TEST(subghz_keystore_keeloq_lookup_test);
 
     MU_RUN_TEST(subghz_decoder_came_atomo_test);
     MU_RUN_TEST(subghz_decoder_came_test);
@@ -572,6 +790,9 @@ MU_TEST_SUITE(subghz) {
     MU_RUN_TEST(subghz_encoder_honeywell_wdb_test);
 
     MU_RUN_TEST(subghz_random_test);
+    MU_RUN_TEST(subghz_file_decoder_random_test);
+    MU_RUN_TEST(subghz_raw_packed_test);
+    MU_RUN_TEST(subghz_raw_packed_file_test);
     subghz_test_deinit();
 }
 
@@ -87,7 +87,7 @@ to exclude the API function. */
 // #define configUSE_OS2_EVENTFLAGS_FROM_ISR 1
 
 /* CMSIS-RTOS */
-#define configTASK_NOTIFICATION_ARRAY_ENTRIES 2
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 3
 #define CMSIS_TASK_NOTIFY_INDEX 1
 
 extern __attribute__((__noreturn__)) void furi_thread_catch();
@@ -219,7 +219,7 @@
 /  When enable exFAT, also LFN needs to be enabled. (_USE_LFN >= 1)
 /  Note that enabling exFAT discards C89 compatibility. */
 
-#define _FS_NORTC 1
+#define _FS_NORTC 0
 #define _NORTC_MON 7
 #define _NORTC_MDAY 20
 #define _NORTC_YEAR 2021
@@ -0,0 +1,382 @@
+#include "sector_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SECTOR_CACHE_INVALID UINT32_MAX
+
+typedef struct {
+    uint32_t sector;
+    uint32_t last_use;
+    bool dirty;
+    bool pinned;
+} SectorCacheSlot;
+
+struct SectorCache {
+    size_t sector_size;
+
+    SectorCacheSlot* slots;
+    uint8_t* slot_data;
+    size_t slot_count;
+    uint32_t use_counter;
+
+    // Read-ahead window, also used to coalesce write-back
+    uint8_t* window_data;
+    size_t window_size;
+    uint32_t window_sector;
+    size_t window_count;
+    uint32_t next_sector;
+
+    SectorCacheReadCallback read;
+    SectorCacheWriteCallback write;
+    void* context;
+
+    SectorCacheStats stats;
+};
+
+SectorCache* sector_cache_alloc(
+    size_t sector_size,
+    size_t slot_count,
+    size_t read_ahead,
+    SectorCacheReadCallback read,
+    SectorCacheWriteCallback write,
+    void* context) {
+    SectorCache* cache = malloc(sizeof(SectorCache));
+    memset(cache, 0, sizeof(SectorCache));
+
+    cache->sector_size = sector_size;
+    cache->slot_count = slot_count;
+    cache->slots = malloc(sizeof(SectorCacheSlot) * slot_count);
+    cache->slot_data = malloc(sector_size * slot_count);
+    cache->window_size = read_ahead;
+    if(read_ahead > 0) {
+        cache->window_data = malloc(sector_size * read_ahead);
+    }
+
+    cache->read = read;
+    cache->write = write;
+    cache->context = context;
+
+    sector_cache_invalidate(cache);
+    return cache;
+}
+
+void sector_cache_free(SectorCache* cache) {
+    free(cache->window_data);
+    free(cache->slot_data);
+    free(cache->slots);
+    free(cache);
+}
+
+static uint8_t* sector_cache_slot_data(SectorCache* cache, SectorCacheSlot* slot) {
+    return cache->slot_data + (slot - cache->slots) * cache->sector_size;
+}
+
+static SectorCacheSlot* sector_cache_slot_find(SectorCache* cache, uint32_t sector) {
+    for(size_t i = 0; i < cache->slot_count; i++) {
+        if(cache->slots[i].sector == sector) {
+            return &cache->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static uint8_t* sector_cache_window_find(SectorCache* cache, uint32_t sector) {
+    if(cache->window_count > 0 && sector >= cache->window_sector &&
+       sector - cache->window_sector < cache->window_count) {
+        return cache->window_data + (sector - cache->window_sector) * cache->sector_size;
+    }
+    return NULL;
+}
+
+static void sector_cache_slot_use(SectorCache* cache, SectorCacheSlot* slot, bool pin) {
+    slot->last_use = ++cache->use_counter;
+
+    if(pin && !slot->pinned) {
+        // Up to half of the slots can be pinned, the oldest pinned slot is released
+        size_t pinned_max = cache->slot_count / 2;
+        size_t pinned_count = 0;
+        SectorCacheSlot* oldest = NULL;
+        for(size_t i = 0; i < cache->slot_count; i++) {
+            if(cache->slots[i].pinned) {
+                pinned_count++;
+                if(!oldest || cache->slots[i].last_use < oldest->last_use) {
+                    oldest = &cache->slots[i];
+                }
+            }
+        }
+        if(oldest && pinned_count >= pinned_max) {
+            oldest->pinned = false;
+        }
+        slot->pinned = true;
+    }
+}
+
+static bool sector_cache_slot_write_back(SectorCache* cache, SectorCacheSlot* slot) {
+    cache->stats.device_writes++;
+    if(!cache->write(cache->context, sector_cache_slot_data(cache, slot), slot->sector, 1)) {
+        return false;
+    }
+    cache->stats.write_backs++;
+    slot->dirty = false;
+    return true;
+}
+
+// Free slot or the least recently used one, unpinned slots first
+static SectorCacheSlot* sector_cache_slot_take(SectorCache* cache, uint32_t sector) {
+    SectorCacheSlot* victim = NULL;
+    for(size_t i = 0; i < cache->slot_count; i++) {
+        SectorCacheSlot* slot = &cache->slots[i];
+        if(slot->sector == SECTOR_CACHE_INVALID) {
+            victim = slot;
+            break;
+        }
+        if(!victim || (victim->pinned && !slot->pinned) ||
+           (victim->pinned == slot->pinned && slot->last_use < victim->last_use)) {
+            victim = slot;
+        }
+    }
+
+    if(victim->dirty && !sector_cache_slot_write_back(cache, victim)) {
+        return NULL;
+    }
+
+    victim->sector = sector;
+    victim->pinned = false;
+    return victim;
+}
+
+static void sector_cache_window_update(
+    SectorCache* cache,
+    const uint8_t* buff,
+    uint32_t sector,
+    size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        uint8_t* data = sector_cache_window_find(cache, sector + i);
+        if(data) {
+            memcpy(data, buff + i * cache->sector_size, cache->sector_size);
+        }
+    }
+}
+
+static bool sector_cache_device_read(
+    SectorCache* cache,
+    uint8_t* buff,
+    uint32_t sector,
+    size_t count) {
+    cache->stats.device_reads++;
+    return cache->read(cache->context, buff, sector, count);
+}
+
+bool sector_cache_read(
+    SectorCache* cache,
+    uint8_t* buff,
+    uint32_t sector,
+    size_t count,
+    bool pin) {
+    const size_t sector_size = cache->sector_size;
+    bool sequential = (sector == cache->next_sector);
+    if(!pin) {
+        // Metadata reads don't break sequential access to data
+        cache->next_sector = sector + count;
+    }
+
+    if(count > cache->slot_count / 2) {
+        // Large transfer, directly to the buffer, dirty sectors are newer than the device ones
+        if(!sector_cache_device_read(cache, buff, sector, count)) return false;
+        cache->stats.misses += count;
+        for(size_t i = 0; i < cache->slot_count; i++) {
+            SectorCacheSlot* slot = &cache->slots[i];
+            if(slot->dirty && slot->sector >= sector && slot->sector - sector < count) {
+                memcpy(
+                    buff + (slot->sector - sector) * sector_size,
+                    sector_cache_slot_data(cache, slot),
+                    sector_size);
+            }
+        }
+        return true;
+    }
+
+    size_t i = 0;
+    while(i < count) {
+        uint8_t* dst = buff + i * sector_size;
+
+        SectorCacheSlot* slot = sector_cache_slot_find(cache, sector + i);
+        if(slot) {
+            memcpy(dst, sector_cache_slot_data(cache, slot), sector_size);
+            sector_cache_slot_use(cache, slot, pin);
+            cache->stats.hits++;
+            i++;
+            continue;
+        }
+
+        uint8_t* window = sector_cache_window_find(cache, sector + i);
+        if(window) {
+            memcpy(dst, window, sector_size);
+            cache->stats.read_ahead_hits++;
+            i++;
+            continue;
+        }
+
+        // Run of missing sectors
+        size_t run = 1;
+        while(i + run < count && !sector_cache_slot_find(cache, sector + i + run) &&
+              !sector_cache_window_find(cache, sector + i + run)) {
+            run++;
+        }
+
+        if(sequential && !pin && i + run == count && run < cache->window_size) {
+            uint8_t* window_data = cache->window_data;
+            cache->window_count = 0;
+            if(sector_cache_device_read(cache, window_data, sector + i, cache->window_size)) {
+                cache->window_sector = sector + i;
+                cache->window_count = cache->window_size;
+                for(size_t j = 0; j < cache->slot_count; j++) {
+                    slot = &cache->slots[j];
+                    if(slot->dirty) {
+                        sector_cache_window_update(
+                            cache, sector_cache_slot_data(cache, slot), slot->sector, 1);
+                    }
+                }
+                memcpy(dst, cache->window_data, run * sector_size);
+                cache->stats.misses += run;
+                cache->stats.read_ahead += cache->window_size - run;
+                i += run;
+                continue;
+            }
+            // Read past the end of the device, read without read-ahead
+        }
+
+        if(!sector_cache_device_read(cache, dst, sector + i, run)) return false;
+        cache->stats.misses += run;
+        for(size_t j = 0; j < run; j++) {
+            slot = sector_cache_slot_take(cache, sector + i + j);
+            if(slot) {
+                memcpy(sector_cache_slot_data(cache, slot), dst + j * sector_size, sector_size);
+                sector_cache_slot_use(cache, slot, pin);
+            }
+        }
+        i += run;
+    }
+
+    return true;
+}
+
+bool sector_cache_write(
+    SectorCache* cache,
+    const uint8_t* buff,
+    uint32_t sector,
+    size_t count,
+    bool pin) {
+    const size_t sector_size = cache->sector_size;
+    cache->stats.writes += count;
+    sector_cache_window_update(cache, buff, sector, count);
+
+    if(count > cache->slot_count / 2) {
+        // Large transfer, directly to the device, cached copies are updated
+        cache->stats.device_writes++;
+        if(!cache->write(cache->context, buff, sector, count)) return false;
+        for(size_t i = 0; i < cache->slot_count; i++) {
+            SectorCacheSlot* slot = &cache->slots[i];
+            if(slot->sector != SECTOR_CACHE_INVALID && slot->sector >= sector &&
+               slot->sector - sector < count) {
+                memcpy(
+                    sector_cache_slot_data(cache, slot),
+                    buff + (slot->sector - sector) * sector_size,
+                    sector_size);
+                slot->dirty = false;
+            }
+        }
+        return true;
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        SectorCacheSlot* slot = sector_cache_slot_find(cache, sector + i);
+        if(!slot) {
+            slot = sector_cache_slot_take(cache, sector + i);
+            if(!slot) return false;
+        }
+        memcpy(sector_cache_slot_data(cache, slot), buff + i * sector_size, sector_size);
+        slot->dirty = true;
+        sector_cache_slot_use(cache, slot, pin);
+    }
+
+    return true;
+}
+
+static SectorCacheSlot* sector_cache_dirty_find_first(SectorCache* cache) {
+    SectorCacheSlot* first = NULL;
+    for(size_t i = 0; i < cache->slot_count; i++) {
+        SectorCacheSlot* slot = &cache->slots[i];
+        if(slot->dirty && (!first || slot->sector < first->sector)) {
+            first = slot;
+        }
+    }
+    return first;
+}
+
+static SectorCacheSlot* sector_cache_dirty_find(SectorCache* cache, uint32_t sector) {
+    SectorCacheSlot* slot = sector_cache_slot_find(cache, sector);
+    return (slot && slot->dirty) ? slot : NULL;
+}
+
+bool sector_cache_sync(SectorCache* cache) {
+    SectorCacheSlot* slot;
+    while((slot = sector_cache_dirty_find_first(cache)) != NULL) {
+        // Consecutive dirty sectors are written at once through the read-ahead window
+        size_t run = 1;
+        while(run < cache->window_size && sector_cache_dirty_find(cache, slot->sector + run)) {
+            run++;
+        }
+
+        if(run == 1) {
+            if(!sector_cache_slot_write_back(cache, slot)) return false;
+            continue;
+        }
+
+        cache->window_count = 0;
+        for(size_t i = 0; i < run; i++) {
+            memcpy(
+                cache->window_data + i * cache->sector_size,
+                sector_cache_slot_data(cache, sector_cache_slot_find(cache, slot->sector + i)),
+                cache->sector_size);
+        }
+        cache->stats.device_writes++;
+        if(!cache->write(cache->context, cache->window_data, slot->sector, run)) return false;
+
+        uint32_t sector = slot->sector;
+        for(size_t i = 0; i < run; i++) {
+            sector_cache_slot_find(cache, sector + i)->dirty = false;
+        }
+        cache->stats.write_backs += run;
+    }
+
+    return true;
+}
+
+void sector_cache_invalidate(SectorCache* cache) {
+    for(size_t i = 0; i < cache->slot_count; i++) {
+        cache->slots[i].sector = SECTOR_CACHE_INVALID;
+        cache->slots[i].last_use = 0;
+        cache->slots[i].dirty = false;
+        cache->slots[i].pinned = false;
+    }
+    cache->use_counter = 0;
+    cache->window_count = 0;
+    cache->next_sector = SECTOR_CACHE_INVALID;
+}
+
+size_t sector_cache_get_dirty_count(SectorCache* cache) {
+    size_t count = 0;
+    for(size_t i = 0; i < cache->slot_count; i++) {
+        if(cache->slots[i].dirty) count++;
+    }
+    return count;
+}
+
+void sector_cache_get_stats(SectorCache* cache, SectorCacheStats* stats) {
+    *stats = cache->stats;
+}
+
+void sector_cache_reset_stats(SectorCache* cache) {
+    memset(&cache->stats, 0, sizeof(SectorCacheStats));
+}
@@ -0,0 +1,139 @@
+/**
+ * @file sector_cache.h
+ * LRU sector cache for block devices.
+ *
+ * Sits between FatFS disk I/O and the device driver:
+ * - single sectors are kept in LRU slots, pinned sectors (FAT and directory) are evicted last
+ * - sequential reads fill a read-ahead window with one multi-sector device read
+ * - writes are kept dirty in slots and written back on eviction or sync
+ * - large transfers go directly to the device, cached copies are kept coherent
+ *
+ * Device access is done through callbacks only, so the cache can run against any disk.
+ * The repository has no host test build, the unit tests in
+ * applications/unit_tests/storage/sector_cache_test.c run it against a RAM disk on the device.
+ */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SectorCache SectorCache;
+
+/** Read sectors from the device
+ * @param context callback context
+ * @param buff destination, count * sector_size bytes
+ * @param sector first sector
+ * @param count sector count
+ * @return true on success
+ */
+typedef bool (
+    *SectorCacheReadCallback)(void* context, uint8_t* buff, uint32_t sector, size_t count);
+
+/** Write sectors to the device
+ * @param context callback context
+ * @param buff source, count * sector_size bytes
+ * @param sector first sector
+ * @param count sector count
+ * @return true on success
+ */
+typedef bool (
+    *SectorCacheWriteCallback)(void* context, const uint8_t* buff, uint32_t sector, size_t count);
+
+typedef struct {
+    uint32_t hits; /**< sectors read from slots */
+    uint32_t read_ahead_hits; /**< sectors read from the read-ahead window */
+    uint32_t misses; /**< sectors read from the device */
+    uint32_t read_ahead; /**< sectors read ahead */
+    uint32_t writes; /**< sectors written by the user */
+    uint32_t write_backs; /**< dirty sectors written to the device */
+    uint32_t device_reads; /**< read requests to the device */
+    uint32_t device_writes; /**< write requests to the device */
+} SectorCacheStats;
+
+/** Allocate the cache
+ * @param sector_size sector size in bytes
+ * @param slot_count number of cached single sectors
+ * @param read_ahead size of the read-ahead window in sectors, 0 to disable read-ahead
+ * @param read read callback
+ * @param write write callback
+ * @param context callbacks context
+ * @return SectorCache*
+ */
+SectorCache* sector_cache_alloc(
+    size_t sector_size,
+    size_t slot_count,
+    size_t read_ahead,
+    SectorCacheReadCallback read,
+    SectorCacheWriteCallback write,
+    void* context);
+
+/** Free the cache, dirty sectors are lost, use sector_cache_sync first
+ * @param cache
+ */
+void sector_cache_free(SectorCache* cache);
+
+/** Read sectors through the cache
+ * @param cache
+ * @param buff destination, count * sector_size bytes
+ * @param sector first sector
+ * @param count sector count
+ * @param pin keep the sectors longer than other ones (filesystem metadata)
+ * @return true on success
+ */
+bool sector_cache_read(
+    SectorCache* cache,
+    uint8_t* buff,
+    uint32_t sector,
+    size_t count,
+    bool pin);
+
+/** Write sectors through the cache, small writes are deferred until eviction or sync
+ * @param cache
+ * @param buff source, count * sector_size bytes
+ * @param sector first sector
+ * @param count sector count
+ * @param pin keep the sectors longer than other ones (filesystem metadata)
+ * @return true on success
+ */
+bool sector_cache_write(
+    SectorCache* cache,
+    const uint8_t* buff,
+    uint32_t sector,
+    size_t count,
+    bool pin);
+
+/** Write all dirty sectors to the device
+ * @param cache
+ * @return true on success
+ */
+bool sector_cache_sync(SectorCache* cache);
+
+/** Drop all cached sectors without writing them back (media changed)
+ * @param cache
+ */
+void sector_cache_invalidate(SectorCache* cache);
+
+/** Get the number of dirty sectors
+ * @param cache
+ * @return size_t
+ */
+size_t sector_cache_get_dirty_count(SectorCache* cache);
+
+/** Get cache statistics
+ * @param cache
+ * @param stats
+ */
+void sector_cache_get_stats(SectorCache* cache, SectorCacheStats* stats);
+
+/** Reset cache statistics
+ * @param cache
+ */
+void sector_cache_reset_stats(SectorCache* cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -35,13 +35,40 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "user_diskio.h"
+#include "fatfs.h"
 #include <furi_hal.h>
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define SD_CACHE_SLOTS 8
+#define SD_CACHE_READ_AHEAD 4
 
 /* Private variables ---------------------------------------------------------*/
 /* Disk status */
 static volatile DSTATUS Stat = STA_NOINIT;
+/* Sector cache, SPI bus must be acquired for any cache operation */
+static SectorCache* sd_cache = NULL;
+
+static bool User_CacheRead(void* context, uint8_t* buff, uint32_t sector, size_t count) {
+    UNUSED(context);
+    if(BSP_SD_ReadBlocks((uint32_t*)buff, sector, count, SD_DATATIMEOUT) != MSD_OK) {
+        return false;
+    }
+    /* wait until the read operation is finished */
+    while(BSP_SD_GetCardState() != MSD_OK) {
+    }
+    return true;
+}
+
+static bool User_CacheWrite(void* context, const uint8_t* buff, uint32_t sector, size_t count) {
+    UNUSED(context);
+    if(BSP_SD_WriteBlocks((uint32_t*)buff, sector, count, SD_DATATIMEOUT) != MSD_OK) {
+        return false;
+    }
+    /* wait until the Write operation is finished */
+    while(BSP_SD_GetCardState() != MSD_OK) {
+    }
+    return true;
+}
 
 static DSTATUS User_CheckStatus(BYTE lun) {
     UNUSED(lun);
@@ -88,6 +115,13 @@ Diskio_drvTypeDef USER_Driver = {
 DSTATUS USER_initialize(BYTE pdrv) {
     /* USER CODE BEGIN INIT */
 
+    if(sd_cache == NULL) {
+        sd_cache = sector_cache_alloc(
+            _MIN_SS, SD_CACHE_SLOTS, SD_CACHE_READ_AHEAD, User_CacheRead, User_CacheWrite, NULL);
+    }
+    /* Card may be changed, cached sectors are not valid anymore */
+    sector_cache_invalidate(sd_cache);
+
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
@@ -128,10 +162,8 @@ DRESULT USER_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
-    if(BSP_SD_ReadBlocks((uint32_t*)buff, (uint32_t)(sector), count, SD_DATATIMEOUT) == MSD_OK) {
-        /* wait until the read operation is finished */
-        while(BSP_SD_GetCardState() != MSD_OK) {
-        }
+    /* Sectors read to the filesystem window are FAT and directory sectors */
+    if(sector_cache_read(sd_cache, buff, sector, count, buff == USERFatFS.win)) {
         res = RES_OK;
     }
 
@@ -160,10 +192,7 @@ DRESULT USER_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count) {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
-    if(BSP_SD_WriteBlocks((uint32_t*)buff, (uint32_t)(sector), count, SD_DATATIMEOUT) == MSD_OK) {
-        /* wait until the Write operation is finished */
-        while(BSP_SD_GetCardState() != MSD_OK) {
-        }
+    if(sector_cache_write(sd_cache, buff, sector, count, buff == USERFatFS.win)) {
         res = RES_OK;
     }
 
@@ -197,7 +226,9 @@ DRESULT USER_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
     switch(cmd) {
     /* Make sure that no pending write process */
     case CTRL_SYNC:
-        res = RES_OK;
+        if(sector_cache_sync(sd_cache)) {
+            res = RES_OK;
+        }
         break;
 
     /* Get number of sectors on the disk (DWORD) */
@@ -233,4 +264,28 @@ DRESULT USER_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
 }
 #endif /* _USE_IOCTL == 1 */
 
+void USER_cache_reset(bool write_back) {
+    if(sd_cache == NULL) return;
+
+    if(write_back) {
+        furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
+        furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
+
+        sector_cache_sync(sd_cache);
+
+        furi_hal_sd_spi_handle = NULL;
+        furi_hal_spi_release(&furi_hal_spi_bus_handle_sd_fast);
+    }
+
+    sector_cache_invalidate(sd_cache);
+}
+
+void USER_cache_get_stats(SectorCacheStats* stats) {
+    if(sd_cache == NULL) {
+        memset(stats, 0, sizeof(SectorCacheStats));
+    } else {
+        sector_cache_get_stats(sd_cache, stats);
+    }
+}
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -32,11 +32,22 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "stm32_adafruit_sd.h"
 #include "fatfs/ff_gen_drv.h"
+#include "sector_cache.h"
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 extern Diskio_drvTypeDef USER_Driver;
 
+/** Drop cached sectors of the card
+ * @param write_back write dirty sectors to the card first, false if the card is removed
+ */
+void USER_cache_reset(bool write_back);
+
+/** Get sector cache statistics
+ * @param stats
+ */
+void USER_cache_get_stats(SectorCacheStats* stats);
+
 /* USER CODE END 0 */
 
 #ifdef __cplusplus
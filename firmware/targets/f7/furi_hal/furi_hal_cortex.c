@@ -18,3 +18,7 @@ void furi_hal_cortex_delay_us(uint32_t microseconds) {
 uint32_t furi_hal_cortex_instructions_per_microsecond() {
     return SystemCoreClock / 1000000;
 }
+
+uint32_t furi_hal_cortex_get_cycle_count() {
+    return DWT->CYCCNT;
+}
@@ -27,6 +27,12 @@ void furi_hal_cortex_delay_us(uint32_t microseconds);
  */
 uint32_t furi_hal_cortex_instructions_per_microsecond();
 
+/** Get DWT cycle counter value
+ *
+ * @return     current cycle counter value
+ */
+uint32_t furi_hal_cortex_get_cycle_count();
+
 #ifdef __cplusplus
 }
 #endif
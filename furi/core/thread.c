@@ -11,6 +11,7 @@
 #include <furi_hal_console.h>
 
 #define THREAD_NOTIFY_INDEX 1 // Index 0 is used for stream buffers
+#define THREAD_SIGNAL_INDEX 2
 
 typedef struct FuriThreadStdout FuriThreadStdout;
 
@@ -243,6 +244,17 @@ void furi_thread_yield() {
 #define THREAD_FLAGS_INVALID_BITS (~((1UL << MAX_BITS_TASK_NOTIFY) - 1U))
 #define EVENT_FLAGS_INVALID_BITS (~((1UL << MAX_BITS_EVENT_GROUPS) - 1U))
 
+void furi_thread_signal(FuriThreadId thread_id) {
+    furi_assert(thread_id);
+    furi_assert(!FURI_IS_IRQ_MODE());
+    (void)xTaskNotifyGiveIndexed((TaskHandle_t)thread_id, THREAD_SIGNAL_INDEX);
+}
+
+bool furi_thread_signal_wait(uint32_t timeout) {
+    furi_assert(!FURI_IS_IRQ_MODE());
+    return ulTaskNotifyTakeIndexed(THREAD_SIGNAL_INDEX, pdTRUE, timeout) != 0;
+}
+
 uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
     TaskHandle_t hTask = (TaskHandle_t)thread_id;
     uint32_t rflags;
@@ -192,6 +192,23 @@ FuriThread* furi_thread_get_current();
 /** Return control to scheduler */
 void furi_thread_yield();
 
+/** Signal the thread, wakes up furi_thread_signal_wait
+ *
+ * Every thread (FuriThread or not) has one signal, which doesn't need allocation.
+ * Signals are not counted: several signals before the wait wake it up once.
+ *
+ * @param      thread_id  thread to signal
+ */
+void furi_thread_signal(FuriThreadId thread_id);
+
+/** Wait for the signal of current thread
+ *
+ * @param      timeout  timeout in ticks
+ *
+ * @return     true if signaled, false on timeout
+ */
+bool furi_thread_signal_wait(uint32_t timeout);
+
 uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
 
 uint32_t furi_thread_flags_clear(uint32_t flags);
@@ -1,4 +1,5 @@
 #include <core/check.h>
+#include <m-array.h>
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
 #include <toolbox/stream/file_stream.h>
@@ -7,11 +8,36 @@
 #include "flipper_format_i.h"
 #include "flipper_format_stream.h"
 #include "flipper_format_stream_i.h"
+#include "flipper_format_binary.h"
 
 /********************************** Private **********************************/
+typedef struct {
+    uint32_t hash;
+    uint32_t offset;
+} FlipperFormatKeyIndexItem;
+
+ARRAY_DEF(FlipperFormatKeyIndex, FlipperFormatKeyIndexItem, M_POD_OPLIST)
+
+// Key and data are owned by the queue
+ARRAY_DEF(FlipperFormatUpdateQueue, FlipperStreamWriteData, M_POD_OPLIST)
+
 struct FlipperFormat {
     Stream* stream;
     bool strict_mode;
+
+    // Key line offsets in file order, built on the first lookup
+    bool key_index_enabled;
+    bool key_index_valid;
+    size_t key_index_stream_size;
+    FlipperFormatKeyIndex_t key_index;
+
+    bool update_batch;
+    FlipperFormatUpdateQueue_t update_queue;
+
+    // Container state of a binary file, NULL for a text file
+    FlipperFormatBinary* binary;
+    // Format of new files
+    bool binary_default;
 };
 
 static const char* const flipper_format_filetype_key = "Filetype";
@@ -21,38 +47,357 @@ Stream* flipper_format_get_raw_stream(FlipperFormat* flipper_format) {
     return flipper_format->stream;
 }
 
-/********************************** Public **********************************/
-
-FlipperFormat* flipper_format_string_alloc() {
+static FlipperFormat* flipper_format_alloc(Stream* stream) {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
-    flipper_format->stream = string_stream_alloc();
+    flipper_format->stream = stream;
     flipper_format->strict_mode = false;
+    flipper_format->key_index_enabled = false;
+    flipper_format->key_index_valid = false;
+    flipper_format->key_index_stream_size = 0;
+    FlipperFormatKeyIndex_init(flipper_format->key_index);
+    flipper_format->update_batch = false;
+    FlipperFormatUpdateQueue_init(flipper_format->update_queue);
+    flipper_format->binary = NULL;
+    flipper_format->binary_default = false;
     return flipper_format;
 }
 
+static uint32_t flipper_format_key_hash(const char* key, size_t size) {
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+static void flipper_format_key_index_add(string_t key, size_t offset, void* context) {
+    FlipperFormat* flipper_format = context;
+    FlipperFormatKeyIndexItem* item = FlipperFormatKeyIndex_push_new(flipper_format->key_index);
+    item->hash = flipper_format_key_hash(string_get_cstr(key), string_size(key));
+    item->offset = offset;
+}
+
+static void flipper_format_key_index_invalidate(FlipperFormat* flipper_format) {
+    flipper_format->key_index_valid = false;
+    FlipperFormatKeyIndex_reset(flipper_format->key_index);
+}
+
+static bool flipper_format_key_index_build(FlipperFormat* flipper_format) {
+    Stream* stream = flipper_format->stream;
+    size_t position = stream_tell(stream);
+
+    FlipperFormatKeyIndex_reset(flipper_format->key_index);
+    if(stream_rewind(stream)) {
+        flipper_format_stream_for_each_key(stream, flipper_format_key_index_add, flipper_format);
+        flipper_format->key_index_valid = true;
+        flipper_format->key_index_stream_size = stream_size(stream);
+    }
+    if(!stream_seek(stream, position, StreamOffsetFromStart)) {
+        flipper_format_key_index_invalidate(flipper_format);
+    }
+
+    return flipper_format->key_index_valid;
+}
+
+// Hashes may collide, check that the line at the offset really starts with the key
+static bool flipper_format_key_index_check(Stream* stream, const char* key, size_t offset) {
+    const size_t buffer_size = 32;
+    char buffer[buffer_size];
+    size_t key_size = strlen(key);
+
+    if(!stream_seek(stream, offset, StreamOffsetFromStart)) return false;
+    while(key_size > 0) {
+        size_t size = MIN(key_size, buffer_size);
+        if(stream_read(stream, (uint8_t*)buffer, size) != size) return false;
+        if(memcmp(buffer, key, size) != 0) return false;
+        key += size;
+        key_size -= size;
+    }
+    if(stream_read(stream, (uint8_t*)buffer, 1) != 1) return false;
+
+    return buffer[0] == flipper_format_delimiter;
+}
+
+/**
+ * Move the rw pointer to the first line with the key at or after the current position,
+ * or to the end of the stream if there is no such key.
+ * @return true if index was used, false if the key should be searched in the stream
+ */
+static bool
+    flipper_format_key_index_seek(FlipperFormat* flipper_format, const char* key, size_t* item) {
+    if(!flipper_format->key_index_enabled || flipper_format->strict_mode ||
+       flipper_format->binary) {
+        return false;
+    }
+
+    Stream* stream = flipper_format->stream;
+    // Size check catches most of the changes made through the raw stream
+    if(!flipper_format->key_index_valid ||
+       flipper_format->key_index_stream_size != stream_size(stream)) {
+        if(!flipper_format_key_index_build(flipper_format)) return false;
+    }
+
+    size_t position = stream_tell(stream);
+    uint32_t hash = flipper_format_key_hash(key, strlen(key));
+
+    for(size_t i = 0; i < FlipperFormatKeyIndex_size(flipper_format->key_index); i++) {
+        const FlipperFormatKeyIndexItem* index_item =
+            FlipperFormatKeyIndex_cget(flipper_format->key_index, i);
+        if(index_item->offset < position || index_item->hash != hash) continue;
+
+        if(flipper_format_key_index_check(stream, key, index_item->offset)) {
+            if(item) *item = i;
+            return stream_seek(stream, index_item->offset, StreamOffsetFromStart);
+        } else {
+            // Not a plain "key:" line, let the stream parser deal with it
+            stream_seek(stream, position, StreamOffsetFromStart);
+            return false;
+        }
+    }
+
+    stream_seek(stream, 0, StreamOffsetFromEnd);
+    return true;
+}
+
+// Shift offsets of the lines after the changed one, remove the line if it was deleted
+static void flipper_format_key_index_update(
+    FlipperFormat* flipper_format,
+    size_t item,
+    int32_t size_delta,
+    bool deleted) {
+    FlipperFormatKeyIndexItem deleted_item;
+    size_t offset = FlipperFormatKeyIndex_get(flipper_format->key_index, item)->offset;
+
+    if(deleted) {
+        FlipperFormatKeyIndex_pop_at(&deleted_item, flipper_format->key_index, item);
+    }
+
+    // Items are in file order
+    for(size_t i = item; i < FlipperFormatKeyIndex_size(flipper_format->key_index); i++) {
+        FlipperFormatKeyIndexItem* shifted =
+            FlipperFormatKeyIndex_get(flipper_format->key_index, i);
+        if(shifted->offset > offset) {
+            shifted->offset += size_delta;
+        }
+    }
+}
+
+static bool
+    flipper_format_write_value_line(FlipperFormat* flipper_format, FlipperStreamWriteData* data) {
+    Stream* stream = flipper_format->stream;
+    if(flipper_format->binary) {
+        return flipper_format_binary_write_value(flipper_format->binary, stream, data);
+    }
+
+    bool append = false;
+    size_t position = 0;
+
+    if(flipper_format->key_index_valid) {
+        position = stream_tell(stream);
+        append = (position == stream_size(stream)) &&
+                 (position == flipper_format->key_index_stream_size);
+    }
+
+    bool result = flipper_format_stream_write_value_line(stream, data);
+
+    if(flipper_format->key_index_valid) {
+        if(result && append) {
+            FlipperFormatKeyIndexItem* item =
+                FlipperFormatKeyIndex_push_new(flipper_format->key_index);
+            item->hash = flipper_format_key_hash(data->key, strlen(data->key));
+            item->offset = position;
+            flipper_format->key_index_stream_size = stream_size(stream);
+        } else {
+            flipper_format_key_index_invalidate(flipper_format);
+        }
+    }
+
+    return result;
+}
+
+static size_t flipper_format_value_size(FlipperStreamWriteData* data) {
+    switch(data->type) {
+    case FlipperStreamValueStr:
+        return strlen(data->data) + 1;
+    case FlipperStreamValueHex:
+        return data->data_size * sizeof(uint8_t);
+    case FlipperStreamValueFloat:
+        return data->data_size * sizeof(float);
+    case FlipperStreamValueInt32:
+        return data->data_size * sizeof(int32_t);
+    case FlipperStreamValueUint32:
+        return data->data_size * sizeof(uint32_t);
+    case FlipperStreamValueHexUint64:
+        return data->data_size * sizeof(uint64_t);
+    case FlipperStreamValueBool:
+        return data->data_size * sizeof(bool);
+    default:
+        return 0;
+    }
+}
+
+static void flipper_format_update_queue_add(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* data) {
+    FlipperStreamWriteData* item = NULL;
+
+    for(size_t i = 0; i < FlipperFormatUpdateQueue_size(flipper_format->update_queue); i++) {
+        FlipperStreamWriteData* queued =
+            FlipperFormatUpdateQueue_get(flipper_format->update_queue, i);
+        if(strcmp(queued->key, data->key) == 0) {
+            item = queued;
+            free((void*)item->data);
+            break;
+        }
+    }
+    if(!item) {
+        item = FlipperFormatUpdateQueue_push_new(flipper_format->update_queue);
+        item->key = strdup(data->key);
+    }
+
+    size_t size = flipper_format_value_size(data);
+    void* data_copy = NULL;
+    if(size > 0) {
+        data_copy = malloc(size);
+        memcpy(data_copy, data->data, size);
+    }
+
+    item->type = data->type;
+    item->data = data_copy;
+    item->data_size = data->data_size;
+}
+
+static void flipper_format_update_queue_reset(FlipperFormat* flipper_format) {
+    for(size_t i = 0; i < FlipperFormatUpdateQueue_size(flipper_format->update_queue); i++) {
+        FlipperStreamWriteData* queued =
+            FlipperFormatUpdateQueue_get(flipper_format->update_queue, i);
+        free((void*)queued->key);
+        free((void*)queued->data);
+    }
+    FlipperFormatUpdateQueue_reset(flipper_format->update_queue);
+}
+
+static bool flipper_format_delete_key_and_write(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* data) {
+    if(flipper_format->update_batch) {
+        flipper_format_update_queue_add(flipper_format, data);
+        return true;
+    }
+
+    Stream* stream = flipper_format->stream;
+    size_t item = 0;
+
+    if(!stream_rewind(stream)) return false;
+    if(flipper_format->binary) {
+        return flipper_format_binary_delete_key_and_write(
+            flipper_format->binary, stream, data, flipper_format->strict_mode);
+    }
+
+    bool indexed = flipper_format_key_index_seek(flipper_format, data->key, &item) &&
+                   !stream_eof(stream);
+    size_t size = stream_size(stream);
+
+    bool result =
+        flipper_format_stream_delete_key_and_write(stream, data, flipper_format->strict_mode);
+
+    if(flipper_format->key_index_valid) {
+        if(result && indexed) {
+            int32_t size_delta = (int32_t)stream_size(stream) - (int32_t)size;
+            flipper_format_key_index_update(
+                flipper_format, item, size_delta, data->type == FlipperStreamValueIgnore);
+            flipper_format->key_index_stream_size = stream_size(stream);
+        } else {
+            flipper_format_key_index_invalidate(flipper_format);
+        }
+    }
+
+    return result;
+}
+
+static bool flipper_format_read_value_line(
+    FlipperFormat* flipper_format,
+    const char* key,
+    FlipperStreamValue type,
+    void* data,
+    size_t data_size) {
+    if(flipper_format->binary) {
+        return flipper_format_binary_read_value(
+            flipper_format->binary,
+            flipper_format->stream,
+            key,
+            type,
+            data,
+            data_size,
+            flipper_format->strict_mode);
+    }
+
+    flipper_format_key_index_seek(flipper_format, key, NULL);
+    return flipper_format_stream_read_value_line(
+        flipper_format->stream, key, type, data, data_size, flipper_format->strict_mode);
+}
+
+static void flipper_format_set_container(FlipperFormat* flipper_format, bool binary) {
+    if(flipper_format->binary) {
+        flipper_format_binary_free(flipper_format->binary);
+        flipper_format->binary = NULL;
+    }
+    if(binary) {
+        flipper_format->binary = flipper_format_binary_alloc();
+    }
+}
+
+// Select the container by the magic of the opened file, empty file gets the default one
+static bool flipper_format_open_container(FlipperFormat* flipper_format, bool opened) {
+    Stream* stream = flipper_format->stream;
+    flipper_format_key_index_invalidate(flipper_format);
+
+    if(!opened || stream_size(stream) == 0) {
+        flipper_format_set_container(flipper_format, flipper_format->binary_default);
+    } else if(flipper_format_binary_detect(stream)) {
+        flipper_format_set_container(flipper_format, true);
+        if(!flipper_format_binary_load(flipper_format->binary, stream)) return false;
+    } else {
+        flipper_format_set_container(flipper_format, false);
+    }
+
+    return opened;
+}
+
+/********************************** Public **********************************/
+
+FlipperFormat* flipper_format_string_alloc() {
+    return flipper_format_alloc(string_stream_alloc());
+}
+
 FlipperFormat* flipper_format_file_alloc(Storage* storage) {
-    FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
-    flipper_format->stream = file_stream_alloc(storage);
-    flipper_format->strict_mode = false;
-    return flipper_format;
+    return flipper_format_alloc(file_stream_alloc(storage));
 }
 
 FlipperFormat* flipper_format_buffered_file_alloc(Storage* storage) {
-    FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
-    flipper_format->stream = buffered_file_stream_alloc(storage);
-    flipper_format->strict_mode = false;
-    return flipper_format;
+    return flipper_format_alloc(buffered_file_stream_alloc(storage));
+}
+
+FlipperFormat* flipper_format_buffered_file_alloc_ex(
+    Storage* storage,
+    size_t cache_size,
+    BufferedFileStreamAccess access) {
+    return flipper_format_alloc(buffered_file_stream_alloc_ex(storage, cache_size, access));
 }
 
 bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+    bool result =
+        file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+    return flipper_format_open_container(flipper_format, result);
 }
 
 bool flipper_format_buffered_file_open_existing(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return buffered_file_stream_open(
+    bool result = buffered_file_stream_open(
         flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+    return flipper_format_open_container(flipper_format, result);
 }
 
 bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char* path) {
@@ -60,9 +405,12 @@ bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char*
 
     bool result =
         file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_APPEND);
+    result = flipper_format_open_container(flipper_format, result);
 
-    // Add EOL if it is not there
-    if(stream_size(flipper_format->stream) >= 1) {
+    if(flipper_format->binary) {
+        stream_seek(flipper_format->stream, 0, StreamOffsetFromEnd);
+    } else if(stream_size(flipper_format->stream) >= 1) {
+        // Add EOL if it is not there
         do {
             char last_char;
             result = false;
@@ -88,27 +436,39 @@ bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char*
 
 bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    bool result =
+        file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    return flipper_format_open_container(flipper_format, result);
 }
 
 bool flipper_format_file_open_new(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_NEW);
+    bool result =
+        file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_NEW);
+    return flipper_format_open_container(flipper_format, result);
 }
 
 bool flipper_format_file_close(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
+    flipper_format_key_index_invalidate(flipper_format);
+    flipper_format_set_container(flipper_format, false);
     return file_stream_close(flipper_format->stream);
 }
 
 bool flipper_format_buffered_file_close(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
+    flipper_format_key_index_invalidate(flipper_format);
+    flipper_format_set_container(flipper_format, false);
     return buffered_file_stream_close(flipper_format->stream);
 }
 
 void flipper_format_free(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     stream_free(flipper_format->stream);
+    FlipperFormatKeyIndex_clear(flipper_format->key_index);
+    flipper_format_update_queue_reset(flipper_format);
+    FlipperFormatUpdateQueue_clear(flipper_format->update_queue);
+    flipper_format_set_container(flipper_format, false);
     free(flipper_format);
 }
 
@@ -116,6 +476,22 @@ void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_m
     flipper_format->strict_mode = strict_mode;
 }
 
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enable) {
+    flipper_format->key_index_enabled = enable;
+    flipper_format_key_index_invalidate(flipper_format);
+}
+
+void flipper_format_set_binary(FlipperFormat* flipper_format, bool binary) {
+    flipper_format->binary_default = binary;
+    if(stream_size(flipper_format->stream) == 0) {
+        flipper_format_set_container(flipper_format, binary);
+    }
+}
+
+bool flipper_format_is_binary(FlipperFormat* flipper_format) {
+    return flipper_format->binary != NULL;
+}
+
 bool flipper_format_rewind(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     return stream_rewind(flipper_format->stream);
@@ -129,7 +505,14 @@ bool flipper_format_seek_to_end(FlipperFormat* flipper_format) {
 bool flipper_format_key_exist(FlipperFormat* flipper_format, const char* key) {
     size_t pos = stream_tell(flipper_format->stream);
     stream_seek(flipper_format->stream, 0, StreamOffsetFromStart);
-    bool result = flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
+    bool result;
+    if(flipper_format->binary) {
+        result = flipper_format_binary_seek_to_key(
+            flipper_format->binary, flipper_format->stream, key, false);
+    } else {
+        flipper_format_key_index_seek(flipper_format, key, NULL);
+        result = flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
+    }
     stream_seek(flipper_format->stream, pos, StreamOffsetFromStart);
 
     return result;
@@ -167,14 +550,28 @@ bool flipper_format_get_value_count(
     const char* key,
     uint32_t* count) {
     furi_assert(flipper_format);
-    return flipper_format_stream_get_value_count(
+    if(flipper_format->binary) {
+        return flipper_format_binary_get_value_count(
+            flipper_format->binary,
+            flipper_format->stream,
+            key,
+            count,
+            flipper_format->strict_mode);
+    }
+    size_t position = stream_tell(flipper_format->stream);
+    if(!flipper_format_key_index_seek(flipper_format, key, NULL)) {
+        return flipper_format_stream_get_value_count(
+            flipper_format->stream, key, count, flipper_format->strict_mode);
+    }
+    // Stream restores the position to the found key line, go back to where the search started
+    bool result = flipper_format_stream_get_value_count(
         flipper_format->stream, key, count, flipper_format->strict_mode);
+    return stream_seek(flipper_format->stream, position, StreamOffsetFromStart) && result;
 }
 
 bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, string_t data) {
     furi_assert(flipper_format);
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream, key, FlipperStreamValueStr, data, 1, flipper_format->strict_mode);
+    return flipper_format_read_value_line(flipper_format, key, FlipperStreamValueStr, data, 1);
 }
 
 bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, string_t data) {
@@ -185,7 +582,7 @@ bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key,
         .data = string_get_cstr(data),
         .data_size = 1,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -200,7 +597,7 @@ bool flipper_format_write_string_cstr(
         .data = data,
         .data_size = 1,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -210,13 +607,8 @@ bool flipper_format_read_hex_uint64(
     uint64_t* data,
     const uint16_t data_size) {
     furi_assert(flipper_format);
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueHexUint64,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueHexUint64, data, data_size);
 }
 
 bool flipper_format_write_hex_uint64(
@@ -231,7 +623,7 @@ bool flipper_format_write_hex_uint64(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -241,13 +633,8 @@ bool flipper_format_read_uint32(
     uint32_t* data,
     const uint16_t data_size) {
     furi_assert(flipper_format);
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueUint32,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueUint32, data, data_size);
 }
 
 bool flipper_format_write_uint32(
@@ -262,7 +649,7 @@ bool flipper_format_write_uint32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -271,13 +658,8 @@ bool flipper_format_read_int32(
     const char* key,
     int32_t* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueInt32,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueInt32, data, data_size);
 }
 
 bool flipper_format_write_int32(
@@ -292,7 +674,7 @@ bool flipper_format_write_int32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -301,13 +683,8 @@ bool flipper_format_read_bool(
     const char* key,
     bool* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueBool,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueBool, data, data_size);
 }
 
 bool flipper_format_write_bool(
@@ -322,7 +699,7 @@ bool flipper_format_write_bool(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -331,13 +708,8 @@ bool flipper_format_read_float(
     const char* key,
     float* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueFloat,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueFloat, data, data_size);
 }
 
 bool flipper_format_write_float(
@@ -352,7 +724,7 @@ bool flipper_format_write_float(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -361,13 +733,8 @@ bool flipper_format_read_hex(
     const char* key,
     uint8_t* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueHex,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueHex, data, data_size);
 }
 
 bool flipper_format_write_hex(
@@ -382,7 +749,7 @@ bool flipper_format_write_hex(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -393,6 +760,15 @@ bool flipper_format_write_comment(FlipperFormat* flipper_format, string_t data)
 
 bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char* data) {
     furi_assert(flipper_format);
+    // Comment doesn't add keys, but shifts the following lines
+    if(flipper_format->key_index_valid &&
+       stream_tell(flipper_format->stream) != stream_size(flipper_format->stream)) {
+        flipper_format_key_index_invalidate(flipper_format);
+    }
+    if(flipper_format->binary) {
+        return flipper_format_binary_write_comment_cstr(
+            flipper_format->binary, flipper_format->stream, data);
+    }
     return flipper_format_stream_write_comment_cstr(flipper_format->stream, data);
 }
 
@@ -404,8 +780,48 @@ bool flipper_format_delete_key(FlipperFormat* flipper_format, const char* key) {
         .data = NULL,
         .data_size = 0,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
+    return result;
+}
+
+void flipper_format_update_begin(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    flipper_format_update_queue_reset(flipper_format);
+    flipper_format->update_batch = true;
+}
+
+bool flipper_format_update_commit(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    furi_assert(flipper_format->update_batch);
+    flipper_format->update_batch = false;
+
+    bool result = true;
+    size_t count = FlipperFormatUpdateQueue_size(flipper_format->update_queue);
+    if(count > 0) {
+        if(flipper_format->strict_mode) {
+            // Strict lookup only sees the first key, apply updates one by one
+            for(size_t i = 0; i < count && result; i++) {
+                result = flipper_format_delete_key_and_write(
+                    flipper_format, FlipperFormatUpdateQueue_get(flipper_format->update_queue, i));
+            }
+        } else if(flipper_format->binary) {
+            result = stream_rewind(flipper_format->stream) &&
+                     flipper_format_binary_delete_keys_and_write(
+                         flipper_format->binary,
+                         flipper_format->stream,
+                         FlipperFormatUpdateQueue_get(flipper_format->update_queue, 0),
+                         count);
+        } else {
+            result = stream_rewind(flipper_format->stream) &&
+                     flipper_format_stream_delete_keys_and_write(
+                         flipper_format->stream,
+                         FlipperFormatUpdateQueue_get(flipper_format->update_queue, 0),
+                         count);
+            flipper_format_key_index_invalidate(flipper_format);
+        }
+    }
+
+    flipper_format_update_queue_reset(flipper_format);
     return result;
 }
 
@@ -417,8 +833,7 @@ bool flipper_format_update_string(FlipperFormat* flipper_format, const char* key
         .data = string_get_cstr(data),
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -433,8 +848,7 @@ bool flipper_format_update_string_cstr(
         .data = data,
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -450,8 +864,7 @@ bool flipper_format_update_uint32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -466,8 +879,7 @@ bool flipper_format_update_int32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -482,8 +894,7 @@ bool flipper_format_update_bool(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -498,8 +909,7 @@ bool flipper_format_update_float(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -514,8 +924,7 @@ bool flipper_format_update_hex(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
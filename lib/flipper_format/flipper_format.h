@@ -26,6 +26,12 @@
  * End of line is LF when writing, but CR is supported when reading.
  * 
  * The library is designed in such a way that comments and field values are completely ignored when searching for keys, that is, they do not consume memory.
+ *
+ * The same data can be stored in a binary container (see flipper_format_binary.h): values are
+ * stored as typed records and are read without parsing. Binary files are detected by the magic
+ * on open and are read and updated with the same API. New files are text unless
+ * flipper_format_set_binary is used.
+ * scripts/fff_convert.py converts files between the text and binary forms.
  * 
  * File example: 
  * 
@@ -96,6 +102,7 @@
 #include <stdint.h>
 #include <mlib/m-string.h>
 #include <storage/storage.h>
+#include <toolbox/stream/buffered_file_stream.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -121,6 +128,18 @@ FlipperFormat* flipper_format_file_alloc(Storage* storage);
  */
 FlipperFormat* flipper_format_buffered_file_alloc(Storage* storage);
 
+/**
+ * Allocate FlipperFormat as file, buffered mode with custom cache size and access pattern.
+ * @param storage Storage instance
+ * @param cache_size cache size in bytes
+ * @param access expected access pattern
+ * @return FlipperFormat* pointer to a FlipperFormat instance
+ */
+FlipperFormat* flipper_format_buffered_file_alloc_ex(
+    Storage* storage,
+    size_t cache_size,
+    BufferedFileStreamAccess access);
+
 /**
  * Open existing file. 
  * Use only if FlipperFormat allocated as a file.
@@ -195,6 +214,36 @@ void flipper_format_free(FlipperFormat* flipper_format);
  */
 void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_mode);
 
+/**
+ * Enable key index. On the first lookup the whole file is scanned once and offsets of all keys
+ * are stored, so reads jump directly to the key instead of parsing the file up to it.
+ * Writes through FlipperFormat keep the index up to date. Changes made through the raw stream
+ * are detected by the stream size only: after a same size change enable the index again to
+ * rebuild it. Not used in strict mode and for binary files.
+ * Disabled by default.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param enable True to enable key index
+ */
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enable);
+
+/**
+ * Select the format of new files: binary container or text.
+ * Applied to files created or opened empty after the call, and to the current stream
+ * if it is empty.
+ * Existing files keep their format.
+ * Text by default.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param binary True to write new files as binary container
+ */
+void flipper_format_set_binary(FlipperFormat* flipper_format, bool binary);
+
+/**
+ * Check the format of the current file.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return True if the file is a binary container
+ */
+bool flipper_format_is_binary(FlipperFormat* flipper_format);
+
 /**
  * Rewind the RW pointer.
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -488,6 +537,24 @@ bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char
  */
 bool flipper_format_delete_key(FlipperFormat* flipper_format, const char* key);
 
+/**
+ * Start a batch update. Update and delete calls after it are queued and return true,
+ * the data is copied, so it may be freed right after the call. Reads return the data before
+ * the batch update. Repeated updates of the same key replace the queued one.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ */
+void flipper_format_update_begin(FlipperFormat* flipper_format);
+
+/**
+ * Apply all queued updates in a single pass over the file. Data between the updated keys is
+ * moved at most once, and is not moved at all if the new values have the same size.
+ * Nothing is changed if any of the keys is missing.
+ * Sets the RW pointer to a position at the end of the last inserted data.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return True on success
+ */
+bool flipper_format_update_commit(FlipperFormat* flipper_format);
+
 /**
  * Updates the value of the first matching key to a string value. Sets the RW pointer to a position at the end of inserted data.
  * @param flipper_format Pointer to a FlipperFormat instance 
@@ -0,0 +1,621 @@
+#include <core/check.h>
+#include <m-array.h>
+#include <toolbox/stream/string_stream.h>
+#include "flipper_format_binary.h"
+
+#define FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE 5
+// Value tags are part of the file format and must not follow FlipperStreamValue changes
+#define FLIPPER_FORMAT_BINARY_TAG_STR 0x01
+#define FLIPPER_FORMAT_BINARY_TAG_HEX 0x02
+#define FLIPPER_FORMAT_BINARY_TAG_FLOAT 0x03
+#define FLIPPER_FORMAT_BINARY_TAG_INT32 0x04
+#define FLIPPER_FORMAT_BINARY_TAG_UINT32 0x05
+#define FLIPPER_FORMAT_BINARY_TAG_HEX_UINT64 0x06
+#define FLIPPER_FORMAT_BINARY_TAG_BOOL 0x07
+#define FLIPPER_FORMAT_BINARY_TAG_KEY 0xF0
+#define FLIPPER_FORMAT_BINARY_TAG_COMMENT 0xF1
+
+static const uint8_t flipper_format_binary_magic[] = {0xFF, 'F', 'F', 'B', 0x01};
+
+ARRAY_DEF(FlipperFormatBinaryKeys, string_t, STRING_OPLIST)
+
+struct FlipperFormatBinary {
+    // Key names, indexed by key id
+    FlipperFormatBinaryKeys_t keys;
+};
+
+typedef struct {
+    uint8_t tag;
+    uint16_t key_id;
+    uint16_t size;
+} FlipperFormatBinaryRecord;
+
+typedef struct {
+    FlipperFormatBinary* instance;
+    FlipperStreamWriteData* write_data;
+} FlipperFormatBinaryWriteContext;
+
+static bool flipper_format_binary_write(Stream* stream, const void* data, size_t data_size) {
+    size_t bytes_written = stream_write(stream, data, data_size);
+    return bytes_written == data_size;
+}
+
+// New container starts with the magic
+static bool flipper_format_binary_start(Stream* stream) {
+    return stream_size(stream) != 0 ||
+           flipper_format_binary_write(
+               stream, flipper_format_binary_magic, sizeof(flipper_format_binary_magic));
+}
+
+static bool flipper_format_binary_read_record(Stream* stream, FlipperFormatBinaryRecord* record) {
+    uint8_t header[FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE];
+    if(stream_read(stream, header, sizeof(header)) != sizeof(header)) return false;
+
+    record->tag = header[0];
+    record->key_id = header[1] | (header[2] << 8);
+    record->size = header[3] | (header[4] << 8);
+    return true;
+}
+
+static bool flipper_format_binary_write_record(
+    Stream* stream,
+    const FlipperFormatBinaryRecord* record,
+    const void* payload) {
+    uint8_t header[FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE] = {
+        record->tag,
+        record->key_id & 0xFF,
+        record->key_id >> 8,
+        record->size & 0xFF,
+        record->size >> 8,
+    };
+
+    return flipper_format_binary_write(stream, header, sizeof(header)) &&
+           flipper_format_binary_write(stream, payload, record->size);
+}
+
+static uint8_t flipper_format_binary_tag_from_type(FlipperStreamValue type) {
+    switch(type) {
+    case FlipperStreamValueStr:
+        return FLIPPER_FORMAT_BINARY_TAG_STR;
+    case FlipperStreamValueHex:
+        return FLIPPER_FORMAT_BINARY_TAG_HEX;
+    case FlipperStreamValueFloat:
+        return FLIPPER_FORMAT_BINARY_TAG_FLOAT;
+    case FlipperStreamValueInt32:
+        return FLIPPER_FORMAT_BINARY_TAG_INT32;
+    case FlipperStreamValueUint32:
+        return FLIPPER_FORMAT_BINARY_TAG_UINT32;
+    case FlipperStreamValueHexUint64:
+        return FLIPPER_FORMAT_BINARY_TAG_HEX_UINT64;
+    case FlipperStreamValueBool:
+        return FLIPPER_FORMAT_BINARY_TAG_BOOL;
+    default:
+        furi_crash("Unknown FF type");
+    }
+}
+
+// FlipperStreamValueIgnore for key definitions, comments and unknown tags
+static FlipperStreamValue flipper_format_binary_type_from_tag(uint8_t tag) {
+    switch(tag) {
+    case FLIPPER_FORMAT_BINARY_TAG_STR:
+        return FlipperStreamValueStr;
+    case FLIPPER_FORMAT_BINARY_TAG_HEX:
+        return FlipperStreamValueHex;
+    case FLIPPER_FORMAT_BINARY_TAG_FLOAT:
+        return FlipperStreamValueFloat;
+    case FLIPPER_FORMAT_BINARY_TAG_INT32:
+        return FlipperStreamValueInt32;
+    case FLIPPER_FORMAT_BINARY_TAG_UINT32:
+        return FlipperStreamValueUint32;
+    case FLIPPER_FORMAT_BINARY_TAG_HEX_UINT64:
+        return FlipperStreamValueHexUint64;
+    case FLIPPER_FORMAT_BINARY_TAG_BOOL:
+        return FlipperStreamValueBool;
+    default:
+        return FlipperStreamValueIgnore;
+    }
+}
+
+static bool flipper_format_binary_is_value(uint8_t tag) {
+    return flipper_format_binary_type_from_tag(tag) != FlipperStreamValueIgnore;
+}
+
+static size_t flipper_format_binary_value_size(FlipperStreamValue type) {
+    switch(type) {
+    case FlipperStreamValueStr:
+    case FlipperStreamValueHex:
+    case FlipperStreamValueBool:
+        return 1;
+    case FlipperStreamValueFloat:
+    case FlipperStreamValueInt32:
+    case FlipperStreamValueUint32:
+        return 4;
+    case FlipperStreamValueHexUint64:
+        return 8;
+    default:
+        furi_crash("Unknown FF type");
+    }
+}
+
+// Int32 and Uint32 values have the same representation, both in text and in binary
+static bool flipper_format_binary_is_compatible(FlipperStreamValue a, FlipperStreamValue b) {
+    if(a == b) return true;
+    return (a == FlipperStreamValueInt32 || a == FlipperStreamValueUint32) &&
+           (b == FlipperStreamValueInt32 || b == FlipperStreamValueUint32);
+}
+
+static bool flipper_format_binary_find_key(
+    FlipperFormatBinary* instance,
+    const char* key,
+    uint16_t* key_id) {
+    for(size_t i = 0; i < FlipperFormatBinaryKeys_size(instance->keys); i++) {
+        if(string_cmp_str(*FlipperFormatBinaryKeys_cget(instance->keys, i), key) == 0) {
+            *key_id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Move the rw pointer to the payload of the first value record with the key
+static bool flipper_format_binary_seek_to_record(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    FlipperFormatBinaryRecord* record,
+    bool strict_mode) {
+    uint16_t key_id;
+    if(!flipper_format_binary_find_key(instance, key, &key_id)) {
+        stream_seek(stream, 0, StreamOffsetFromEnd);
+        return false;
+    }
+
+    if(stream_tell(stream) < sizeof(flipper_format_binary_magic)) {
+        if(!stream_seek(stream, sizeof(flipper_format_binary_magic), StreamOffsetFromStart)) {
+            return false;
+        }
+    }
+
+    while(flipper_format_binary_read_record(stream, record)) {
+        if(flipper_format_binary_is_value(record->tag)) {
+            if(record->key_id == key_id) return true;
+            if(strict_mode) {
+                // Stay at the record boundary
+                stream_seek(
+                    stream,
+                    -(int32_t)FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE,
+                    StreamOffsetFromCurrent);
+                return false;
+            }
+        }
+        if(!stream_seek(stream, record->size, StreamOffsetFromCurrent)) break;
+    }
+
+    return false;
+}
+
+static bool flipper_format_binary_read_string(Stream* stream, size_t size, string_t data) {
+    const size_t buffer_size = 32;
+    uint8_t buffer[buffer_size];
+
+    string_reset(data);
+    while(size > 0) {
+        size_t chunk_size = MIN(size, buffer_size);
+        if(stream_read(stream, buffer, chunk_size) != chunk_size) return false;
+        stream_string_cat_data(data, buffer, chunk_size);
+        size -= chunk_size;
+    }
+    return true;
+}
+
+/**
+ * Render the record as a text line and parse it with the text parser,
+ * so values of another type are read exactly as from the text file
+ */
+static bool flipper_format_binary_read_converted(
+    Stream* stream,
+    const FlipperFormatBinaryRecord* record,
+    const char* key,
+    FlipperStreamValue type,
+    void* _data,
+    size_t data_size,
+    uint32_t* count) {
+    FlipperStreamValue record_type = flipper_format_binary_type_from_tag(record->tag);
+#ifdef FLIPPER_STREAM_LITE
+    if(record_type == FlipperStreamValueFloat) return false;
+#endif
+    bool result = false;
+    // Room for the string terminator
+    uint8_t* payload = malloc(record->size + 1);
+    Stream* text_stream = string_stream_alloc();
+
+    do {
+        if(stream_read(stream, payload, record->size) != record->size) break;
+        payload[record->size] = 0;
+
+        FlipperStreamWriteData write_data = {
+            .key = key,
+            .type = record_type,
+            .data = payload,
+            .data_size = record->size / flipper_format_binary_value_size(record_type),
+        };
+        if(!flipper_format_stream_write_value_line(text_stream, &write_data)) break;
+        if(!stream_rewind(text_stream)) break;
+
+        if(count) {
+            result = flipper_format_stream_get_value_count(text_stream, key, count, true);
+        } else {
+            result = flipper_format_stream_read_value_line(
+                text_stream, key, type, _data, data_size, true);
+        }
+    } while(false);
+
+    stream_free(text_stream);
+    free(payload);
+
+    return result;
+}
+
+static bool flipper_format_binary_write_value_record(Stream* stream, const void* context) {
+    const FlipperFormatBinaryWriteContext* write_context = context;
+    FlipperStreamWriteData* write_data = write_context->write_data;
+
+    if(write_data->type == FlipperStreamValueIgnore) return true;
+
+    size_t size;
+    if(write_data->type == FlipperStreamValueStr) {
+        size = strlen(write_data->data);
+    } else {
+        size = write_data->data_size * flipper_format_binary_value_size(write_data->type);
+    }
+    if(size > UINT16_MAX) return false;
+
+    uint16_t key_id;
+    if(!flipper_format_binary_find_key(write_context->instance, write_data->key, &key_id)) {
+        return false;
+    }
+
+    FlipperFormatBinaryRecord record = {
+        .tag = flipper_format_binary_tag_from_type(write_data->type),
+        .key_id = key_id,
+        .size = size,
+    };
+    return flipper_format_binary_write_record(stream, &record, write_data->data);
+}
+
+static bool flipper_format_binary_add_key(
+    FlipperFormatBinary* instance,
+    const char* key,
+    uint16_t key_id) {
+    if(key_id != FlipperFormatBinaryKeys_size(instance->keys)) return false;
+
+    string_t* name = FlipperFormatBinaryKeys_push_new(instance->keys);
+    string_set_str(*name, key);
+    return true;
+}
+
+FlipperFormatBinary* flipper_format_binary_alloc() {
+    FlipperFormatBinary* instance = malloc(sizeof(FlipperFormatBinary));
+    FlipperFormatBinaryKeys_init(instance->keys);
+    return instance;
+}
+
+void flipper_format_binary_free(FlipperFormatBinary* instance) {
+    furi_assert(instance);
+    FlipperFormatBinaryKeys_clear(instance->keys);
+    free(instance);
+}
+
+bool flipper_format_binary_detect(Stream* stream) {
+    uint8_t magic[sizeof(flipper_format_binary_magic)];
+    size_t position = stream_tell(stream);
+
+    bool result = stream_rewind(stream) &&
+                  stream_read(stream, magic, sizeof(magic)) == sizeof(magic) &&
+                  memcmp(magic, flipper_format_binary_magic, sizeof(magic)) == 0;
+
+    stream_seek(stream, position, StreamOffsetFromStart);
+    return result;
+}
+
+bool flipper_format_binary_load(FlipperFormatBinary* instance, Stream* stream) {
+    bool result = false;
+    size_t position = stream_tell(stream);
+    FlipperFormatBinaryRecord record;
+    string_t key;
+    string_init(key);
+
+    FlipperFormatBinaryKeys_reset(instance->keys);
+    do {
+        if(!flipper_format_binary_detect(stream)) break;
+        if(!stream_seek(stream, sizeof(flipper_format_binary_magic), StreamOffsetFromStart)) {
+            break;
+        }
+
+        result = true;
+        while(flipper_format_binary_read_record(stream, &record)) {
+            if(record.tag == FLIPPER_FORMAT_BINARY_TAG_KEY) {
+                result = flipper_format_binary_read_string(stream, record.size, key) &&
+                         flipper_format_binary_add_key(
+                             instance, string_get_cstr(key), record.key_id);
+            } else if(
+                flipper_format_binary_is_value(record.tag) ||
+                record.tag == FLIPPER_FORMAT_BINARY_TAG_COMMENT) {
+                result = stream_seek(stream, record.size, StreamOffsetFromCurrent);
+            } else {
+                result = false;
+            }
+            if(!result) break;
+        }
+        // Truncated record
+        if(result && !stream_eof(stream)) result = false;
+    } while(false);
+
+    string_clear(key);
+    stream_seek(stream, position, StreamOffsetFromStart);
+
+    return result;
+}
+
+bool flipper_format_binary_write_value(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data) {
+    furi_assert(instance);
+    bool result = false;
+
+    do {
+        if(write_data->type == FlipperStreamValueIgnore) {
+            result = true;
+            break;
+        }
+
+        if(!flipper_format_binary_start(stream)) break;
+
+        uint16_t key_id;
+        if(!flipper_format_binary_find_key(instance, write_data->key, &key_id)) {
+            size_t key_size = strlen(write_data->key);
+            size_t keys_count = FlipperFormatBinaryKeys_size(instance->keys);
+            if(key_size > UINT16_MAX || keys_count > UINT16_MAX) break;
+
+            FlipperFormatBinaryRecord record = {
+                .tag = FLIPPER_FORMAT_BINARY_TAG_KEY,
+                .key_id = keys_count,
+                .size = key_size,
+            };
+            if(!flipper_format_binary_write_record(stream, &record, write_data->key)) break;
+            flipper_format_binary_add_key(instance, write_data->key, keys_count);
+        }
+
+        FlipperFormatBinaryWriteContext write_context = {
+            .instance = instance,
+            .write_data = write_data,
+        };
+        result = flipper_format_binary_write_value_record(stream, &write_context);
+    } while(false);
+
+    return result;
+}
+
+bool flipper_format_binary_read_value(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    FlipperStreamValue type,
+    void* _data,
+    size_t data_size,
+    bool strict_mode) {
+    furi_assert(instance);
+    bool result = false;
+    FlipperFormatBinaryRecord record;
+
+    do {
+        if(!flipper_format_binary_seek_to_record(instance, stream, key, &record, strict_mode)) {
+            break;
+        }
+        size_t record_end = stream_tell(stream) + record.size;
+
+        FlipperStreamValue record_type = flipper_format_binary_type_from_tag(record.tag);
+        if(!flipper_format_binary_is_compatible(record_type, type)) {
+            result = flipper_format_binary_read_converted(
+                stream, &record, key, type, _data, data_size, NULL);
+        } else if(type == FlipperStreamValueStr) {
+            // Empty string is not a valid value, same as in text
+            result = flipper_format_binary_read_string(stream, record.size, _data) &&
+                     record.size > 0;
+        } else {
+            size_t size = data_size * flipper_format_binary_value_size(type);
+            if(size <= record.size && stream_read(stream, _data, size) == size) {
+                if(type == FlipperStreamValueBool) {
+                    uint8_t* data = _data;
+                    for(size_t i = 0; i < data_size; i++) {
+                        data[i] = (data[i] != 0);
+                    }
+                }
+                result = true;
+            }
+        }
+
+        // Leave the rw pointer at the next record, even if the value is not valid
+        if(!stream_seek(stream, record_end, StreamOffsetFromStart)) result = false;
+    } while(false);
+
+    return result;
+}
+
+bool flipper_format_binary_get_value_count(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    uint32_t* count,
+    bool strict_mode) {
+    furi_assert(instance);
+    bool result = false;
+    FlipperFormatBinaryRecord record;
+
+    size_t position = stream_tell(stream);
+    do {
+        if(!flipper_format_binary_seek_to_record(instance, stream, key, &record, strict_mode)) {
+            break;
+        }
+
+        FlipperStreamValue record_type = flipper_format_binary_type_from_tag(record.tag);
+        if(record_type == FlipperStreamValueStr) {
+            // Text values are counted by words
+            result = flipper_format_binary_read_converted(
+                stream, &record, key, FlipperStreamValueStr, NULL, 0, count);
+        } else {
+            *count = record.size / flipper_format_binary_value_size(record_type);
+            result = true;
+        }
+    } while(false);
+
+    if(!stream_seek(stream, position, StreamOffsetFromStart)) {
+        result = false;
+    }
+
+    return result;
+}
+
+bool flipper_format_binary_seek_to_key(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    bool strict_mode) {
+    furi_assert(instance);
+    FlipperFormatBinaryRecord record;
+    return flipper_format_binary_seek_to_record(instance, stream, key, &record, strict_mode);
+}
+
+bool flipper_format_binary_delete_key_and_write(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    bool strict_mode) {
+    furi_assert(instance);
+    bool result = false;
+    FlipperFormatBinaryRecord record;
+
+    do {
+        if(!flipper_format_binary_seek_to_record(
+               instance, stream, write_data->key, &record, strict_mode))
+            break;
+
+        size_t delete_size = FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE + record.size;
+        if(!stream_seek(
+               stream,
+               -(int32_t)FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE,
+               StreamOffsetFromCurrent))
+            break;
+
+        FlipperFormatBinaryWriteContext write_context = {
+            .instance = instance,
+            .write_data = write_data,
+        };
+        if(!stream_delete_and_insert(
+               stream, delete_size, flipper_format_binary_write_value_record, &write_context))
+            break;
+
+        result = true;
+    } while(false);
+
+    return result;
+}
+
+bool flipper_format_binary_delete_keys_and_write(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    size_t count) {
+    furi_assert(instance);
+    bool result = false;
+    size_t found_count = 0;
+    StreamEdit* edits = malloc(sizeof(StreamEdit) * count);
+    FlipperFormatBinaryWriteContext* contexts =
+        malloc(sizeof(FlipperFormatBinaryWriteContext) * count);
+    uint16_t* key_ids = malloc(sizeof(uint16_t) * count);
+    bool* found = malloc(sizeof(bool) * count);
+    memset(found, 0, sizeof(bool) * count);
+
+    do {
+        bool error = false;
+        for(size_t i = 0; i < count; i++) {
+            if(!flipper_format_binary_find_key(instance, write_data[i].key, &key_ids[i])) {
+                error = true;
+                break;
+            }
+        }
+        if(error) {
+            // Same as if the key was searched through the whole stream
+            stream_seek(stream, 0, StreamOffsetFromEnd);
+            break;
+        }
+
+        if(stream_tell(stream) < sizeof(flipper_format_binary_magic)) {
+            if(!stream_seek(stream, sizeof(flipper_format_binary_magic), StreamOffsetFromStart))
+                break;
+        }
+
+        // Records are found in the stream order, so edits are sorted by offset
+        FlipperFormatBinaryRecord record;
+        while(found_count < count && flipper_format_binary_read_record(stream, &record)) {
+            size_t i = count;
+            if(flipper_format_binary_is_value(record.tag)) {
+                for(i = 0; i < count; i++) {
+                    if(!found[i] && key_ids[i] == record.key_id) break;
+                }
+            }
+
+            if(i < count) {
+                found[i] = true;
+                contexts[i].instance = instance;
+                contexts[i].write_data = &write_data[i];
+                edits[found_count].offset =
+                    stream_tell(stream) - FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE;
+                edits[found_count].delete_size =
+                    FLIPPER_FORMAT_BINARY_RECORD_HEADER_SIZE + record.size;
+                edits[found_count].write_callback = flipper_format_binary_write_value_record;
+                edits[found_count].context = &contexts[i];
+                found_count++;
+            }
+
+            if(!stream_seek(stream, record.size, StreamOffsetFromCurrent)) break;
+        }
+        if(found_count != count) break;
+
+        if(!stream_delete_and_insert_batch(stream, edits, count)) break;
+
+        result = true;
+    } while(false);
+
+    free(found);
+    free(key_ids);
+    free(contexts);
+    free(edits);
+
+    return result;
+}
+
+bool flipper_format_binary_write_comment_cstr(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* data) {
+    furi_assert(instance);
+    bool result = false;
+
+    do {
+        size_t size = strlen(data);
+        if(size > UINT16_MAX) break;
+
+        if(!flipper_format_binary_start(stream)) break;
+
+        FlipperFormatBinaryRecord record = {
+            .tag = FLIPPER_FORMAT_BINARY_TAG_COMMENT,
+            .key_id = 0,
+            .size = size,
+        };
+        result = flipper_format_binary_write_record(stream, &record, data);
+    } while(false);
+
+    return result;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file flipper_format_binary.h
+ * Binary container for Flipper Format.
+ *
+ * File starts with the magic, followed by records. Every record has the same header:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * uint8_t  tag      value type, 0xF0 for key definitions, 0xF1 for comments
+ * uint16_t key_id   key of the value, id of the defined key, 0 for comments
+ * uint16_t size     payload size in bytes
+ * ~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Value types: 0x01 string, 0x02 Hex, 0x03 Float, 0x04 Int32, 0x05 Uint32, 0x06 HexUint64,
+ * 0x07 Bool.
+ *
+ * Key definition payload is the key name, comment payload is the comment text.
+ * Value payload is the array of values: 1 byte for Hex and Bool, 4 bytes for Int32, Uint32
+ * and Float, 8 bytes for HexUint64, string value is stored without the terminating null.
+ * Multibyte fields are little-endian.
+ *
+ * Keys are defined once, before the first value with the key, and values refer to keys by id,
+ * so key lookup compares ids instead of strings and values are copied without parsing.
+ */
+#pragma once
+#include <stdlib.h>
+#include <stdbool.h>
+#include <toolbox/stream/stream.h>
+#include "flipper_format_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FlipperFormatBinary FlipperFormatBinary;
+
+/**
+ * Allocate binary container state, with an empty key dictionary.
+ * @return FlipperFormatBinary*
+ */
+FlipperFormatBinary* flipper_format_binary_alloc();
+
+/**
+ * Free binary container state.
+ * @param instance
+ */
+void flipper_format_binary_free(FlipperFormatBinary* instance);
+
+/**
+ * Check the binary container magic at the start of the stream.
+ * Position of the stream is restored.
+ * @param stream
+ * @return true stream is a binary container
+ * @return false
+ */
+bool flipper_format_binary_detect(Stream* stream);
+
+/**
+ * Load the key dictionary from the stream. Position of the stream is restored.
+ * @param instance
+ * @param stream
+ * @return true
+ * @return false stream is not a valid binary container
+ */
+bool flipper_format_binary_load(FlipperFormatBinary* instance, Stream* stream);
+
+/**
+ * Writes a value record to the stream, the magic and the key definition are written first
+ * if needed.
+ * @param instance
+ * @param stream
+ * @param write_data
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_write_value(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data);
+
+/**
+ * Reads a value by key from the stream. Values stored with another type are converted
+ * the same way as text values are.
+ * @param instance
+ * @param stream
+ * @param key
+ * @param type
+ * @param _data
+ * @param data_size
+ * @param strict_mode
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_read_value(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    FlipperStreamValue type,
+    void* _data,
+    size_t data_size,
+    bool strict_mode);
+
+/**
+ * Get the count of values by key from the stream. Position of the stream is restored.
+ * @param instance
+ * @param stream
+ * @param key
+ * @param count
+ * @param strict_mode
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_get_value_count(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    uint32_t* count,
+    bool strict_mode);
+
+/**
+ * Seek to the value record with the key from the current position of the stream.
+ * @param instance
+ * @param stream
+ * @param key
+ * @param strict_mode
+ * @return true key is found
+ * @return false key is not found
+ */
+bool flipper_format_binary_seek_to_key(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* key,
+    bool strict_mode);
+
+/**
+ * Replaces the value record of the key with a new one, or removes it for FlipperStreamValueIgnore.
+ * The key is searched from the current position of the stream.
+ * @param instance
+ * @param stream
+ * @param write_data
+ * @param strict_mode
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_delete_key_and_write(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    bool strict_mode);
+
+/**
+ * Replaces value records of several keys with new ones in a single pass over the stream.
+ * For every key the first record from the current position of the stream is replaced.
+ * Keys must be unique, nothing is changed if any of them is not found.
+ * @param instance
+ * @param stream
+ * @param write_data array of new key/value pairs
+ * @param count array size
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_delete_keys_and_write(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    size_t count);
+
+/**
+ * Writes a comment record to the stream.
+ * @param instance
+ * @param stream
+ * @param data
+ * @return true
+ * @return false
+ */
+bool flipper_format_binary_write_comment_cstr(
+    FlipperFormatBinary* instance,
+    Stream* stream,
+    const char* data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,10 +26,38 @@ bool flipper_format_stream_write_eol(Stream* stream) {
     return flipper_format_stream_write(stream, &flipper_format_eoln, 1);
 }
 
+// Get next chunk of data, from stream buffer without copying if possible
+static size_t flipper_format_stream_get_chunk(
+    Stream* stream,
+    uint8_t* buffer,
+    size_t buffer_size,
+    const uint8_t** chunk,
+    bool* peeked) {
+    size_t size = stream_peek(stream, chunk);
+    *peeked = (size > 0);
+    if(!*peeked) {
+        size = stream_read(stream, buffer, buffer_size);
+        *chunk = buffer;
+    }
+    return size;
+}
+
+// Move the rw pointer to the given position of the last chunk
+static bool flipper_format_stream_set_chunk_position(
+    Stream* stream,
+    size_t chunk_size,
+    size_t position,
+    bool peeked) {
+    int32_t offset = peeked ? (int32_t)position : (int32_t)position - (int32_t)chunk_size;
+    return (offset == 0) || stream_seek(stream, offset, StreamOffsetFromCurrent);
+}
+
 static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
     string_reset(key);
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    const uint8_t* chunk;
+    bool peeked;
 
     bool found = false;
     bool error = false;
@@ -37,11 +65,28 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
     bool new_line = true;
 
     while(true) {
-        size_t was_read = stream_read(stream, buffer, buffer_size);
+        size_t was_read =
+            flipper_format_stream_get_chunk(stream, buffer, buffer_size, &chunk, &peeked);
         if(was_read == 0) break;
 
-        for(size_t i = 0; i < was_read; i++) {
-            uint8_t data = buffer[i];
+        // Key symbols are appended by spans, not one by one
+        size_t span_start = 0;
+        size_t i;
+        for(i = 0; i < was_read; i++) {
+            uint8_t data = chunk[i];
+            bool is_special = data == flipper_format_eoln || data == flipper_format_eolr ||
+                              data == flipper_format_delimiter ||
+                              (data == flipper_format_comment && new_line);
+            if(!is_special) {
+                // just new symbol, reset the new_line flag
+                new_line = false;
+                continue;
+            }
+            if(accumulate) {
+                stream_string_cat_data(key, &chunk[span_start], i - span_start);
+            }
+            span_start = i + 1;
+
             if(data == flipper_format_eoln) {
                 // EOL found, clean data, start accumulating data and set the new_line flag
                 string_reset(key);
@@ -49,48 +94,40 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
                 new_line = true;
             } else if(data == flipper_format_eolr) {
                 // ignore
-            } else if(data == flipper_format_comment && new_line) {
+            } else if(data == flipper_format_comment) {
                 // if there is a comment character and we are at the beginning of a new line
                 // do not accumulate comment data and reset the new_line flag
                 accumulate = false;
                 new_line = false;
-            } else if(data == flipper_format_delimiter) {
-                if(new_line) {
-                    // we are on a "new line" and found the delimiter
-                    // this can only be if we have previously found some kind of key, so
-                    // clear the data, set the flag that we no longer want to accumulate data
-                    // and reset the new_line flag
-                    string_reset(key);
-                    accumulate = false;
-                    new_line = false;
-                } else {
-                    // parse the delimiter only if we are accumulating data
-                    if(accumulate) {
-                        // we found the delimiter, move the rw pointer to the delimiter location
-                        // and signal that we have found something
-                        if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                            error = true;
-                            break;
-                        }
-
-                        found = true;
-                        break;
-                    }
-                }
-            } else {
-                // just new symbol, reset the new_line flag
+            } else if(new_line) {
+                // we are on a "new line" and found the delimiter
+                // this can only be if we have previously found some kind of key, so
+                // clear the data, set the flag that we no longer want to accumulate data
+                // and reset the new_line flag
+                string_reset(key);
+                accumulate = false;
                 new_line = false;
-                if(accumulate) {
-                    // and accumulate data if we want
-                    string_push_back(key, data);
-                }
+            } else if(accumulate) {
+                // we found the delimiter, move the rw pointer to the delimiter location
+                // and signal that we have found something
+                found = true;
+                break;
             }
         }
 
+        if(found) {
+            error = !flipper_format_stream_set_chunk_position(stream, was_read, i, peeked);
+        } else {
+            if(accumulate) {
+                stream_string_cat_data(key, &chunk[span_start], was_read - span_start);
+            }
+            error = !flipper_format_stream_set_chunk_position(stream, was_read, was_read, peeked);
+        }
+
         if(found || error) break;
     }
 
-    return found;
+    return found && !error;
 }
 
 bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode) {
@@ -117,97 +154,117 @@ bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool str
     return found;
 }
 
+void flipper_format_stream_for_each_key(
+    Stream* stream,
+    FlipperStreamKeyCallback callback,
+    void* context) {
+    string_t read_key;
+    string_init(read_key);
+
+    while(!stream_eof(stream)) {
+        if(flipper_format_stream_read_valid_key(stream, read_key)) {
+            // rw pointer is at the delimiter, key starts the line
+            callback(read_key, stream_tell(stream) - string_size(read_key), context);
+        }
+    }
+
+    string_clear(read_key);
+}
+
 static bool flipper_format_stream_read_value(Stream* stream, string_t value, bool* last) {
     string_reset(value);
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    const uint8_t* chunk;
+    bool peeked;
     bool result = false;
     bool error = false;
 
     while(true) {
-        size_t was_read = stream_read(stream, buffer, buffer_size);
+        size_t was_read =
+            flipper_format_stream_get_chunk(stream, buffer, buffer_size, &chunk, &peeked);
 
         if(was_read == 0) {
             // check EOF
             if(stream_eof(stream) && string_size(value) > 0) {
                 result = true;
                 *last = true;
-                break;
             }
+            break;
         }
 
-        for(uint16_t i = 0; i < was_read; i++) {
-            uint8_t data = buffer[i];
+        // Value symbols are appended by spans, not one by one
+        size_t span_start = 0;
+        size_t i;
+        for(i = 0; i < was_read; i++) {
+            uint8_t data = chunk[i];
+            if(data != flipper_format_eoln && data != ' ' && data != flipper_format_eolr) {
+                continue;
+            }
+            stream_string_cat_data(value, &chunk[span_start], i - span_start);
+            span_start = i + 1;
+
             if(data == flipper_format_eoln) {
                 if(string_size(value) > 0) {
-                    if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                        error = true;
-                        break;
-                    }
-
                     result = true;
                     *last = true;
-                    break;
                 } else {
                     error = true;
                 }
+                break;
             } else if(data == ' ') {
                 if(string_size(value) > 0) {
-                    if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                        error = true;
-                        break;
-                    }
-
                     result = true;
                     *last = false;
                     break;
                 }
-
-            } else if(data == flipper_format_eolr) {
-                // Ignore
             } else {
-                string_push_back(value, data);
+                // Ignore
             }
         }
 
+        if(result) {
+            // leave the rw pointer at the value terminator
+            error = !flipper_format_stream_set_chunk_position(stream, was_read, i, peeked);
+        } else {
+            stream_string_cat_data(value, &chunk[span_start], i - span_start);
+            size_t position = (i < was_read) ? i + 1 : was_read;
+            error |= !flipper_format_stream_set_chunk_position(stream, was_read, position, peeked);
+        }
+
         if(error || result) break;
     }
 
-    return result;
+    return result && !error;
 }
 
 static bool flipper_format_stream_read_line(Stream* stream, string_t str_result) {
     string_reset(str_result);
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    const uint8_t* chunk;
+    bool peeked;
 
     do {
-        size_t was_read = stream_read(stream, buffer, buffer_size);
+        size_t was_read =
+            flipper_format_stream_get_chunk(stream, buffer, buffer_size, &chunk, &peeked);
         if(was_read == 0) break;
 
-        bool result = false;
-        bool error = false;
-
-        for(size_t i = 0; i < was_read; i++) {
-            uint8_t data = buffer[i];
-            if(data == flipper_format_eoln) {
-                if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                    error = true;
-                    break;
-                }
+        const uint8_t* eol = memchr(chunk, flipper_format_eoln, was_read);
+        size_t line_size = eol ? (size_t)(eol - chunk) : was_read;
 
-                result = true;
-                break;
-            } else if(data == flipper_format_eolr) {
-                // Ignore
-            } else {
-                string_push_back(str_result, data);
+        // Append line by spans between ignored CR symbols
+        size_t span_start = 0;
+        for(size_t i = 0; i <= line_size; i++) {
+            if(i == line_size || chunk[i] == flipper_format_eolr) {
+                stream_string_cat_data(str_result, &chunk[span_start], i - span_start);
+                span_start = i + 1;
             }
         }
 
-        if(result || error) {
-            break;
-        }
+        // leave the rw pointer at EOL
+        if(!flipper_format_stream_set_chunk_position(stream, was_read, line_size, peeked)) break;
+        if(eol) break;
     } while(true);
 
     return string_size(str_result) != 0;
@@ -216,31 +273,23 @@ static bool flipper_format_stream_read_line(Stream* stream, string_t str_result)
 static bool flipper_format_stream_seek_to_next_line(Stream* stream) {
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    const uint8_t* chunk;
+    bool peeked;
     bool result = false;
-    bool error = false;
 
     do {
-        size_t was_read = stream_read(stream, buffer, buffer_size);
+        size_t was_read =
+            flipper_format_stream_get_chunk(stream, buffer, buffer_size, &chunk, &peeked);
         if(was_read == 0) {
-            if(stream_eof(stream)) {
-                result = true;
-                break;
-            }
-        }
-
-        for(size_t i = 0; i < was_read; i++) {
-            if(buffer[i] == flipper_format_eoln) {
-                if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                    error = true;
-                    break;
-                }
-
-                result = true;
-                break;
-            }
+            result = stream_eof(stream);
+            break;
         }
 
-        if(result || error) {
+        const uint8_t* eol = memchr(chunk, flipper_format_eoln, was_read);
+        size_t position = eol ? (size_t)(eol - chunk) : was_read;
+        if(!flipper_format_stream_set_chunk_position(stream, was_read, position, peeked)) break;
+        if(eol) {
+            result = true;
             break;
         }
     } while(true);
@@ -470,8 +519,6 @@ bool flipper_format_stream_delete_key_and_write(
         size_t size = stream_size(stream);
         if(size == 0) break;
 
-        if(!stream_rewind(stream)) break;
-
         // find key
         if(!flipper_format_stream_seek_to_key(stream, write_data->key, strict_mode)) break;
 
@@ -506,6 +553,67 @@ bool flipper_format_stream_delete_key_and_write(
     return result;
 }
 
+bool flipper_format_stream_delete_keys_and_write(
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    size_t count) {
+    bool result = false;
+    size_t found_count = 0;
+    StreamEdit* edits = malloc(sizeof(StreamEdit) * count);
+    bool* found = malloc(sizeof(bool) * count);
+    memset(found, 0, sizeof(bool) * count);
+
+    string_t read_key;
+    string_init(read_key);
+
+    do {
+        size_t size = stream_size(stream);
+        bool error = false;
+
+        // Lines are found in the stream order, so edits are sorted by offset
+        while(found_count < count && !stream_eof(stream)) {
+            if(!flipper_format_stream_read_valid_key(stream, read_key)) continue;
+
+            size_t i;
+            for(i = 0; i < count; i++) {
+                if(!found[i] && string_cmp_str(read_key, write_data[i].key) == 0) break;
+            }
+            if(i == count) continue;
+
+            // rw pointer is at the delimiter, key starts the line
+            size_t start_position = stream_tell(stream) - string_size(read_key);
+            if(!flipper_format_stream_seek_to_next_line(stream)) {
+                error = true;
+                break;
+            }
+            size_t end_position = stream_tell(stream);
+            // newline symbol
+            if(end_position < size) {
+                end_position += 1;
+            }
+
+            found[i] = true;
+            edits[found_count].offset = start_position;
+            edits[found_count].delete_size = end_position - start_position;
+            edits[found_count].write_callback =
+                (StreamWriteCB)flipper_format_stream_write_value_line;
+            edits[found_count].context = &write_data[i];
+            found_count++;
+        }
+        if(error || found_count != count) break;
+
+        if(!stream_delete_and_insert_batch(stream, edits, count)) break;
+
+        result = true;
+    } while(false);
+
+    string_clear(read_key);
+    free(found);
+    free(edits);
+
+    return result;
+}
+
 bool flipper_format_stream_write_comment_cstr(Stream* stream, const char* data) {
     bool result = false;
     do {
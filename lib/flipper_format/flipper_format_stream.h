@@ -71,6 +71,7 @@ bool flipper_format_stream_get_value_count(
 
 /**
  * Removes a key and the corresponding value string from the stream and inserts a new key/value pair.
+ * The key is searched from the current position of the stream.
  * @param stream 
  * @param write_data 
  * @param strict_mode 
@@ -82,6 +83,21 @@ bool flipper_format_stream_delete_key_and_write(
     FlipperStreamWriteData* write_data,
     bool strict_mode);
 
+/**
+ * Replaces lines of several keys with new key/value pairs in a single pass over the stream.
+ * For every key the first line from the current position of the stream is replaced.
+ * Keys must be unique, nothing is changed if any of them is not found.
+ * @param stream 
+ * @param write_data array of new key/value pairs
+ * @param count array size
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_delete_keys_and_write(
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    size_t count);
+
 /**
  * Writes a comment string to the stream.
  * @param stream 
@@ -29,6 +29,19 @@ bool flipper_format_stream_write_eol(Stream* stream);
  */
 bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode);
 
+typedef void (*FlipperStreamKeyCallback)(string_t key, size_t offset, void* context);
+
+/**
+ * Call the callback for every key from the current position to the end of the stream.
+ * @param stream 
+ * @param callback called with the key and the offset of the line with the key
+ * @param context 
+ */
+void flipper_format_stream_for_each_key(
+    Stream* stream,
+    FlipperStreamKeyCallback callback,
+    void* context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,499 @@
+#include "infrared_analyzer.h"
+#include <core/check.h>
+#include <core/common_defines.h>
+#include <stdlib.h>
+#include <string.h>
+#include <furi.h>
+
+// Durations are one symbol if they are within this ratio from the shortest one
+#define INFRARED_ANALYZER_TOLERANCE_PERCENT 25
+// Same as decoder burst gap: spaces inside frames are at most 4.5 ms, longer ones end a frame
+#define INFRARED_ANALYZER_GAP_MIN_US 8000
+#define INFRARED_ANALYZER_MAX_SYMBOLS 16
+
+typedef struct {
+    uint32_t min;
+    uint32_t value;
+    uint32_t count;
+} InfraredAnalyzerSymbol;
+
+typedef struct {
+    InfraredAnalyzerSymbol marks[INFRARED_ANALYZER_MAX_SYMBOLS];
+    InfraredAnalyzerSymbol spaces[INFRARED_ANALYZER_MAX_SYMBOLS];
+    size_t marks_count;
+    size_t spaces_count;
+    size_t size;
+    uint32_t* quantized;
+    uint32_t* buffer;
+    uint8_t* halves;
+} InfraredAnalyzer;
+
+typedef struct {
+    uint32_t* timings;
+    size_t size;
+    size_t max;
+} InfraredAnalyzerOutput;
+
+static const char* infrared_analyzer_encoding_names[InfraredAnalyzerEncodingMAX] = {
+    [InfraredAnalyzerEncodingPulseDistance] = "pulse_distance",
+    [InfraredAnalyzerEncodingPulseWidth] = "pulse_width",
+    [InfraredAnalyzerEncodingManchester] = "manchester",
+};
+
+static inline bool infrared_analyzer_get_bit(const uint8_t* data, size_t index) {
+    return data[index / 8] & (1 << (index % 8));
+}
+
+static inline void infrared_analyzer_set_bit(uint8_t* data, size_t index, bool value) {
+    if(value) {
+        data[index / 8] |= (1 << (index % 8));
+    } else {
+        data[index / 8] &= ~(1 << (index % 8));
+    }
+}
+
+static bool infrared_analyzer_push_bit(InfraredAnalyzerPattern* pattern, bool value) {
+    if(pattern->data_bits >= INFRARED_ANALYZER_MAX_DATA_SIZE * 8) return false;
+    infrared_analyzer_set_bit(pattern->data, pattern->data_bits++, value);
+    return true;
+}
+
+static inline bool infrared_analyzer_is_close(uint32_t shorter, uint32_t longer) {
+    return (uint64_t)longer * 100 <=
+           (uint64_t)shorter * (100 + INFRARED_ANALYZER_TOLERANCE_PERCENT);
+}
+
+static int infrared_analyzer_compare(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static bool
+    infrared_analyzer_group(InfraredAnalyzer* analyzer, const uint32_t* timings, bool mark) {
+    InfraredAnalyzerSymbol* symbols = mark ? analyzer->marks : analyzer->spaces;
+    size_t* symbols_count = mark ? &analyzer->marks_count : &analyzer->spaces_count;
+    uint32_t* sorted = analyzer->buffer;
+    size_t count = 0;
+
+    for(size_t i = mark ? 0 : 1; i < analyzer->size; i += 2) {
+        sorted[count++] = timings[i];
+    }
+    qsort(sorted, count, sizeof(uint32_t), infrared_analyzer_compare);
+
+    InfraredAnalyzerSymbol* symbol = NULL;
+    uint64_t sum = 0;
+    *symbols_count = 0;
+    for(size_t i = 0; i < count; ++i) {
+        if(!symbol || !infrared_analyzer_is_close(symbol->min, sorted[i])) {
+            if(symbol) symbol->value = sum / symbol->count;
+            if(*symbols_count == INFRARED_ANALYZER_MAX_SYMBOLS) return false;
+            symbol = &symbols[(*symbols_count)++];
+            symbol->min = sorted[i];
+            symbol->count = 0;
+            sum = 0;
+        }
+        symbol->count++;
+        sum += sorted[i];
+    }
+    if(symbol) symbol->value = sum / symbol->count;
+
+    // Close symbols would be merged when the result is analyzed again
+    for(size_t i = 1; i < *symbols_count; ++i) {
+        if(infrared_analyzer_is_close(symbols[i - 1].value, symbols[i].value)) return false;
+    }
+
+    return true;
+}
+
+static void infrared_analyzer_quantize(InfraredAnalyzer* analyzer, const uint32_t* timings) {
+    for(size_t i = 0; i < analyzer->size; ++i) {
+        bool mark = !(i & 1);
+        const InfraredAnalyzerSymbol* symbols = mark ? analyzer->marks : analyzer->spaces;
+        size_t j = mark ? analyzer->marks_count - 1 : analyzer->spaces_count - 1;
+
+        // Symbols are sorted, duration belongs to the last one starting below it
+        for(; j > 0 && symbols[j].min > timings[i]; --j) {
+        }
+        analyzer->quantized[i] = symbols[j].value;
+    }
+}
+
+/* Most frequent symbols shorter than a gap, in descending order of frequency */
+static size_t infrared_analyzer_get_frequent(
+    const InfraredAnalyzerSymbol* symbols,
+    size_t symbols_count,
+    uint32_t* values) {
+    const InfraredAnalyzerSymbol* first = NULL;
+    const InfraredAnalyzerSymbol* second = NULL;
+
+    for(size_t i = 0; i < symbols_count; ++i) {
+        const InfraredAnalyzerSymbol* symbol = &symbols[i];
+        if(symbol->value >= INFRARED_ANALYZER_GAP_MIN_US) continue;
+        if(!first || symbol->count > first->count) {
+            second = first;
+            first = symbol;
+        } else if(!second || symbol->count > second->count) {
+            second = symbol;
+        }
+    }
+
+    values[0] = first ? first->value : 0;
+    values[1] = second ? second->value : 0;
+    return !!first + !!second;
+}
+
+static void infrared_analyzer_set_halves(uint32_t* symbol, const uint32_t* values, size_t count) {
+    symbol[0] = count > 1 ? MIN(values[0], values[1]) : values[0];
+    symbol[1] = count > 1 ? MAX(values[0], values[1]) : 0;
+    // Other symbol is not a double half-bit, it can be only a header
+    if(symbol[1] && (symbol[1] * 2 < symbol[0] * 3 || symbol[1] * 2 > symbol[0] * 5)) {
+        symbol[1] = 0;
+    }
+}
+
+static bool
+    infrared_analyzer_set_symbols(InfraredAnalyzer* analyzer, InfraredAnalyzerPattern* pattern) {
+    uint32_t marks[2];
+    uint32_t spaces[2];
+    size_t marks_count =
+        infrared_analyzer_get_frequent(analyzer->marks, analyzer->marks_count, marks);
+    size_t spaces_count =
+        infrared_analyzer_get_frequent(analyzer->spaces, analyzer->spaces_count, spaces);
+
+    switch(pattern->encoding) {
+    case InfraredAnalyzerEncodingPulseDistance:
+        if(marks_count < 1 || spaces_count < 2) return false;
+        pattern->bit_mark[0] = pattern->bit_mark[1] = marks[0];
+        pattern->bit_space[0] = MIN(spaces[0], spaces[1]);
+        pattern->bit_space[1] = MAX(spaces[0], spaces[1]);
+        break;
+    case InfraredAnalyzerEncodingPulseWidth:
+        if(marks_count < 2 || spaces_count < 1) return false;
+        pattern->bit_mark[0] = MIN(marks[0], marks[1]);
+        pattern->bit_mark[1] = MAX(marks[0], marks[1]);
+        pattern->bit_space[0] = pattern->bit_space[1] = spaces[0];
+        break;
+    case InfraredAnalyzerEncodingManchester:
+        if(marks_count < 1 || spaces_count < 1) return false;
+        infrared_analyzer_set_halves(pattern->bit_mark, marks, marks_count);
+        infrared_analyzer_set_halves(pattern->bit_space, spaces, spaces_count);
+        break;
+    default:
+        furi_crash(NULL);
+    }
+
+    return true;
+}
+
+static bool infrared_analyzer_is_symbol(
+    const InfraredAnalyzerPattern* pattern,
+    uint32_t mark,
+    uint32_t space) {
+    if(pattern->encoding == InfraredAnalyzerEncodingManchester) {
+        return (mark == pattern->bit_mark[0] || mark == pattern->bit_mark[1]) &&
+               (space == pattern->bit_space[0] || space == pattern->bit_space[1]);
+    }
+
+    return (mark == pattern->bit_mark[0] && space == pattern->bit_space[0]) ||
+           (mark == pattern->bit_mark[1] && space == pattern->bit_space[1]);
+}
+
+static bool infrared_analyzer_parse_pulse(
+    InfraredAnalyzer* analyzer,
+    InfraredAnalyzerPattern* pattern,
+    size_t index,
+    size_t end) {
+    const uint32_t* timings = analyzer->quantized;
+
+    for(; index + 1 < end; index += 2) {
+        size_t bit = 0;
+        while(bit < 2 && !(timings[index] == pattern->bit_mark[bit] &&
+                           timings[index + 1] == pattern->bit_space[bit])) {
+            ++bit;
+        }
+        if(bit == 2 || !infrared_analyzer_push_bit(pattern, bit)) return false;
+    }
+
+    uint32_t last = timings[index];
+    if(pattern->encoding == InfraredAnalyzerEncodingPulseDistance) {
+        if(!pattern->stop_mark) pattern->stop_mark = last;
+        return last == pattern->stop_mark;
+    } else {
+        return (last == pattern->bit_mark[0] || last == pattern->bit_mark[1]) &&
+               infrared_analyzer_push_bit(pattern, last == pattern->bit_mark[1]);
+    }
+}
+
+static bool infrared_analyzer_parse_manchester(
+    InfraredAnalyzer* analyzer,
+    InfraredAnalyzerPattern* pattern,
+    size_t index,
+    size_t end) {
+    const uint32_t* timings = analyzer->quantized;
+    uint8_t* halves = analyzer->halves;
+    size_t count = 0;
+
+    // Frame starts and ends with a mark, space half-bits around it belong to gaps
+    halves[count++] = false;
+    for(; index < end; ++index) {
+        bool mark = !(index & 1);
+        const uint32_t* symbol = mark ? pattern->bit_mark : pattern->bit_space;
+        size_t run = 0;
+        if(timings[index] == symbol[0]) {
+            run = 1;
+        } else if(symbol[1] && timings[index] == symbol[1]) {
+            run = 2;
+        } else {
+            return false;
+        }
+        while(run--) halves[count++] = mark;
+    }
+    halves[count] = false;
+
+    // Alignment without the leading space half-bit is tried first
+    static const size_t alignments[] = {1, 0};
+    for(size_t k = 0; k < COUNT_OF(alignments); ++k) {
+        size_t first = alignments[k];
+        size_t last = count + (count - first) % 2;
+        size_t i = first;
+        while(i < last && halves[i] != halves[i + 1]) i += 2;
+        if(i < last) continue;
+
+        for(i = first; i < last; i += 2) {
+            if(!infrared_analyzer_push_bit(pattern, halves[i + 1])) return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static bool infrared_analyzer_parse(InfraredAnalyzer* analyzer, InfraredAnalyzerPattern* pattern) {
+    const uint32_t* timings = analyzer->quantized;
+    size_t index = 0;
+
+    while(index < analyzer->size) {
+        // Frame ends with a mark followed by a gap or the last space
+        size_t end = index + 1;
+        while(end < analyzer->size && timings[end] < INFRARED_ANALYZER_GAP_MIN_US &&
+              end + 1 < analyzer->size) {
+            end += 2;
+        }
+
+        InfraredAnalyzerFrame frame = {
+            .gap = (end < analyzer->size) ? timings[end] : 0,
+            .repeat = 1,
+        };
+        size_t data_start = pattern->data_bits;
+        size_t next = end + 1;
+
+        if(end - index >= 3 &&
+           !infrared_analyzer_is_symbol(pattern, timings[index], timings[index + 1])) {
+            frame.header_mark = timings[index];
+            frame.header_space = timings[index + 1];
+            index += 2;
+        }
+
+        bool success = (pattern->encoding == InfraredAnalyzerEncodingManchester) ?
+                           infrared_analyzer_parse_manchester(analyzer, pattern, index, end) :
+                           infrared_analyzer_parse_pulse(analyzer, pattern, index, end);
+        if(!success) return false;
+        frame.bits = pattern->data_bits - data_start;
+
+        InfraredAnalyzerFrame* previous =
+            pattern->frames_count ? &pattern->frames[pattern->frames_count - 1] : NULL;
+        bool same = previous && previous->header_mark == frame.header_mark &&
+                    previous->header_space == frame.header_space &&
+                    previous->gap == frame.gap && previous->bits == frame.bits &&
+                    previous->repeat < UINT16_MAX;
+        for(size_t i = 0; same && i < frame.bits; ++i) {
+            same = infrared_analyzer_get_bit(pattern->data, data_start - frame.bits + i) ==
+                   infrared_analyzer_get_bit(pattern->data, data_start + i);
+        }
+
+        if(same) {
+            ++previous->repeat;
+            pattern->data_bits = data_start;
+        } else if(pattern->frames_count < INFRARED_ANALYZER_MAX_FRAMES) {
+            pattern->frames[pattern->frames_count++] = frame;
+        } else {
+            return false;
+        }
+
+        index = next;
+    }
+
+    return pattern->frames_count > 0;
+}
+
+static bool infrared_analyzer_emit(InfraredAnalyzerOutput* output, uint32_t duration) {
+    if(!duration || output->size >= output->max) return false;
+    output->timings[output->size++] = duration;
+    return true;
+}
+
+static bool infrared_analyzer_encode_manchester(
+    const InfraredAnalyzerPattern* pattern,
+    InfraredAnalyzerOutput* output,
+    size_t offset,
+    size_t bits) {
+    bool level = false;
+    size_t run = 0;
+
+    for(size_t i = 0; i < bits * 2; ++i) {
+        bool bit = infrared_analyzer_get_bit(pattern->data, offset + i / 2);
+        bool half = (i & 1) ? bit : !bit;
+        if(!run && !half) {
+            // Leading space half-bit is a part of the previous gap
+            continue;
+        } else if(run && half != level) {
+            uint32_t duration = level ? pattern->bit_mark[run - 1] : pattern->bit_space[run - 1];
+            if(!infrared_analyzer_emit(output, duration)) return false;
+            run = 0;
+        }
+        level = half;
+        ++run;
+    }
+
+    // Trailing space half-bit is a part of the next gap
+    return !level || infrared_analyzer_emit(output, pattern->bit_mark[run - 1]);
+}
+
+static bool infrared_analyzer_encode_bits(
+    const InfraredAnalyzerPattern* pattern,
+    InfraredAnalyzerOutput* output,
+    size_t offset,
+    size_t bits) {
+    if(pattern->encoding == InfraredAnalyzerEncodingManchester) {
+        return bits && infrared_analyzer_encode_manchester(pattern, output, offset, bits);
+    }
+
+    bool distance = (pattern->encoding == InfraredAnalyzerEncodingPulseDistance);
+    if(!distance && !bits) return false;
+
+    for(size_t i = 0; i < bits; ++i) {
+        bool bit = infrared_analyzer_get_bit(pattern->data, offset + i);
+        if(!infrared_analyzer_emit(output, pattern->bit_mark[bit])) return false;
+        if(distance || i + 1 < bits) {
+            if(!infrared_analyzer_emit(output, pattern->bit_space[bit])) return false;
+        }
+    }
+
+    return !distance || infrared_analyzer_emit(output, pattern->stop_mark);
+}
+
+static bool infrared_analyzer_analyze_timings(
+    InfraredAnalyzerPattern* pattern,
+    const uint32_t* timings,
+    size_t timings_size) {
+    if(!timings_size) return false;
+
+    InfraredAnalyzer* analyzer = malloc(sizeof(InfraredAnalyzer));
+    analyzer->size = timings_size;
+    analyzer->quantized = malloc(sizeof(uint32_t) * timings_size);
+    analyzer->buffer = malloc(sizeof(uint32_t) * timings_size);
+    analyzer->halves = malloc(timings_size * 2 + 2);
+
+    bool success = infrared_analyzer_group(analyzer, timings, true) &&
+                   infrared_analyzer_group(analyzer, timings, false);
+
+    if(success) {
+        infrared_analyzer_quantize(analyzer, timings);
+        success = false;
+
+        for(size_t i = 0; !success && i < InfraredAnalyzerEncodingMAX; ++i) {
+            memset(pattern, 0, sizeof(InfraredAnalyzerPattern));
+            pattern->encoding = i;
+            success = infrared_analyzer_set_symbols(analyzer, pattern) &&
+                      infrared_analyzer_parse(analyzer, pattern) &&
+                      (infrared_analyzer_encode(pattern, analyzer->buffer, timings_size) ==
+                       timings_size) &&
+                      !memcmp(
+                          analyzer->buffer, analyzer->quantized, sizeof(uint32_t) * timings_size);
+        }
+    }
+
+    free(analyzer->halves);
+    free(analyzer->buffer);
+    free(analyzer->quantized);
+    free(analyzer);
+
+    return success;
+}
+
+bool infrared_analyzer_analyze(
+    InfraredAnalyzerPattern* pattern,
+    const uint32_t* timings,
+    size_t timings_size) {
+    furi_assert(pattern);
+    furi_assert(timings);
+
+    bool success = infrared_analyzer_analyze_timings(pattern, timings, timings_size);
+
+    // Pattern is reproducible only if analyzing its own expansion gives it back
+    if(success) {
+        uint32_t* expanded = malloc(sizeof(uint32_t) * timings_size);
+        InfraredAnalyzerPattern* reanalyzed = malloc(sizeof(InfraredAnalyzerPattern));
+        success = (infrared_analyzer_encode(pattern, expanded, timings_size) == timings_size) &&
+                  infrared_analyzer_analyze_timings(reanalyzed, expanded, timings_size) &&
+                  !memcmp(reanalyzed, pattern, sizeof(InfraredAnalyzerPattern));
+        free(reanalyzed);
+        free(expanded);
+    }
+
+    return success;
+}
+
+size_t infrared_analyzer_encode(
+    const InfraredAnalyzerPattern* pattern,
+    uint32_t* timings,
+    size_t timings_max) {
+    furi_assert(pattern);
+    furi_assert(timings);
+
+    InfraredAnalyzerOutput output = {.timings = timings, .size = 0, .max = timings_max};
+    bool success = (pattern->encoding < InfraredAnalyzerEncodingMAX) &&
+                   (pattern->frames_count > 0) &&
+                   (pattern->frames_count <= INFRARED_ANALYZER_MAX_FRAMES) &&
+                   (pattern->data_bits <= INFRARED_ANALYZER_MAX_DATA_SIZE * 8);
+    size_t offset = 0;
+
+    for(size_t i = 0; success && i < pattern->frames_count; ++i) {
+        const InfraredAnalyzerFrame* frame = &pattern->frames[i];
+        success = frame->repeat && (offset + frame->bits <= pattern->data_bits) &&
+                  (!frame->header_mark == !frame->header_space);
+
+        for(size_t j = 0; success && j < frame->repeat; ++j) {
+            if(frame->header_mark) {
+                success = infrared_analyzer_emit(&output, frame->header_mark) &&
+                          infrared_analyzer_emit(&output, frame->header_space);
+            }
+            success = success &&
+                      infrared_analyzer_encode_bits(pattern, &output, offset, frame->bits);
+
+            if(frame->gap) {
+                success = success && infrared_analyzer_emit(&output, frame->gap);
+            } else {
+                // Only the signal can end without a space
+                success = success && (i + 1 == pattern->frames_count) && (j + 1 == frame->repeat);
+            }
+        }
+
+        offset += frame->bits;
+    }
+
+    return (success && offset == pattern->data_bits) ? output.size : 0;
+}
+
+const char* infrared_analyzer_get_encoding_name(InfraredAnalyzerEncoding encoding) {
+    furi_assert(encoding < InfraredAnalyzerEncodingMAX);
+    return infrared_analyzer_encoding_names[encoding];
+}
+
+InfraredAnalyzerEncoding infrared_analyzer_get_encoding_by_name(const char* name) {
+    for(size_t i = 0; i < InfraredAnalyzerEncodingMAX; ++i) {
+        if(!strcmp(infrared_analyzer_encoding_names[i], name)) return i;
+    }
+    return InfraredAnalyzerEncodingMAX;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INFRARED_ANALYZER_MAX_FRAMES 16
+#define INFRARED_ANALYZER_MAX_DATA_SIZE 128
+
+typedef enum {
+    InfraredAnalyzerEncodingPulseDistance, /** Bits differ by space, frames end with a stop mark */
+    InfraredAnalyzerEncodingPulseWidth, /** Bits differ by mark, spaces are equal */
+    InfraredAnalyzerEncodingManchester, /** Bit 1 is space-mark, bit 0 is mark-space half-bits */
+    InfraredAnalyzerEncodingMAX,
+} InfraredAnalyzerEncoding;
+
+typedef struct {
+    uint32_t header_mark; /** 0 if the frame has no header */
+    uint32_t header_space;
+    uint32_t gap; /** space after every repetition of the frame, 0 if there is none */
+    uint16_t bits; /** data bits in the frame */
+    uint16_t repeat; /** how many times the frame is sent in a row */
+} InfraredAnalyzerFrame;
+
+/** Parametric description of a raw signal.
+ * For pulse distance and pulse width encodings bit_mark and bit_space are the durations
+ * of bit 0 and bit 1, for Manchester encoding - durations of one and two half-bits.
+ */
+typedef struct {
+    InfraredAnalyzerEncoding encoding;
+    uint32_t bit_mark[2];
+    uint32_t bit_space[2];
+    uint32_t stop_mark;
+    size_t frames_count;
+    InfraredAnalyzerFrame frames[INFRARED_ANALYZER_MAX_FRAMES];
+    size_t data_bits; /** data bits of all frames, repetitions are stored once */
+    uint8_t data[INFRARED_ANALYZER_MAX_DATA_SIZE]; /** frames data, LSB first */
+} InfraredAnalyzerPattern;
+
+/** Infer pattern of a raw signal.
+ * Durations are grouped into symbols, signal is split into frames on long spaces,
+ * and frames are decoded with every known bit encoding. Pattern is accepted only if
+ * it gives back all the timings with durations replaced by their symbol durations,
+ * and if analyzing that expansion gives the same pattern. Replay from pattern is lossy:
+ * captured jitter is replaced by symbol averages.
+ *
+ * @param[out]  pattern - inferred pattern
+ * @param[in]   timings - raw signal timings, starting with a mark
+ * @param[in]   timings_size - amount of timings
+ *
+ * @return      true if signal can be described with pattern, false otherwise
+ */
+bool infrared_analyzer_analyze(
+    InfraredAnalyzerPattern* pattern,
+    const uint32_t* timings,
+    size_t timings_size);
+
+/** Expand pattern into raw signal timings.
+ *
+ * @param[in]   pattern - pattern to expand
+ * @param[out]  timings - raw signal timings, starting with a mark
+ * @param[in]   timings_max - size of timings buffer
+ *
+ * @return      amount of timings, 0 if pattern is invalid or doesn't fit into the buffer
+ */
+size_t infrared_analyzer_encode(
+    const InfraredAnalyzerPattern* pattern,
+    uint32_t* timings,
+    size_t timings_max);
+
+/** Get name of the encoding
+ *
+ * @param[in]   encoding - encoding
+ *
+ * @return      string name of encoding
+ */
+const char* infrared_analyzer_get_encoding_name(InfraredAnalyzerEncoding encoding);
+
+/** Get encoding by its name
+ *
+ * @param[in]   name - string name of encoding
+ *
+ * @return      encoding, InfraredAnalyzerEncodingMAX if name is unknown
+ */
+InfraredAnalyzerEncoding infrared_analyzer_get_encoding_by_name(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,12 +9,16 @@
 #include "infrared_i.h"
 #include <furi_hal_infrared.h>
 
+// Spaces inside messages are at most 4.5 ms (NEC and Samsung32 preamble), longer ones end a burst
+#define INFRARED_DECODER_BURST_GAP_US 8000
+
 typedef struct {
     InfraredAlloc alloc;
     InfraredDecode decode;
     InfraredDecoderReset reset;
     InfraredFree free;
     InfraredDecoderCheckReady check_ready;
+    const InfraredTimings* timings;
 } InfraredDecoders;
 
 typedef struct {
@@ -26,6 +30,8 @@ typedef struct {
 
 struct InfraredDecoderHandler {
     void** ctx;
+    uint32_t active; /* decoders receiving timings of the current burst */
+    uint32_t skipped; /* decoders that missed timings since they were fed last time */
 };
 
 struct InfraredEncoderHandler {
@@ -46,7 +52,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_nec_decode,
              .reset = infrared_decoder_nec_reset,
              .check_ready = infrared_decoder_nec_check_ready,
-             .free = infrared_decoder_nec_free},
+             .free = infrared_decoder_nec_free,
+             .timings = &protocol_nec.timings},
         .encoder =
             {.alloc = infrared_encoder_nec_alloc,
              .encode = infrared_encoder_nec_encode,
@@ -60,7 +67,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_samsung32_decode,
              .reset = infrared_decoder_samsung32_reset,
              .check_ready = infrared_decoder_samsung32_check_ready,
-             .free = infrared_decoder_samsung32_free},
+             .free = infrared_decoder_samsung32_free,
+             .timings = &protocol_samsung32.timings},
         .encoder =
             {.alloc = infrared_encoder_samsung32_alloc,
              .encode = infrared_encoder_samsung32_encode,
@@ -74,7 +82,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc5_decode,
              .reset = infrared_decoder_rc5_reset,
              .check_ready = infrared_decoder_rc5_check_ready,
-             .free = infrared_decoder_rc5_free},
+             .free = infrared_decoder_rc5_free,
+             .timings = &protocol_rc5.timings},
         .encoder =
             {.alloc = infrared_encoder_rc5_alloc,
              .encode = infrared_encoder_rc5_encode,
@@ -88,7 +97,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc6_decode,
              .reset = infrared_decoder_rc6_reset,
              .check_ready = infrared_decoder_rc6_check_ready,
-             .free = infrared_decoder_rc6_free},
+             .free = infrared_decoder_rc6_free,
+             .timings = &protocol_rc6.timings},
         .encoder =
             {.alloc = infrared_encoder_rc6_alloc,
              .encode = infrared_encoder_rc6_encode,
@@ -102,7 +112,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_sirc_decode,
              .reset = infrared_decoder_sirc_reset,
              .check_ready = infrared_decoder_sirc_check_ready,
-             .free = infrared_decoder_sirc_free},
+             .free = infrared_decoder_sirc_free,
+             .timings = &protocol_sirc.timings},
         .encoder =
             {.alloc = infrared_encoder_sirc_alloc,
              .encode = infrared_encoder_sirc_encode,
@@ -116,6 +127,39 @@ static int infrared_find_index_by_protocol(InfraredProtocol protocol);
 static const InfraredProtocolSpecification*
     infrared_get_spec_by_protocol(InfraredProtocol protocol);
 
+/* Decoders without preamble can't be selected by the first mark, they get every timing */
+static uint32_t infrared_get_default_decoders(void) {
+    uint32_t mask = 0;
+
+    for(size_t i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        const InfraredTimings* timings = infrared_encoder_decoder[i].decoder.timings;
+        if(!timings || !timings->preamble_mark) {
+            mask |= (1 << i);
+        }
+    }
+
+    return mask;
+}
+
+/* Decoder joins the burst on the mark matching its preamble (or repeat) mark */
+static void infrared_activate_decoders(InfraredDecoderHandler* handler, uint32_t duration) {
+    for(size_t i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        const uint32_t mask = (1 << i);
+        const InfraredTimings* timings = infrared_encoder_decoder[i].decoder.timings;
+
+        if((handler->active & mask) ||
+           !MATCH_TIMING(duration, timings->preamble_mark, timings->preamble_tolerance)) {
+            continue;
+        }
+
+        if((handler->skipped & mask) && infrared_encoder_decoder[i].decoder.reset) {
+            infrared_encoder_decoder[i].decoder.reset(handler->ctx[i]);
+        }
+        handler->skipped &= ~mask;
+        handler->active |= mask;
+    }
+}
+
 const InfraredMessage*
     infrared_decode(InfraredDecoderHandler* handler, bool level, uint32_t duration) {
     furi_assert(handler);
@@ -123,7 +167,15 @@ const InfraredMessage*
     InfraredMessage* message = NULL;
     InfraredMessage* result = NULL;
 
+    if(level) {
+        infrared_activate_decoders(handler, duration);
+    }
+
     for(size_t i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        if(!(handler->active & (1 << i))) {
+            handler->skipped |= (1 << i);
+            continue;
+        }
         if(infrared_encoder_decoder[i].decoder.decode) {
             message = infrared_encoder_decoder[i].decoder.decode(handler->ctx[i], level, duration);
             if(!result && message) {
@@ -132,6 +184,11 @@ const InfraredMessage*
         }
     }
 
+    /* Active decoders see the gap to finish the message, next mark selects decoders again */
+    if(!level && (duration > INFRARED_DECODER_BURST_GAP_US)) {
+        handler->active = infrared_get_default_decoders();
+    }
+
     return result;
 }
 
@@ -167,6 +224,9 @@ void infrared_reset_decoder(InfraredDecoderHandler* handler) {
         if(infrared_encoder_decoder[i].decoder.reset)
             infrared_encoder_decoder[i].decoder.reset(handler->ctx[i]);
     }
+
+    handler->active = infrared_get_default_decoders();
+    handler->skipped = 0;
 }
 
 const InfraredMessage* infrared_check_decoder_ready(InfraredDecoderHandler* handler) {
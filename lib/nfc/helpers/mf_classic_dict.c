@@ -2,17 +2,56 @@
 
 #include <lib/toolbox/args.h>
 #include <lib/flipper_format/flipper_format.h>
+#include <lib/nfc/protocols/nfc_util.h>
 
 #define MF_CLASSIC_DICT_FLIPPER_PATH EXT_PATH("nfc/assets/mf_classic_dict.nfc")
 #define MF_CLASSIC_DICT_USER_PATH EXT_PATH("nfc/assets/mf_classic_dict_user.nfc")
+#define MF_CLASSIC_DICT_FLIPPER_CACHE_PATH EXT_PATH("nfc/assets/mf_classic_dict.cache")
+#define MF_CLASSIC_DICT_USER_CACHE_PATH EXT_PATH("nfc/assets/mf_classic_dict_user.cache")
+#define MF_CLASSIC_DICT_HITS_PATH EXT_PATH("nfc/assets/mf_classic_dict.hits")
 
 #define TAG "MfClassicDict"
 
 #define NFC_MF_CLASSIC_KEY_LEN (13)
 
+#define MF_CLASSIC_DICT_KEY_SIZE (6)
+#define MF_CLASSIC_DICT_CACHE_MAGIC (0x4443464D)
+#define MF_CLASSIC_DICT_CACHE_VERSION (3)
+#define MF_CLASSIC_DICT_HITS_MAGIC (0x4843464D)
+#define MF_CLASSIC_DICT_HITS_VERSION (1)
+#define MF_CLASSIC_DICT_HITS_MAX (64)
+#define MF_CLASSIC_DICT_STREAM_BUFFER_SIZE (2048)
+#define MF_CLASSIC_DICT_KEYS_CAPACITY_MIN (16)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t source_size;
+    uint32_t source_mtime;
+    uint32_t total_keys;
+} MfClassicDictCacheHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+} MfClassicDictHitsHeader;
+
+typedef struct {
+    uint8_t key[MF_CLASSIC_DICT_KEY_SIZE];
+    uint16_t hits;
+} MfClassicDictHit;
+
 struct MfClassicDict {
     Stream* stream;
+    uint8_t* keys;
+    uint32_t keys_capacity;
     uint32_t total_keys;
+    uint32_t key_index;
+
+    // Hits found during this session, merged into hits file on free
+    MfClassicDictHit hits_new[MF_CLASSIC_DICT_HITS_MAX];
+    uint32_t hits_new_count;
 };
 
 bool mf_classic_dict_check_presence(MfClassicDictType dict_type) {
@@ -30,39 +69,283 @@ bool mf_classic_dict_check_presence(MfClassicDictType dict_type) {
     return dict_present;
 }
 
+static bool mf_classic_dict_parse_key(string_t line, uint64_t* key) {
+    if(string_get_char(line, 0) == '#') return false;
+    if(string_size(line) != NFC_MF_CLASSIC_KEY_LEN) return false;
+
+    uint8_t key_byte_tmp = 0;
+    *key = 0ULL;
+    for(uint8_t i = 0; i < 12; i += 2) {
+        args_char_to_hex(string_get_char(line, i), string_get_char(line, i + 1), &key_byte_tmp);
+        *key |= (uint64_t)key_byte_tmp << 8 * (5 - i / 2);
+    }
+    return true;
+}
+
+static inline uint32_t mf_classic_dict_key_hash(uint64_t key, uint32_t mask) {
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+static inline uint32_t mf_classic_dict_table_size(uint32_t keys_count) {
+    uint32_t table_size = 16;
+    while(table_size < keys_count * 2) table_size <<= 1;
+    return table_size;
+}
+
+// Open addressing set of key indexes + 1, returns slot of the key or empty slot for it
+static uint32_t* mf_classic_dict_table_find(
+    uint32_t* table,
+    uint32_t table_size,
+    uint8_t* keys,
+    uint64_t key) {
+    uint32_t slot = mf_classic_dict_key_hash(key, table_size - 1);
+    while(table[slot]) {
+        uint8_t* stored = &keys[(table[slot] - 1) * MF_CLASSIC_DICT_KEY_SIZE];
+        if(nfc_util_bytes2num(stored, MF_CLASSIC_DICT_KEY_SIZE) == key) break;
+        slot = (slot + 1) & (table_size - 1);
+    }
+    return &table[slot];
+}
+
+static void mf_classic_dict_load_text(MfClassicDict* dict) {
+    string_t next_line;
+    string_init(next_line);
+    uint64_t key = 0;
+
+    // Read total amount of keys
+    uint32_t line_keys = 0;
+    while(stream_read_line(dict->stream, next_line)) {
+        if(mf_classic_dict_parse_key(next_line, &key)) line_keys++;
+    }
+    stream_rewind(dict->stream);
+
+    // Keeps the first occurrence of every key
+    uint32_t table_size = mf_classic_dict_table_size(line_keys);
+    uint32_t* table = malloc(table_size * sizeof(uint32_t));
+    dict->keys_capacity = MAX(line_keys, 1U);
+    dict->keys = malloc(dict->keys_capacity * MF_CLASSIC_DICT_KEY_SIZE);
+    dict->total_keys = 0;
+
+    while(dict->total_keys < line_keys && stream_read_line(dict->stream, next_line)) {
+        if(!mf_classic_dict_parse_key(next_line, &key)) continue;
+        uint32_t* slot = mf_classic_dict_table_find(table, table_size, dict->keys, key);
+        if(*slot) continue;
+        nfc_util_num2bytes(
+            key,
+            MF_CLASSIC_DICT_KEY_SIZE,
+            &dict->keys[dict->total_keys * MF_CLASSIC_DICT_KEY_SIZE]);
+        *slot = ++dict->total_keys;
+    }
+
+    free(table);
+    string_clear(next_line);
+    stream_rewind(dict->stream);
+
+    if(line_keys != dict->total_keys) {
+        FURI_LOG_I(TAG, "Skipped %d duplicate keys", line_keys - dict->total_keys);
+    }
+}
+
+static bool mf_classic_dict_load_cache(
+    MfClassicDict* dict,
+    Storage* storage,
+    const char* cache_path,
+    const FileInfo* source_info) {
+    File* file = storage_file_alloc(storage);
+    MfClassicDictCacheHeader header;
+    bool cache_loaded = false;
+
+    do {
+        if(!storage_file_open(file, cache_path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != MF_CLASSIC_DICT_CACHE_MAGIC ||
+           header.version != MF_CLASSIC_DICT_CACHE_VERSION ||
+           header.source_size != source_info->size ||
+           header.source_mtime != source_info->mtime) {
+            FURI_LOG_D(TAG, "Cache is outdated");
+            break;
+        }
+        size_t keys_size = header.total_keys * MF_CLASSIC_DICT_KEY_SIZE;
+        dict->keys_capacity = MAX(header.total_keys, 1U);
+        dict->keys = malloc(dict->keys_capacity * MF_CLASSIC_DICT_KEY_SIZE);
+        if(storage_file_read(file, dict->keys, keys_size) != keys_size) {
+            free(dict->keys);
+            dict->keys = NULL;
+            break;
+        }
+        dict->total_keys = header.total_keys;
+        cache_loaded = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return cache_loaded;
+}
+
+static void mf_classic_dict_save_cache(
+    MfClassicDict* dict,
+    Storage* storage,
+    const char* cache_path,
+    const FileInfo* source_info) {
+    File* file = storage_file_alloc(storage);
+    MfClassicDictCacheHeader header = {
+        .magic = MF_CLASSIC_DICT_CACHE_MAGIC,
+        .version = MF_CLASSIC_DICT_CACHE_VERSION,
+        .source_size = source_info->size,
+        .source_mtime = source_info->mtime,
+        .total_keys = dict->total_keys,
+    };
+    size_t keys_size = dict->total_keys * MF_CLASSIC_DICT_KEY_SIZE;
+
+    bool cache_saved = false;
+    do {
+        if(!storage_file_open(file, cache_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, dict->keys, keys_size) != keys_size) break;
+        cache_saved = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // Cache is optional, broken one must not be used next time
+    if(!cache_saved) {
+        FURI_LOG_W(TAG, "Unable to save cache");
+        storage_common_remove(storage, cache_path);
+    }
+}
+
+static uint32_t mf_classic_dict_hits_load(Storage* storage, MfClassicDictHit* hits) {
+    File* file = storage_file_alloc(storage);
+    MfClassicDictHitsHeader header;
+    uint32_t count = 0;
+
+    do {
+        if(!storage_file_open(file, MF_CLASSIC_DICT_HITS_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != MF_CLASSIC_DICT_HITS_MAGIC ||
+           header.version != MF_CLASSIC_DICT_HITS_VERSION ||
+           header.count > MF_CLASSIC_DICT_HITS_MAX) {
+            break;
+        }
+        size_t hits_size = header.count * sizeof(MfClassicDictHit);
+        if(storage_file_read(file, hits, hits_size) != hits_size) break;
+        count = header.count;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return count;
+}
+
+static void mf_classic_dict_hits_save(Storage* storage, MfClassicDictHit* hits, uint32_t count) {
+    File* file = storage_file_alloc(storage);
+    MfClassicDictHitsHeader header = {
+        .magic = MF_CLASSIC_DICT_HITS_MAGIC,
+        .version = MF_CLASSIC_DICT_HITS_VERSION,
+        .count = count,
+    };
+    size_t hits_size = count * sizeof(MfClassicDictHit);
+
+    do {
+        if(!storage_file_open(file, MF_CLASSIC_DICT_HITS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, hits, hits_size) != hits_size) break;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+static void mf_classic_dict_hits_sort(MfClassicDictHit* hits, uint32_t count) {
+    // Stable insertion sort, most frequent first
+    for(uint32_t i = 1; i < count; i++) {
+        MfClassicDictHit hit = hits[i];
+        uint32_t j = i;
+        while(j > 0 && hits[j - 1].hits < hit.hits) {
+            hits[j] = hits[j - 1];
+            j--;
+        }
+        hits[j] = hit;
+    }
+}
+
+static void mf_classic_dict_order_by_hits(MfClassicDict* dict, Storage* storage) {
+    MfClassicDictHit* hits = malloc(MF_CLASSIC_DICT_HITS_MAX * sizeof(MfClassicDictHit));
+    uint32_t count = mf_classic_dict_hits_load(storage, hits);
+    mf_classic_dict_hits_sort(hits, count);
+
+    // Move keys that hit before to the front, others keep dictionary order
+    uint32_t front = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        for(uint32_t j = front; j < dict->total_keys; j++) {
+            uint8_t* key = &dict->keys[j * MF_CLASSIC_DICT_KEY_SIZE];
+            if(memcmp(key, hits[i].key, MF_CLASSIC_DICT_KEY_SIZE)) continue;
+            memmove(
+                &dict->keys[(front + 1) * MF_CLASSIC_DICT_KEY_SIZE],
+                &dict->keys[front * MF_CLASSIC_DICT_KEY_SIZE],
+                (j - front) * MF_CLASSIC_DICT_KEY_SIZE);
+            memcpy(
+                &dict->keys[front * MF_CLASSIC_DICT_KEY_SIZE],
+                hits[i].key,
+                MF_CLASSIC_DICT_KEY_SIZE);
+            front++;
+            break;
+        }
+    }
+
+    free(hits);
+}
+
 MfClassicDict* mf_classic_dict_alloc(MfClassicDictType dict_type) {
     MfClassicDict* dict = malloc(sizeof(MfClassicDict));
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    dict->stream = buffered_file_stream_alloc(storage);
-    furi_record_close(RECORD_STORAGE);
+    dict->stream = buffered_file_stream_alloc_ex(
+        storage, MF_CLASSIC_DICT_STREAM_BUFFER_SIZE, BufferedFileStreamAccessSequential);
 
+    const char* dict_path = NULL;
+    const char* cache_path = NULL;
     bool dict_loaded = false;
     do {
         if(dict_type == MfClassicDictTypeFlipper) {
+            dict_path = MF_CLASSIC_DICT_FLIPPER_PATH;
+            cache_path = MF_CLASSIC_DICT_FLIPPER_CACHE_PATH;
             if(!buffered_file_stream_open(
-                   dict->stream, MF_CLASSIC_DICT_FLIPPER_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+                   dict->stream, dict_path, FSAM_READ, FSOM_OPEN_EXISTING)) {
                 buffered_file_stream_close(dict->stream);
                 break;
             }
         } else if(dict_type == MfClassicDictTypeUser) {
+            dict_path = MF_CLASSIC_DICT_USER_PATH;
+            cache_path = MF_CLASSIC_DICT_USER_CACHE_PATH;
             if(!buffered_file_stream_open(
-                   dict->stream, MF_CLASSIC_DICT_USER_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+                   dict->stream, dict_path, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
                 buffered_file_stream_close(dict->stream);
                 break;
             }
         }
 
-        // Read total amount of keys
-        string_t next_line;
-        string_init(next_line);
-        while(true) {
-            if(!stream_read_line(dict->stream, next_line)) break;
-            if(string_get_char(next_line, 0) == '#') continue;
-            if(string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-            dict->total_keys++;
+        // Keys are loaded once, attack iterates over memory
+        // Edited key keeps the file size, without modification time the cache can't be trusted
+        FileInfo source_info;
+        bool cacheable = storage_common_stat(storage, dict_path, &source_info) == FSE_OK &&
+                         source_info.mtime != 0;
+        if(!cacheable || !mf_classic_dict_load_cache(dict, storage, cache_path, &source_info)) {
+            mf_classic_dict_load_text(dict);
+            if(cacheable) mf_classic_dict_save_cache(dict, storage, cache_path, &source_info);
+        }
+        mf_classic_dict_order_by_hits(dict, storage);
+
+        // Only user dictionary can be modified
+        if(dict_type != MfClassicDictTypeUser) {
+            buffered_file_stream_close(dict->stream);
+            stream_free(dict->stream);
+            dict->stream = NULL;
         }
-        string_clear(next_line);
-        stream_rewind(dict->stream);
 
         dict_loaded = true;
         FURI_LOG_I(TAG, "Loaded dictionary with %d keys", dict->total_keys);
@@ -70,19 +353,49 @@ MfClassicDict* mf_classic_dict_alloc(MfClassicDictType dict_type) {
 
     if(!dict_loaded) {
         buffered_file_stream_close(dict->stream);
+        stream_free(dict->stream);
         free(dict);
         dict = NULL;
     }
 
+    furi_record_close(RECORD_STORAGE);
+
     return dict;
 }
 
 void mf_classic_dict_free(MfClassicDict* dict) {
     furi_assert(dict);
-    furi_assert(dict->stream);
 
-    buffered_file_stream_close(dict->stream);
-    stream_free(dict->stream);
+    if(dict->hits_new_count) {
+        // Merge with hits file, it could be updated by other dictionary meanwhile
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        MfClassicDictHit* hits = malloc(MF_CLASSIC_DICT_HITS_MAX * sizeof(MfClassicDictHit));
+        uint32_t count = mf_classic_dict_hits_load(storage, hits);
+        mf_classic_dict_hits_sort(hits, count);
+        for(uint32_t i = 0; i < dict->hits_new_count; i++) {
+            MfClassicDictHit* hit_new = &dict->hits_new[i];
+            uint32_t j = 0;
+            while(j < count && memcmp(hits[j].key, hit_new->key, MF_CLASSIC_DICT_KEY_SIZE)) j++;
+            if(j == count) {
+                // Replace the least frequent key if there is no space
+                if(count < MF_CLASSIC_DICT_HITS_MAX) count++;
+                j = count - 1;
+                memcpy(hits[j].key, hit_new->key, MF_CLASSIC_DICT_KEY_SIZE);
+                hits[j].hits = 0;
+            }
+            hits[j].hits = MIN((uint32_t)hits[j].hits + hit_new->hits, (uint32_t)UINT16_MAX);
+            mf_classic_dict_hits_sort(hits, count);
+        }
+        mf_classic_dict_hits_save(storage, hits, count);
+        free(hits);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    if(dict->stream) {
+        buffered_file_stream_close(dict->stream);
+        stream_free(dict->stream);
+    }
+    free(dict->keys);
     free(dict);
 }
 
@@ -94,35 +407,38 @@ uint32_t mf_classic_dict_get_total_keys(MfClassicDict* dict) {
 
 bool mf_classic_dict_get_next_key(MfClassicDict* dict, uint64_t* key) {
     furi_assert(dict);
-    furi_assert(dict->stream);
-
-    uint8_t key_byte_tmp = 0;
-    string_t next_line;
-    string_init(next_line);
 
-    bool key_read = false;
-    *key = 0ULL;
-    while(!key_read) {
-        if(!stream_read_line(dict->stream, next_line)) break;
-        if(string_get_char(next_line, 0) == '#') continue;
-        if(string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-        for(uint8_t i = 0; i < 12; i += 2) {
-            args_char_to_hex(
-                string_get_char(next_line, i), string_get_char(next_line, i + 1), &key_byte_tmp);
-            *key |= (uint64_t)key_byte_tmp << 8 * (5 - i / 2);
-        }
-        key_read = true;
-    }
+    if(dict->key_index >= dict->total_keys) return false;
 
-    string_clear(next_line);
-    return key_read;
+    *key = nfc_util_bytes2num(
+        &dict->keys[dict->key_index * MF_CLASSIC_DICT_KEY_SIZE], MF_CLASSIC_DICT_KEY_SIZE);
+    dict->key_index++;
+    return true;
 }
 
 bool mf_classic_dict_rewind(MfClassicDict* dict) {
     furi_assert(dict);
-    furi_assert(dict->stream);
 
-    return stream_rewind(dict->stream);
+    dict->key_index = 0;
+    return true;
+}
+
+void mf_classic_dict_add_hit(MfClassicDict* dict, uint64_t key) {
+    furi_assert(dict);
+
+    uint8_t key_bytes[MF_CLASSIC_DICT_KEY_SIZE];
+    nfc_util_num2bytes(key, MF_CLASSIC_DICT_KEY_SIZE, key_bytes);
+    for(uint32_t i = 0; i < dict->hits_new_count; i++) {
+        if(!memcmp(dict->hits_new[i].key, key_bytes, MF_CLASSIC_DICT_KEY_SIZE)) {
+            if(dict->hits_new[i].hits < UINT16_MAX) dict->hits_new[i].hits++;
+            return;
+        }
+    }
+    if(dict->hits_new_count < MF_CLASSIC_DICT_HITS_MAX) {
+        memcpy(dict->hits_new[dict->hits_new_count].key, key_bytes, MF_CLASSIC_DICT_KEY_SIZE);
+        dict->hits_new[dict->hits_new_count].hits = 1;
+        dict->hits_new_count++;
+    }
 }
 
 bool mf_classic_dict_add_key(MfClassicDict* dict, uint8_t* key) {
@@ -143,6 +459,59 @@ bool mf_classic_dict_add_key(MfClassicDict* dict, uint8_t* key) {
         key_added = true;
     } while(false);
 
+    if(key_added) {
+        bool is_duplicate = false;
+        for(uint32_t i = 0; i < dict->total_keys; i++) {
+            if(!memcmp(&dict->keys[i * MF_CLASSIC_DICT_KEY_SIZE], key, MF_CLASSIC_DICT_KEY_SIZE)) {
+                is_duplicate = true;
+                break;
+            }
+        }
+        if(!is_duplicate) {
+            if(dict->total_keys == dict->keys_capacity) {
+                dict->keys_capacity =
+                    MAX(dict->keys_capacity * 2, (uint32_t)MF_CLASSIC_DICT_KEYS_CAPACITY_MIN);
+                dict->keys = realloc(dict->keys, dict->keys_capacity * MF_CLASSIC_DICT_KEY_SIZE);
+            }
+            memcpy(
+                &dict->keys[dict->total_keys * MF_CLASSIC_DICT_KEY_SIZE],
+                key,
+                MF_CLASSIC_DICT_KEY_SIZE);
+            dict->total_keys++;
+        }
+    }
+
     string_clear(key_str);
     return key_added;
 }
+
+void mf_classic_dict_remove_keys_of(MfClassicDict* dict, MfClassicDict* other) {
+    furi_assert(dict);
+    furi_assert(other);
+
+    uint32_t table_size = mf_classic_dict_table_size(other->total_keys);
+    uint32_t* table = malloc(table_size * sizeof(uint32_t));
+    for(uint32_t i = 0; i < other->total_keys; i++) {
+        uint64_t key = nfc_util_bytes2num(
+            &other->keys[i * MF_CLASSIC_DICT_KEY_SIZE], MF_CLASSIC_DICT_KEY_SIZE);
+        uint32_t* slot = mf_classic_dict_table_find(table, table_size, other->keys, key);
+        if(!*slot) *slot = i + 1;
+    }
+
+    // Remaining keys keep their order
+    uint32_t kept = 0;
+    for(uint32_t i = 0; i < dict->total_keys; i++) {
+        uint8_t* key_bytes = &dict->keys[i * MF_CLASSIC_DICT_KEY_SIZE];
+        uint64_t key = nfc_util_bytes2num(key_bytes, MF_CLASSIC_DICT_KEY_SIZE);
+        if(*mf_classic_dict_table_find(table, table_size, other->keys, key)) continue;
+        memmove(&dict->keys[kept * MF_CLASSIC_DICT_KEY_SIZE], key_bytes, MF_CLASSIC_DICT_KEY_SIZE);
+        kept++;
+    }
+    free(table);
+
+    if(kept != dict->total_keys) {
+        FURI_LOG_I(TAG, "Removed %d keys present in other dictionary", dict->total_keys - kept);
+    }
+    dict->total_keys = kept;
+    dict->key_index = 0;
+}
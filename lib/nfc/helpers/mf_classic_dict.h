@@ -26,3 +26,8 @@ bool mf_classic_dict_get_next_key(MfClassicDict* dict, uint64_t* key);
 bool mf_classic_dict_rewind(MfClassicDict* dict);
 
 bool mf_classic_dict_add_key(MfClassicDict* dict, uint8_t* key);
+
+void mf_classic_dict_add_hit(MfClassicDict* dict, uint64_t key);
+
+/** Remove keys that are present in other dictionary, e.g. already tried ones */
+void mf_classic_dict_remove_keys_of(MfClassicDict* dict, MfClassicDict* other);
@@ -0,0 +1,444 @@
+#include "mfkey32.h"
+
+#include <furi.h>
+#include <inttypes.h>
+#include <lib/nfc/protocols/crypto1.h>
+#include <lib/nfc/protocols/nfc_util.h>
+
+// State recovery from 32 keystream bits, based on crapto1 lfsr_recovery32 by bla
+
+#define TAG "Mfkey32"
+
+#define MFKEY32_LF_POLY_ODD (0x29CE5C)
+#define MFKEY32_LF_POLY_EVEN (0x870804)
+
+#define MFKEY32_BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
+
+// Keystream bits consumed before candidate lists are split in windows
+#define MFKEY32_SIMPLE_STEPS (4)
+#define MFKEY32_WINDOW_STEPS (4)
+#define MFKEY32_REMAINING_STEPS (11 - MFKEY32_WINDOW_STEPS)
+// Candidates of one half after MFKEY32_SIMPLE_STEPS + MFKEY32_WINDOW_STEPS, on average
+#define MFKEY32_CANDIDATES (1 << 19)
+// Room for uneven windows and lists growth during recovery, measured peak is about 125%
+#define MFKEY32_HEADROOM_PERCENT (150)
+
+typedef struct {
+    const Mfkey32Params* params;
+    const Mfkey32SearchSpace* space;
+    uint32_t* odd;
+    uint32_t* even;
+    uint32_t capacity;
+    uint32_t odd_count;
+    uint32_t even_count;
+    uint32_t window_start;
+    uint32_t window_end;
+    bool overflow;
+    bool out_of_memory;
+    bool found;
+    uint64_t key;
+} Mfkey32Recovery;
+
+// Same as crypto1_filter, inlined as it is called for every candidate
+static inline uint32_t mfkey32_filter(uint32_t x) {
+    uint32_t f = 0xf22c0 >> (x & 0xf) & 16;
+    f |= 0x6c9c0 >> (x >> 4 & 0xf) & 8;
+    f |= 0x3c8b0 >> (x >> 8 & 0xf) & 4;
+    f |= 0x1e458 >> (x >> 12 & 0xf) & 2;
+    f |= 0x0d938 >> (x >> 16 & 0xf) & 1;
+    return FURI_BIT(0xEC57E80A, f);
+}
+
+static inline uint32_t
+    mfkey32_update_contribution(uint32_t item, uint32_t mask1, uint32_t mask2) {
+    uint32_t p = item >> 25;
+    p = p << 1 | nfc_util_even_parity32(item & mask1);
+    p = p << 1 | nfc_util_even_parity32(item & mask2);
+    return p << 24 | (item & 0xFFFFFF);
+}
+
+// Depth first extension of one initial candidate, leaves in window are appended to list
+static void mfkey32_generate(
+    Mfkey32Recovery* recovery,
+    uint32_t* list,
+    uint32_t* count,
+    uint32_t item,
+    uint32_t ks,
+    uint8_t step,
+    bool is_odd) {
+    if(step > MFKEY32_SIMPLE_STEPS) {
+        // Known high bits of contribution byte must fall in window
+        uint8_t shift = 2 * (MFKEY32_SIMPLE_STEPS + MFKEY32_WINDOW_STEPS - step);
+        uint32_t window_min = (item >> 24) << shift;
+        uint32_t window_max = window_min + (1 << shift);
+        if(window_max <= recovery->window_start || window_min >= recovery->window_end) return;
+    }
+    if(step == MFKEY32_SIMPLE_STEPS + MFKEY32_WINDOW_STEPS) {
+        if(*count < recovery->capacity) {
+            list[(*count)++] = item;
+        } else {
+            recovery->overflow = true;
+        }
+        return;
+    }
+
+    ks >>= 1;
+    uint32_t bit = ks & 1;
+    item <<= 1;
+    uint32_t mask1 = is_odd ? MFKEY32_LF_POLY_EVEN << 1 | 1 : MFKEY32_LF_POLY_ODD;
+    uint32_t mask2 = is_odd ? MFKEY32_LF_POLY_ODD << 1 : MFKEY32_LF_POLY_EVEN << 1 | 1;
+    bool with_contribution = step >= MFKEY32_SIMPLE_STEPS;
+    uint32_t filter_0 = mfkey32_filter(item);
+    uint32_t filter_1 = mfkey32_filter(item | 1);
+
+    if(filter_0 != filter_1) {
+        item |= filter_0 ^ bit;
+        if(with_contribution) item = mfkey32_update_contribution(item, mask1, mask2);
+        mfkey32_generate(recovery, list, count, item, ks, step + 1, is_odd);
+    } else if(filter_0 == bit) {
+        uint32_t item_0 = item;
+        uint32_t item_1 = item | 1;
+        if(with_contribution) {
+            item_0 = mfkey32_update_contribution(item_0, mask1, mask2);
+            item_1 = mfkey32_update_contribution(item_1, mask1, mask2);
+        }
+        mfkey32_generate(recovery, list, count, item_0, ks, step + 1, is_odd);
+        mfkey32_generate(recovery, list, count, item_1, ks, step + 1, is_odd);
+    }
+}
+
+static void mfkey32_generate_list(
+    Mfkey32Recovery* recovery,
+    uint32_t* list,
+    uint32_t* count,
+    uint32_t ks,
+    bool is_odd) {
+    uint32_t start = is_odd ? recovery->space->odd_start : recovery->space->even_start;
+    uint32_t end = is_odd ? recovery->space->odd_end : recovery->space->even_end;
+    *count = 0;
+    for(uint32_t i = start; i < end && !recovery->overflow; i++) {
+        if(mfkey32_filter(i) == (ks & 1)) {
+            mfkey32_generate(recovery, list, count, i, ks, 0, is_odd);
+        }
+    }
+}
+
+// In place extension of list by one keystream bit, list may grow up to limit
+static bool mfkey32_extend(
+    uint32_t* head,
+    uint32_t** tail,
+    const uint32_t* limit,
+    uint32_t bit,
+    uint32_t mask1,
+    uint32_t mask2) {
+    for(uint32_t* item = head; item <= *tail; item++) {
+        *item <<= 1;
+        uint32_t filter_0 = mfkey32_filter(*item);
+        uint32_t filter_1 = mfkey32_filter(*item | 1);
+        if(filter_0 != filter_1) {
+            *item |= filter_0 ^ bit;
+            *item = mfkey32_update_contribution(*item, mask1, mask2);
+        } else if(filter_0 == bit) {
+            if(*tail + 1 >= limit) return false;
+            // Move next unprocessed item to the end, it will be processed there
+            *++*tail = item[1];
+            item[1] = item[0] | 1;
+            *item = mfkey32_update_contribution(*item, mask1, mask2);
+            item++;
+            *item = mfkey32_update_contribution(*item, mask1, mask2);
+        } else {
+            *item-- = *(*tail)--;
+        }
+    }
+    return true;
+}
+
+static int mfkey32_compare(const void* a, const void* b) {
+    uint32_t value_a = *(const uint32_t*)a;
+    uint32_t value_b = *(const uint32_t*)b;
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+// First item of sorted list with the same contribution byte as *tail
+static uint32_t* mfkey32_group_start(uint32_t* head, uint32_t* tail) {
+    uint32_t value = *tail & 0xFF000000;
+    while(head < tail) {
+        uint32_t* middle = head + (tail - head) / 2;
+        if(*middle < value) {
+            head = middle + 1;
+        } else {
+            tail = middle;
+        }
+    }
+    return head;
+}
+
+static bool mfkey32_check_state(Mfkey32Recovery* recovery, uint32_t odd, uint32_t even) {
+    const Mfkey32Params* params = recovery->params;
+    Crypto1 crypto = {.odd = odd, .even = even};
+
+    crypto1_rollback_word(&crypto, 0, 0);
+    crypto1_rollback_word(&crypto, params->nr0, 1);
+    crypto1_rollback_word(&crypto, params->cuid ^ params->nt0, 0);
+    uint64_t key = crypto1_get_key(&crypto);
+
+    crypto1_init(&crypto, key);
+    crypto1_word(&crypto, params->cuid ^ params->nt1, 0);
+    crypto1_word(&crypto, params->nr1, 1);
+    if(params->ar1 == (crypto1_word(&crypto, 0, 0) ^ prng_successor(params->nt1, 64))) {
+        recovery->key = key;
+        return true;
+    }
+    return false;
+}
+
+static void mfkey32_check_lists(
+    Mfkey32Recovery* recovery,
+    uint32_t* o_head,
+    uint32_t* o_tail,
+    uint32_t* e_head,
+    uint32_t* e_tail) {
+    for(uint32_t* e = e_head; e <= e_tail && !recovery->found; e++) {
+        uint32_t even = *e << 1 ^ nfc_util_even_parity32(*e & MFKEY32_LF_POLY_EVEN);
+        for(uint32_t* o = o_head; o <= o_tail; o++) {
+            uint32_t odd = even ^ nfc_util_even_parity32(*o & MFKEY32_LF_POLY_ODD);
+            if(mfkey32_check_state(recovery, odd, *o)) {
+                recovery->found = true;
+                break;
+            }
+        }
+    }
+}
+
+// Lists are joined by contribution byte, matching groups are extended and joined again
+static void mfkey32_recover_lists(
+    Mfkey32Recovery* recovery,
+    uint32_t* o_head,
+    uint32_t* o_tail,
+    const uint32_t* o_limit,
+    uint32_t oks,
+    uint32_t* e_head,
+    uint32_t* e_tail,
+    const uint32_t* e_limit,
+    uint32_t eks,
+    int8_t rem) {
+    qsort(o_head, o_tail - o_head + 1, sizeof(uint32_t), mfkey32_compare);
+    qsort(e_head, e_tail - e_head + 1, sizeof(uint32_t), mfkey32_compare);
+
+    // Groups are processed from the end, so they may grow over already processed ones
+    while(o_tail >= o_head && e_tail >= e_head && !recovery->found && !recovery->overflow) {
+        if(((*o_tail ^ *e_tail) >> 24) != 0) {
+            if(*o_tail > *e_tail) {
+                o_tail = mfkey32_group_start(o_head, o_tail) - 1;
+            } else {
+                e_tail = mfkey32_group_start(e_head, e_tail) - 1;
+            }
+            continue;
+        }
+
+        uint32_t* o_start = mfkey32_group_start(o_head, o_tail);
+        uint32_t* e_start = mfkey32_group_start(e_head, e_tail);
+        if(rem == -1) {
+            mfkey32_check_lists(recovery, o_start, o_tail, e_start, e_tail);
+        } else {
+            uint32_t* o_end = o_tail;
+            uint32_t* e_end = e_tail;
+            uint32_t group_oks = oks;
+            uint32_t group_eks = eks;
+            int8_t group_rem = rem;
+            bool is_empty = false;
+            for(uint8_t i = 0; i < 4 && group_rem--; i++) {
+                group_oks >>= 1;
+                group_eks >>= 1;
+                if(!mfkey32_extend(
+                       o_start,
+                       &o_end,
+                       o_limit,
+                       group_oks & 1,
+                       MFKEY32_LF_POLY_EVEN << 1 | 1,
+                       MFKEY32_LF_POLY_ODD << 1) ||
+                   !mfkey32_extend(
+                       e_start,
+                       &e_end,
+                       e_limit,
+                       group_eks & 1,
+                       MFKEY32_LF_POLY_ODD,
+                       MFKEY32_LF_POLY_EVEN << 1 | 1)) {
+                    recovery->overflow = true;
+                    return;
+                }
+                is_empty = (o_start > o_end) || (e_start > e_end);
+                if(is_empty) break;
+            }
+            if(!is_empty) {
+                mfkey32_recover_lists(
+                    recovery,
+                    o_start,
+                    o_end,
+                    o_limit,
+                    group_oks,
+                    e_start,
+                    e_end,
+                    e_limit,
+                    group_eks,
+                    group_rem);
+            }
+        }
+        o_tail = o_start - 1;
+        e_tail = e_start - 1;
+    }
+}
+
+static void mfkey32_recover_window(Mfkey32Recovery* recovery, uint32_t oks, uint32_t eks) {
+    recovery->overflow = false;
+    mfkey32_generate_list(recovery, recovery->odd, &recovery->odd_count, oks, true);
+    mfkey32_generate_list(recovery, recovery->even, &recovery->even_count, eks, false);
+    if(!recovery->overflow && recovery->odd_count && recovery->even_count) {
+        uint8_t steps = MFKEY32_SIMPLE_STEPS + MFKEY32_WINDOW_STEPS;
+        mfkey32_recover_lists(
+            recovery,
+            recovery->odd,
+            recovery->odd + recovery->odd_count - 1,
+            recovery->odd + recovery->capacity,
+            oks >> steps,
+            recovery->even,
+            recovery->even + recovery->even_count - 1,
+            recovery->even + recovery->capacity,
+            eks >> steps,
+            MFKEY32_REMAINING_STEPS);
+    }
+
+    // Split window in halves if candidates do not fit
+    uint32_t window_start = recovery->window_start;
+    uint32_t window_end = recovery->window_end;
+    if(recovery->overflow && !recovery->found && window_end - window_start > 1) {
+        uint32_t window_middle = window_start + (window_end - window_start) / 2;
+        recovery->window_end = window_middle;
+        mfkey32_recover_window(recovery, oks, eks);
+        recovery->window_start = window_middle;
+        recovery->window_end = window_end;
+        mfkey32_recover_window(recovery, oks, eks);
+    } else if(recovery->overflow && !recovery->found) {
+        FURI_LOG_E(TAG, "Window %lu does not fit in memory", window_start);
+        recovery->out_of_memory = true;
+    }
+}
+
+Mfkey32Result mfkey32_recover_ex(
+    const Mfkey32Params* params,
+    size_t memory,
+    const Mfkey32SearchSpace* space,
+    uint64_t* key) {
+    furi_assert(params);
+    furi_assert(space);
+    furi_assert(key);
+    furi_assert(memory >= sizeof(uint32_t) * 2);
+    furi_assert(space->odd_end <= MFKEY32_STATES && space->even_end <= MFKEY32_STATES);
+    furi_assert(space->window_end <= MFKEY32_WINDOW_VALUES);
+
+    Mfkey32Recovery* recovery = malloc(sizeof(Mfkey32Recovery));
+    recovery->params = params;
+    recovery->space = space;
+    recovery->overflow = false;
+    recovery->out_of_memory = false;
+    recovery->found = false;
+    recovery->key = 0;
+    recovery->capacity = memory / sizeof(uint32_t) / 2;
+    recovery->odd = malloc(recovery->capacity * sizeof(uint32_t));
+    recovery->even = malloc(recovery->capacity * sizeof(uint32_t));
+
+    // Split keystream into bits generated by odd and even halves of LFSR
+    uint32_t ks = params->ar0 ^ prng_successor(params->nt0, 64);
+    uint32_t oks = 0;
+    uint32_t eks = 0;
+    for(int8_t i = 31; i >= 0; i -= 2) {
+        oks = oks << 1 | MFKEY32_BEBIT(ks, i);
+    }
+    for(int8_t i = 30; i >= 0; i -= 2) {
+        eks = eks << 1 | MFKEY32_BEBIT(ks, i);
+    }
+
+    uint32_t window_size = CLAMP(space->window_size, MFKEY32_WINDOW_VALUES, 1);
+    FURI_LOG_D(TAG, "Window size %lu, capacity %lu", window_size, recovery->capacity);
+    for(uint32_t start = space->window_start; start < space->window_end && !recovery->found;
+        start += window_size) {
+        recovery->window_start = start;
+        recovery->window_end = MIN(start + window_size, space->window_end);
+        mfkey32_recover_window(recovery, oks, eks);
+    }
+
+    Mfkey32Result result = Mfkey32ResultNotFound;
+    if(recovery->found) {
+        result = Mfkey32ResultFound;
+    } else if(recovery->out_of_memory) {
+        result = Mfkey32ResultOutOfMemory;
+    }
+    *key = recovery->key;
+
+    free(recovery->odd);
+    free(recovery->even);
+    free(recovery);
+
+    return result;
+}
+
+Mfkey32Result mfkey32_recover(const Mfkey32Params* params, size_t memory, uint64_t* key) {
+    furi_assert(memory >= MFKEY32_MEMORY_MIN);
+
+    uint32_t capacity = memory / sizeof(uint32_t) / 2;
+    Mfkey32SearchSpace space = {
+        .odd_start = 0,
+        .odd_end = MFKEY32_STATES,
+        .even_start = 0,
+        .even_end = MFKEY32_STATES,
+        .window_start = 0,
+        .window_end = MFKEY32_WINDOW_VALUES,
+        .window_size = (uint64_t)capacity * MFKEY32_WINDOW_VALUES * 100 / MFKEY32_CANDIDATES /
+                       MFKEY32_HEADROOM_PERCENT,
+    };
+    return mfkey32_recover_ex(params, memory, &space, key);
+}
+
+bool mfkey32_parse_line(const char* line, Mfkey32Params* params) {
+    furi_assert(line);
+    furi_assert(params);
+
+    unsigned int sector = 0;
+    char key_type = 0;
+    int parsed = sscanf(
+        line,
+        "Sec %u key %c cuid %" SCNx32 " nt0 %" SCNx32 " nr0 %" SCNx32 " ar0 %" SCNx32
+        " nt1 %" SCNx32 " nr1 %" SCNx32 " ar1 %" SCNx32,
+        &sector,
+        &key_type,
+        &params->cuid,
+        &params->nt0,
+        &params->nr0,
+        &params->ar0,
+        &params->nt1,
+        &params->nr1,
+        &params->ar1);
+    if(parsed != 9 || (key_type != 'A' && key_type != 'B')) return false;
+
+    params->sector = sector;
+    params->key_type = (key_type == 'A') ? MfClassicKeyA : MfClassicKeyB;
+    return true;
+}
+
+void mfkey32_format_line(const Mfkey32Params* params, string_t line) {
+    furi_assert(params);
+
+    string_printf(
+        line,
+        "Sec %d key %c cuid %08" PRIx32 " nt0 %08" PRIx32 " nr0 %08" PRIx32 " ar0 %08" PRIx32
+        " nt1 %08" PRIx32 " nr1 %08" PRIx32 " ar1 %08" PRIx32,
+        params->sector,
+        (params->key_type == MfClassicKeyA) ? 'A' : 'B',
+        params->cuid,
+        params->nt0,
+        params->nr0,
+        params->ar0,
+        params->nt1,
+        params->nr1,
+        params->ar1);
+}
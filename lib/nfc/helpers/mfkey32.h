@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <m-string.h>
+
+#include <lib/nfc/protocols/mifare_classic.h>
+
+#define MFKEY32_MEMORY_DEFAULT (96 * 1024)
+#define MFKEY32_MEMORY_MIN (32 * 1024)
+
+// Initial states of one LFSR half
+#define MFKEY32_STATES (1 << 20)
+// Candidates are searched in windows of contribution byte values
+#define MFKEY32_WINDOW_VALUES (256)
+
+typedef enum {
+    Mfkey32ResultFound,
+    Mfkey32ResultNotFound,
+    Mfkey32ResultOutOfMemory, /** Some candidates did not fit in memory budget */
+} Mfkey32Result;
+
+typedef struct {
+    uint32_t cuid;
+    uint8_t sector;
+    MfClassicKey key_type;
+    uint32_t nt0;
+    uint32_t nr0;
+    uint32_t ar0;
+    uint32_t nt1;
+    uint32_t nr1;
+    uint32_t ar1;
+} Mfkey32Params;
+
+typedef struct {
+    uint32_t odd_start; /** first initial state of odd half candidates */
+    uint32_t odd_end; /** initial state after the last one, up to MFKEY32_STATES */
+    uint32_t even_start;
+    uint32_t even_end;
+    uint32_t window_start; /** first contribution byte value */
+    uint32_t window_end; /** value after the last one, up to MFKEY32_WINDOW_VALUES */
+    uint32_t window_size; /** windows whose candidates do not fit in memory are split */
+} Mfkey32SearchSpace;
+
+/** Recover sector key from two authentications sniffed with the same key
+ *
+ * Candidate LFSR states are generated in passes, each pass keeps only a part of
+ * them, so memory usage is bounded while the time grows with the passes count.
+ *
+ * @param      params  nonces of two authentications
+ * @param      memory  memory budget in bytes for the candidate lists
+ * @param      key     recovered key
+ *
+ * @return     Mfkey32ResultFound if key found, Mfkey32ResultOutOfMemory if key was not
+ *             found and some windows did not fit in memory even after splitting
+ */
+Mfkey32Result mfkey32_recover(const Mfkey32Params* params, size_t memory, uint64_t* key);
+
+/** Recover sector key from a part of the search space
+ *
+ * Every window pass enumerates all initial states in the space, so the time grows
+ * with both the states range and the windows count. Parts are useful for tests,
+ * mfkey32_recover searches the whole space.
+ *
+ * @param      params  nonces of two authentications
+ * @param      memory  memory budget in bytes for the candidate lists
+ * @param      space   part of the search space
+ * @param      key     recovered key
+ *
+ * @return     same as mfkey32_recover
+ */
+Mfkey32Result mfkey32_recover_ex(
+    const Mfkey32Params* params,
+    size_t memory,
+    const Mfkey32SearchSpace* space,
+    uint64_t* key);
+
+/** Parse one line of mfkey32 log
+ *
+ * @param      line    log line
+ * @param      params  parsed nonces
+ *
+ * @return     true on success
+ */
+bool mfkey32_parse_line(const char* line, Mfkey32Params* params);
+
+/** Format one line of mfkey32 log, without line ending
+ *
+ * @param      params  nonces to format
+ * @param      line    output string
+ */
+void mfkey32_format_line(const Mfkey32Params* params, string_t line);
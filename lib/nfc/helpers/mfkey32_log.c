@@ -0,0 +1,128 @@
+#include "mfkey32_log.h"
+
+#include <furi.h>
+#include <lib/toolbox/stream/file_stream.h>
+
+#define TAG "Mfkey32Log"
+
+#define MFKEY32_LOG_PENDING_MAX (16)
+#define MFKEY32_LOG_PAIRS_MAX (32)
+
+typedef struct {
+    uint8_t sector;
+    MfClassicKey key_type;
+    uint32_t nt;
+    uint32_t nr;
+    uint32_t ar;
+} Mfkey32LogAuth;
+
+struct Mfkey32Log {
+    uint32_t cuid;
+    // First authentications waiting for a second one with the same key
+    Mfkey32LogAuth pending[MFKEY32_LOG_PENDING_MAX];
+    uint8_t pending_count;
+    uint8_t pending_next;
+    Mfkey32Params pairs[MFKEY32_LOG_PAIRS_MAX];
+    uint16_t pairs_count;
+};
+
+Mfkey32Log* mfkey32_log_alloc(uint32_t cuid) {
+    Mfkey32Log* instance = malloc(sizeof(Mfkey32Log));
+    instance->cuid = cuid;
+    return instance;
+}
+
+void mfkey32_log_free(Mfkey32Log* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+void mfkey32_log_add_auth(
+    uint8_t sector,
+    MfClassicKey key_type,
+    uint32_t nt,
+    uint32_t nr,
+    uint32_t ar,
+    void* context) {
+    furi_assert(context);
+    Mfkey32Log* instance = context;
+
+    for(uint16_t i = 0; i < instance->pairs_count; i++) {
+        if(instance->pairs[i].sector == sector && instance->pairs[i].key_type == key_type) {
+            return;
+        }
+    }
+
+    for(uint8_t i = 0; i < instance->pending_count; i++) {
+        Mfkey32LogAuth* auth = &instance->pending[i];
+        if(auth->sector != sector || auth->key_type != key_type) continue;
+        // Same nonce gives no new information
+        if(auth->nt == nt) return;
+        if(instance->pairs_count < MFKEY32_LOG_PAIRS_MAX) {
+            Mfkey32Params* pair = &instance->pairs[instance->pairs_count++];
+            pair->cuid = instance->cuid;
+            pair->sector = sector;
+            pair->key_type = key_type;
+            pair->nt0 = auth->nt;
+            pair->nr0 = auth->nr;
+            pair->ar0 = auth->ar;
+            pair->nt1 = nt;
+            pair->nr1 = nr;
+            pair->ar1 = ar;
+        }
+        return;
+    }
+
+    // Oldest pending authentication is replaced when there is no room
+    Mfkey32LogAuth* auth = &instance->pending[instance->pending_next];
+    instance->pending_next = (instance->pending_next + 1) % MFKEY32_LOG_PENDING_MAX;
+    if(instance->pending_count < MFKEY32_LOG_PENDING_MAX) instance->pending_count++;
+    auth->sector = sector;
+    auth->key_type = key_type;
+    auth->nt = nt;
+    auth->nr = nr;
+    auth->ar = ar;
+}
+
+uint16_t mfkey32_log_get_pairs_count(Mfkey32Log* instance) {
+    furi_assert(instance);
+    return instance->pairs_count;
+}
+
+bool mfkey32_log_save(Mfkey32Log* instance, Storage* storage) {
+    furi_assert(instance);
+    furi_assert(storage);
+
+    if(!instance->pairs_count) return true;
+
+    bool saved = false;
+    string_t line;
+    string_init(line);
+    Stream* stream = file_stream_alloc(storage);
+
+    do {
+        if(!file_stream_open(stream, MFKEY32_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            FURI_LOG_E(TAG, "Failed to open log file");
+            break;
+        }
+        uint16_t i = 0;
+        for(; i < instance->pairs_count; i++) {
+            mfkey32_format_line(&instance->pairs[i], line);
+            string_cat_str(line, "\n");
+            if(stream_write_string(stream, line) != string_size(line)) break;
+        }
+        if(i != instance->pairs_count) {
+            FURI_LOG_E(TAG, "Failed to write log file");
+            break;
+        }
+        FURI_LOG_I(TAG, "Saved %d nonce pairs", instance->pairs_count);
+        instance->pairs_count = 0;
+        saved = true;
+    } while(false);
+
+    file_stream_close(stream);
+    stream_free(stream);
+    string_clear(line);
+
+    return saved;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "mfkey32.h"
+
+#include <storage/storage.h>
+
+#define MFKEY32_LOG_PATH EXT_PATH("nfc/.mfkey32.log")
+
+typedef struct Mfkey32Log Mfkey32Log;
+
+Mfkey32Log* mfkey32_log_alloc(uint32_t cuid);
+
+void mfkey32_log_free(Mfkey32Log* instance);
+
+void mfkey32_log_add_auth(
+    uint8_t sector,
+    MfClassicKey key_type,
+    uint32_t nt,
+    uint32_t nr,
+    uint32_t ar,
+    void* context);
+
+uint16_t mfkey32_log_get_pairs_count(Mfkey32Log* instance);
+
+bool mfkey32_log_save(Mfkey32Log* instance, Storage* storage);
@@ -397,6 +397,50 @@ void nfc_worker_emulate_mf_ultralight(NfcWorker* nfc_worker) {
     }
 }
 
+static void nfc_worker_mf_classic_set_key_found(
+    NfcWorker* nfc_worker,
+    MfClassicDict* dict,
+    uint8_t sector,
+    MfClassicKey key_type,
+    uint64_t key) {
+    MfClassicData* data = &nfc_worker->dev_data->mf_classic_data;
+
+    mf_classic_set_key_found(data, sector, key_type, key);
+    mf_classic_dict_add_hit(dict, key);
+    nfc_worker->callback(
+        (key_type == MfClassicKeyA) ? NfcWorkerEventFoundKeyA : NfcWorkerEventFoundKeyB,
+        nfc_worker->context);
+}
+
+// Cards often reuse keys, so a found key is tried on all remaining sectors
+static void nfc_worker_mf_classic_key_reuse(
+    NfcWorker* nfc_worker,
+    FuriHalNfcTxRxContext* tx_rx,
+    MfClassicDict* dict,
+    uint64_t key,
+    uint8_t first_sector) {
+    MfClassicData* data = &nfc_worker->dev_data->mf_classic_data;
+    uint8_t total_sectors = mf_classic_get_total_sectors_num(data->type);
+
+    for(uint8_t i = first_sector; i < total_sectors; i++) {
+        if(nfc_worker->state != NfcWorkerStateMfClassicDictAttack) break;
+        if(mf_classic_is_sector_read(data, i)) continue;
+        uint8_t block_num = mf_classic_get_sector_trailer_block_num_by_sector(i);
+        if(!mf_classic_is_key_found(data, i, MfClassicKeyA)) {
+            if(mf_classic_authenticate(tx_rx, block_num, key, MfClassicKeyA)) {
+                FURI_LOG_D(TAG, "Key reused for sector %d key A", i);
+                nfc_worker_mf_classic_set_key_found(nfc_worker, dict, i, MfClassicKeyA, key);
+            }
+        }
+        if(!mf_classic_is_key_found(data, i, MfClassicKeyB)) {
+            if(mf_classic_authenticate(tx_rx, block_num, key, MfClassicKeyB)) {
+                FURI_LOG_D(TAG, "Key reused for sector %d key B", i);
+                nfc_worker_mf_classic_set_key_found(nfc_worker, dict, i, MfClassicKeyB, key);
+            }
+        }
+    }
+}
+
 void nfc_worker_mf_classic_dict_attack(NfcWorker* nfc_worker) {
     furi_assert(nfc_worker);
     furi_assert(nfc_worker->callback);
@@ -406,6 +450,7 @@ void nfc_worker_mf_classic_dict_attack(NfcWorker* nfc_worker) {
         &nfc_worker->dev_data->mf_classic_dict_attack_data;
     uint32_t total_sectors = mf_classic_get_total_sectors_num(data->type);
     uint64_t key = 0;
+    uint32_t cuid = 0;
     FuriHalNfcTxRxContext tx_rx = {};
     bool card_found_notified = true;
     bool card_removed_notified = false;
@@ -418,6 +463,26 @@ void nfc_worker_mf_classic_dict_attack(NfcWorker* nfc_worker) {
         return;
     }
 
+    // Keys known before attack are tried on all sectors first
+    uint64_t* known_keys = malloc(total_sectors * 2 * sizeof(uint64_t));
+    size_t known_keys_count = 0;
+    for(size_t i = 0; i < total_sectors; i++) {
+        MfClassicSectorTrailer* sec_tr = mf_classic_get_sector_trailer_by_sector(data, i);
+        for(uint8_t j = 0; j < 2; j++) {
+            MfClassicKey key_type = j ? MfClassicKeyB : MfClassicKeyA;
+            if(!mf_classic_is_key_found(data, i, key_type)) continue;
+            uint8_t* key_bytes = (key_type == MfClassicKeyA) ? sec_tr->key_a : sec_tr->key_b;
+            key = nfc_util_bytes2num(key_bytes, 6);
+            size_t k = 0;
+            while(k < known_keys_count && known_keys[k] != key) k++;
+            if(k == known_keys_count) known_keys[known_keys_count++] = key;
+        }
+    }
+    for(size_t i = 0; i < known_keys_count; i++) {
+        nfc_worker_mf_classic_key_reuse(nfc_worker, &tx_rx, dict, known_keys[i], 0);
+    }
+    free(known_keys);
+
     FURI_LOG_D(TAG, "Start Dictionary attack, Key Count %d", mf_classic_dict_get_total_keys(dict));
     for(size_t i = 0; i < total_sectors; i++) {
         FURI_LOG_I(TAG, "Sector %d", i);
@@ -427,13 +492,12 @@ void nfc_worker_mf_classic_dict_attack(NfcWorker* nfc_worker) {
         bool is_key_a_found = mf_classic_is_key_found(data, i, MfClassicKeyA);
         bool is_key_b_found = mf_classic_is_key_found(data, i, MfClassicKeyB);
         uint16_t key_index = 0;
-        while(mf_classic_dict_get_next_key(dict, &key)) {
+        while(!(is_key_a_found && is_key_b_found) && mf_classic_dict_get_next_key(dict, &key)) {
             if(++key_index % NFC_DICT_KEY_BATCH_SIZE == 0) {
                 nfc_worker->callback(NfcWorkerEventNewDictKeyBatch, nfc_worker->context);
             }
             furi_hal_nfc_sleep();
-            if(furi_hal_nfc_activate_nfca(200, NULL)) {
-                furi_hal_nfc_sleep();
+            if(furi_hal_nfc_activate_nfca(200, &cuid)) {
                 if(!card_found_notified) {
                     nfc_worker->callback(NfcWorkerEventCardDetected, nfc_worker->context);
                     card_found_notified = true;
@@ -445,22 +509,31 @@ void nfc_worker_mf_classic_dict_attack(NfcWorker* nfc_worker) {
                     i,
                     (uint32_t)(key >> 32),
                     (uint32_t)key);
+                // First attempt reuses presence check activation
+                bool is_activated = true;
+                bool is_new_key = false;
                 if(!is_key_a_found) {
-                    is_key_a_found = mf_classic_is_key_found(data, i, MfClassicKeyA);
-                    if(mf_classic_authenticate(&tx_rx, block_num, key, MfClassicKeyA)) {
-                        mf_classic_set_key_found(data, i, MfClassicKeyA, key);
-                        nfc_worker->callback(NfcWorkerEventFoundKeyA, nfc_worker->context);
+                    if(mf_classic_authenticate_skip_activate(
+                           &tx_rx, block_num, key, MfClassicKeyA, is_activated, cuid)) {
+                        nfc_worker_mf_classic_set_key_found(
+                            nfc_worker, dict, i, MfClassicKeyA, key);
+                        is_key_a_found = true;
+                        is_new_key = true;
                     }
-                    furi_hal_nfc_sleep();
+                    is_activated = false;
                 }
                 if(!is_key_b_found) {
-                    is_key_b_found = mf_classic_is_key_found(data, i, MfClassicKeyB);
-                    if(mf_classic_authenticate(&tx_rx, block_num, key, MfClassicKeyB)) {
-                        mf_classic_set_key_found(data, i, MfClassicKeyB, key);
-                        nfc_worker->callback(NfcWorkerEventFoundKeyB, nfc_worker->context);
+                    if(mf_classic_authenticate_skip_activate(
+                           &tx_rx, block_num, key, MfClassicKeyB, is_activated, cuid)) {
+                        nfc_worker_mf_classic_set_key_found(
+                            nfc_worker, dict, i, MfClassicKeyB, key);
+                        is_key_b_found = true;
+                        is_new_key = true;
                     }
                 }
-                if(is_key_a_found && is_key_b_found) break;
+                if(is_new_key) {
+                    nfc_worker_mf_classic_key_reuse(nfc_worker, &tx_rx, dict, key, i + 1);
+                }
                 if(nfc_worker->state != NfcWorkerStateMfClassicDictAttack) break;
             } else {
                 if(!card_removed_notified) {
@@ -491,6 +564,10 @@ void nfc_worker_emulate_mf_classic(NfcWorker* nfc_worker) {
         .data = nfc_worker->dev_data->mf_classic_data,
         .data_changed = false,
     };
+    // Reader nonces are kept for offline key recovery
+    Mfkey32Log* mfkey32_log = mfkey32_log_alloc(emulator.cuid);
+    emulator.auth_callback = mfkey32_log_add_auth;
+    emulator.auth_context = mfkey32_log;
     NfcaSignal* nfca_signal = nfca_signal_alloc();
     tx_rx.nfca_signal = nfca_signal;
 
@@ -513,6 +590,9 @@ void nfc_worker_emulate_mf_classic(NfcWorker* nfc_worker) {
     nfca_signal_free(nfca_signal);
 
     rfal_platform_spi_release();
+
+    mfkey32_log_save(mfkey32_log, nfc_worker->storage);
+    mfkey32_log_free(mfkey32_log);
 }
 
 void nfc_worker_mf_ultralight_read_auth(NfcWorker* nfc_worker) {
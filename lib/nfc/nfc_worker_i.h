@@ -14,6 +14,7 @@
 #include <lib/nfc/protocols/nfca.h>
 
 #include "helpers/nfc_debug_pcap.h"
+#include "helpers/mfkey32_log.h"
 
 struct NfcWorker {
     FuriThread* thread;
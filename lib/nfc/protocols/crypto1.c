@@ -10,6 +10,31 @@
 
 #define BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
 
+// Filter input bits 0-7 and 8-15 mapped to filter output index bits 4-3 and 2-1
+static const uint8_t crypto1_filter_lut_lo[256] = {
+    0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0, 16, 16, 16, 16, 0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0,
+    16, 16, 16, 16, 0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0, 16, 16, 16, 16, 8, 8, 24, 24, 8, 24, 8,
+    8, 8, 24, 8, 8, 24, 24, 24, 24, 8, 8, 24, 24, 8, 24, 8, 8, 8, 24, 8, 8, 24, 24, 24, 24, 8, 8,
+    24, 24, 8, 24, 8, 8, 8, 24, 8, 8, 24, 24, 24, 24, 0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0, 16,
+    16, 16, 16, 0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0, 16, 16, 16, 16, 8, 8, 24, 24, 8, 24, 8, 8,
+    8, 24, 8, 8, 24, 24, 24, 24, 0, 0, 16, 16, 0, 16, 0, 0, 0, 16, 0, 0, 16, 16, 16, 16, 0, 0, 16,
+    16, 0, 16, 0, 0, 0, 16, 0, 0, 16, 16, 16, 16, 8, 8, 24, 24, 8, 24, 8, 8, 8, 24, 8, 8, 24, 24,
+    24, 24, 8, 8, 24, 24, 8, 24, 8, 8, 8, 24, 8, 8, 24, 24, 24, 24, 0, 0, 16, 16, 0, 16, 0, 0, 0,
+    16, 0, 0, 16, 16, 16, 16, 8, 8, 24, 24, 8, 24, 8, 8, 8, 24, 8, 8, 24, 24, 24, 24, 8, 8, 24, 24,
+    8, 24, 8, 8, 8, 24, 8, 8, 24, 24, 24, 24,
+};
+
+static const uint8_t crypto1_filter_lut_hi[256] = {
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4,
+    2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6,
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6,
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4,
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6,
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4,
+    2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6,
+    2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6,
+};
+
 void crypto1_reset(Crypto1* crypto1) {
     furi_assert(crypto1);
     crypto1->even = 0;
@@ -26,50 +51,180 @@ void crypto1_init(Crypto1* crypto1, uint64_t key) {
     }
 }
 
-uint32_t crypto1_filter(uint32_t in) {
-    uint32_t out = 0;
-    out = 0xf22c0 >> (in & 0xf) & 16;
-    out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
-    out |= 0x3c8b0 >> (in >> 8 & 0xf) & 4;
-    out |= 0x1e458 >> (in >> 12 & 0xf) & 2;
+static inline uint32_t crypto1_filter_inline(uint32_t in) {
+    uint32_t out = crypto1_filter_lut_lo[in & 0xff] | crypto1_filter_lut_hi[in >> 8 & 0xff];
     out |= 0x0d938 >> (in >> 16 & 0xf) & 1;
     return FURI_BIT(0xEC57E80A, out);
 }
 
+uint32_t crypto1_filter(uint32_t in) {
+    return crypto1_filter_inline(in);
+}
+
+// One LFSR step, in and is_encrypted must be 0 or 1
+static inline uint32_t crypto1_step(Crypto1* crypto1, uint32_t in, uint32_t is_encrypted) {
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
+    uint32_t out = crypto1_filter_inline(odd);
+    uint32_t feed = (out & is_encrypted) ^ in ^ (LF_POLY_ODD & odd) ^ (LF_POLY_EVEN & even);
+    crypto1->odd = even << 1 | nfc_util_even_parity32(feed);
+    crypto1->even = odd;
+    return out;
+}
+
 uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
-    uint8_t out = crypto1_filter(crypto1->odd);
-    uint32_t feed = out & (!!is_encrypted);
-    feed ^= !!in;
-    feed ^= LF_POLY_ODD & crypto1->odd;
-    feed ^= LF_POLY_EVEN & crypto1->even;
-    crypto1->even = crypto1->even << 1 | (nfc_util_even_parity32(feed));
-
-    FURI_SWAP(crypto1->odd, crypto1->even);
-    return out;
+    return crypto1_step(crypto1, !!in, !!is_encrypted);
 }
 
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
-    uint8_t out = 0;
+    uint32_t encrypted = !!is_encrypted;
+    uint32_t out = 0;
     for(uint8_t i = 0; i < 8; i++) {
-        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+        out |= crypto1_step(crypto1, FURI_BIT(in, i), encrypted) << i;
     }
     return out;
 }
 
 uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     furi_assert(crypto1);
+    uint32_t encrypted = !!is_encrypted;
     uint32_t out = 0;
     for(uint8_t i = 0; i < 32; i++) {
-        out |= crypto1_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+        out |= crypto1_step(crypto1, BEBIT(in, i), encrypted) << (24 ^ i);
     }
     return out;
 }
 
+uint8_t crypto1_rollback_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint32_t odd = crypto1->even & 0xFFFFFF;
+    uint32_t even = crypto1->odd & 0xFFFFFF;
+    uint32_t out = crypto1_filter_inline(odd);
+    uint32_t feed = (even & 1) ^ (out & !!is_encrypted) ^ !!in;
+    even >>= 1;
+    feed ^= (LF_POLY_ODD & odd) ^ (LF_POLY_EVEN & even);
+    crypto1->odd = odd;
+    crypto1->even = even | nfc_util_even_parity32(feed) << 23;
+    return out;
+}
+
+uint32_t crypto1_rollback_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint32_t out = 0;
+    for(int8_t i = 31; i >= 0; i--) {
+        out |= crypto1_rollback_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+    }
+    return out;
+}
+
+uint64_t crypto1_get_key(Crypto1* crypto1) {
+    furi_assert(crypto1);
+    uint64_t key = 0;
+    for(int8_t i = 23; i >= 0; i--) {
+        key = key << 1 | FURI_BIT(crypto1->odd, i ^ 3);
+        key = key << 1 | FURI_BIT(crypto1->even, i ^ 3);
+    }
+    return key;
+}
+
 uint32_t prng_successor(uint32_t x, uint32_t n) {
     SWAPENDIAN(x);
     while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
 
     return SWAPENDIAN(x);
 }
+
+// Truth table lookup for bitsliced inputs, bit N of in[0] is bit 0 of table index for key N
+static inline uint32_t crypto1_bitsliced_lut(uint32_t table, const uint32_t* in, uint8_t bits) {
+    uint32_t value[32];
+    uint8_t count = 1 << bits;
+    for(uint8_t i = 0; i < count; i++) {
+        value[i] = FURI_BIT(table, i) ? 0xFFFFFFFF : 0;
+    }
+    for(uint8_t i = 0; i < bits; i++) {
+        count >>= 1;
+        for(uint8_t j = 0; j < count; j++) {
+            value[j] = (value[2 * j] & ~in[i]) | (value[2 * j + 1] & in[i]);
+        }
+    }
+    return value[0];
+}
+
+static uint32_t crypto1_bitsliced_filter(const uint32_t* odd) {
+    // Nibble functions of crypto1_filter, output index from bit 0 to bit 4
+    uint32_t index[5] = {
+        crypto1_bitsliced_lut(0xd938, &odd[16], 4),
+        crypto1_bitsliced_lut(0xf22c, &odd[12], 4),
+        crypto1_bitsliced_lut(0xf22c, &odd[8], 4),
+        crypto1_bitsliced_lut(0xd938, &odd[4], 4),
+        crypto1_bitsliced_lut(0xf22c, &odd[0], 4),
+    };
+    return crypto1_bitsliced_lut(0xEC57E80A, index, 5);
+}
+
+void crypto1_bitsliced_init(Crypto1Bitsliced* crypto1, const uint64_t* keys, uint8_t count) {
+    furi_assert(crypto1);
+    furi_assert(keys);
+    furi_assert(count <= CRYPTO1_BITSLICED_KEYS);
+
+    memset(crypto1, 0, sizeof(Crypto1Bitsliced));
+    for(uint8_t j = 0; j < count; j++) {
+        for(uint8_t i = 0; i < 24; i++) {
+            crypto1->odd[23 - i] |= FURI_BIT(keys[j], (46 - 2 * i) ^ 7) << j;
+            crypto1->even[23 - i] |= FURI_BIT(keys[j], (47 - 2 * i) ^ 7) << j;
+        }
+    }
+}
+
+uint32_t crypto1_bitsliced_bit(Crypto1Bitsliced* crypto1, uint32_t in, int is_encrypted) {
+    furi_assert(crypto1);
+
+    uint32_t out = crypto1_bitsliced_filter(crypto1->odd);
+    uint32_t feed = in ^ (is_encrypted ? out : 0);
+    for(uint8_t i = 0; i < 24; i++) {
+        if(FURI_BIT(LF_POLY_ODD, i)) feed ^= crypto1->odd[i];
+        if(FURI_BIT(LF_POLY_EVEN, i)) feed ^= crypto1->even[i];
+    }
+    // even = even << 1 | feed, then swap with odd
+    uint32_t odd[24];
+    memcpy(odd, crypto1->odd, sizeof(odd));
+    crypto1->odd[0] = feed;
+    memcpy(&crypto1->odd[1], crypto1->even, 23 * sizeof(uint32_t));
+    memcpy(crypto1->even, odd, sizeof(odd));
+    return out;
+}
+
+uint32_t crypto1_bitsliced_check_keys(
+    const uint64_t* keys,
+    uint8_t count,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc) {
+    furi_assert(keys);
+
+    Crypto1Bitsliced* crypto1 = malloc(sizeof(Crypto1Bitsliced));
+    crypto1_bitsliced_init(crypto1, keys, count);
+
+    // Same bit order as crypto1_word
+    uint32_t in = nt ^ cuid;
+    for(uint8_t i = 0; i < 32; i++) {
+        crypto1_bitsliced_bit(crypto1, BEBIT(in, i) ? 0xFFFFFFFF : 0, 0);
+    }
+    for(uint8_t i = 0; i < 32; i++) {
+        crypto1_bitsliced_bit(crypto1, BEBIT(nr_enc, i) ? 0xFFFFFFFF : 0, 1);
+    }
+    // Keystream must decrypt reader answer to nt successor
+    uint32_t ks = ar_enc ^ prng_successor(nt, 64);
+    uint32_t mismatch = 0;
+    for(uint8_t i = 0; i < 32; i++) {
+        uint32_t out = crypto1_bitsliced_bit(crypto1, 0, 0);
+        mismatch |= out ^ (FURI_BIT(ks, 24 ^ i) ? 0xFFFFFFFF : 0);
+    }
+    free(crypto1);
+
+    uint32_t valid_keys = (count < 32) ? ((1UL << count) - 1) : 0xFFFFFFFF;
+    return ~mismatch & valid_keys;
+}
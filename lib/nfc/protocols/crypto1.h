@@ -3,11 +3,19 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define CRYPTO1_BITSLICED_KEYS (32)
+
 typedef struct {
     uint32_t odd;
     uint32_t even;
 } Crypto1;
 
+// Up to 32 cipher states at once, bit N of every word belongs to key N
+typedef struct {
+    uint32_t odd[24];
+    uint32_t even[24];
+} Crypto1Bitsliced;
+
 void crypto1_reset(Crypto1* crypto1);
 
 void crypto1_init(Crypto1* crypto1, uint64_t key);
@@ -18,6 +26,24 @@ uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted);
 
 uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
 
+uint8_t crypto1_rollback_bit(Crypto1* crypto1, uint8_t in, int is_encrypted);
+
+uint32_t crypto1_rollback_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
+
+uint64_t crypto1_get_key(Crypto1* crypto1);
+
 uint32_t crypto1_filter(uint32_t in);
 
 uint32_t prng_successor(uint32_t x, uint32_t n);
+
+void crypto1_bitsliced_init(Crypto1Bitsliced* crypto1, const uint64_t* keys, uint8_t count);
+
+uint32_t crypto1_bitsliced_bit(Crypto1Bitsliced* crypto1, uint32_t in, int is_encrypted);
+
+uint32_t crypto1_bitsliced_check_keys(
+    const uint64_t* keys,
+    uint8_t count,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc);
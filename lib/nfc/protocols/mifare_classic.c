@@ -371,20 +371,21 @@ void mf_classic_auth_init_context(MfClassicAuthContext* auth_ctx, uint8_t sector
     auth_ctx->key_b = MF_CLASSIC_NO_KEY;
 }
 
-static bool mf_classic_auth(
+static bool mf_classic_auth_skip_activate(
     FuriHalNfcTxRxContext* tx_rx,
     uint32_t block,
     uint64_t key,
     MfClassicKey key_type,
-    Crypto1* crypto) {
+    Crypto1* crypto,
+    bool skip_activate,
+    uint32_t cuid) {
     bool auth_success = false;
-    uint32_t cuid = 0;
     memset(tx_rx->tx_data, 0, sizeof(tx_rx->tx_data));
     memset(tx_rx->tx_parity, 0, sizeof(tx_rx->tx_parity));
     tx_rx->tx_rx_type = FuriHalNfcTxRxTypeDefault;
 
     do {
-        if(!furi_hal_nfc_activate_nfca(200, &cuid)) break;
+        if(!skip_activate && !furi_hal_nfc_activate_nfca(200, &cuid)) break;
         if(key_type == MfClassicKeyA) {
             tx_rx->tx_data[0] = MF_CLASSIC_AUTH_KEY_A_CMD;
         } else {
@@ -425,6 +426,15 @@ static bool mf_classic_auth(
     return auth_success;
 }
 
+static bool mf_classic_auth(
+    FuriHalNfcTxRxContext* tx_rx,
+    uint32_t block,
+    uint64_t key,
+    MfClassicKey key_type,
+    Crypto1* crypto) {
+    return mf_classic_auth_skip_activate(tx_rx, block, key, key_type, crypto, false, 0);
+}
+
 bool mf_classic_authenticate(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t block_num,
@@ -438,6 +448,22 @@ bool mf_classic_authenticate(
     return key_found;
 }
 
+bool mf_classic_authenticate_skip_activate(
+    FuriHalNfcTxRxContext* tx_rx,
+    uint8_t block_num,
+    uint64_t key,
+    MfClassicKey key_type,
+    bool skip_activate,
+    uint32_t cuid) {
+    furi_assert(tx_rx);
+
+    Crypto1 crypto = {};
+    bool key_found = mf_classic_auth_skip_activate(
+        tx_rx, block_num, key, key_type, &crypto, skip_activate, cuid);
+    furi_hal_nfc_sleep();
+    return key_found;
+}
+
 bool mf_classic_auth_attempt(
     FuriHalNfcTxRxContext* tx_rx,
     MfClassicAuthContext* auth_ctx,
@@ -854,6 +880,15 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
                 nonce,
                 nr,
                 ar);
+            if(emulator->auth_callback) {
+                emulator->auth_callback(
+                    mf_classic_get_sector_by_block(block),
+                    access_key,
+                    nonce,
+                    nr,
+                    ar,
+                    emulator->auth_context);
+            }
 
             crypto1_word(&emulator->crypto, nr, 1);
             uint32_t cardRr = ar ^ crypto1_word(&emulator->crypto, 0, 0);
@@ -69,11 +69,21 @@ typedef struct {
     MfClassicSectorReader sector_reader[MF_CLASSIC_SECTORS_MAX];
 } MfClassicReader;
 
+typedef void (*MfClassicAuthCallback)(
+    uint8_t sector,
+    MfClassicKey key_type,
+    uint32_t nt,
+    uint32_t nr,
+    uint32_t ar,
+    void* context);
+
 typedef struct {
     uint32_t cuid;
     Crypto1 crypto;
     MfClassicData data;
     bool data_changed;
+    MfClassicAuthCallback auth_callback;
+    void* auth_context;
 } MfClassicEmulator;
 
 const char* mf_classic_get_type_str(MfClassicType type);
@@ -120,6 +130,14 @@ bool mf_classic_authenticate(
     uint64_t key,
     MfClassicKey key_type);
 
+bool mf_classic_authenticate_skip_activate(
+    FuriHalNfcTxRxContext* tx_rx,
+    uint8_t block_num,
+    uint64_t key,
+    MfClassicKey key_type,
+    bool skip_activate,
+    uint32_t cuid);
+
 bool mf_classic_auth_attempt(
     FuriHalNfcTxRxContext* tx_rx,
     MfClassicAuthContext* auth_ctx,
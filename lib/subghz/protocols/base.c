@@ -9,6 +9,10 @@ void subghz_protocol_decoder_base_set_decoder_callback(
     decoder_base->context = context;
 }
 
+void subghz_protocol_decoder_base_set_idle(SubGhzProtocolDecoderBase* decoder_base, bool idle) {
+    decoder_base->idle = idle;
+}
+
 bool subghz_protocol_decoder_base_get_string(
     SubGhzProtocolDecoderBase* decoder_base,
     string_t output) {
@@ -17,6 +17,9 @@ struct SubGhzProtocolDecoderBase {
     // Callback section
     SubGhzProtocolDecoderBaseRxCallback callback;
     void* context;
+
+    // Dispatch section, idle decoders are not fed by receiver until reset
+    bool idle;
 };
 
 /**
@@ -30,6 +33,13 @@ void subghz_protocol_decoder_base_set_decoder_callback(
     SubGhzProtocolDecoderBaseRxCallback callback,
     void* context);
 
+/**
+ * Mark decoder as idle. Receiver skips idle decoders until next reset.
+ * @param decoder_base Pointer to a SubGhzProtocolDecoderBase instance
+ * @param idle true to stop feeding this decoder
+ */
+void subghz_protocol_decoder_base_set_idle(SubGhzProtocolDecoderBase* decoder_base, bool idle);
+
 /**
  * Getting a textual representation of the received data.
  * @param decoder_base Pointer to a SubGhzProtocolDecoderBase instance
@@ -457,6 +457,50 @@ static inline bool subghz_protocol_keeloq_check_decrypt(
     return false;
 }
 
+/** 
+ * Checking the accepted code against one precomputed manufacture key
+ * @param instance Pointer to a SubGhzBlockGeneric* instance
+ * @param candidate Pointer to a SubGhzKeystoreKeeloqCandidate* instance
+ * @param fix Fix part of the parcel
+ * @param hop Hop encrypted part of the parcel
+ * @param btn Button number, 4 bit
+ * @param end_serial decrement the last 10 bits of the serial number
+ * @return true On success
+ */
+static bool subghz_protocol_keeloq_check_candidate(
+    SubGhzBlockGeneric* instance,
+    const SubGhzKeystoreKeeloqCandidate* candidate,
+    uint32_t fix,
+    uint32_t hop,
+    uint8_t btn,
+    uint16_t end_serial) {
+    uint64_t man;
+    uint32_t seed = 0;
+
+    switch(candidate->type) {
+    case KEELOQ_LEARNING_SIMPLE:
+        // Simple Learning
+        man = candidate->key;
+        break;
+    case KEELOQ_LEARNING_NORMAL:
+        // Normal Learning
+        // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
+        man = subghz_protocol_keeloq_common_normal_learning(fix, candidate->key);
+        break;
+    case KEELOQ_LEARNING_SECURE:
+        man = subghz_protocol_keeloq_common_secure_learning(fix, seed, candidate->key);
+        break;
+    case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
+        man = subghz_protocol_keeloq_common_magic_xor_type1_learning(fix, candidate->key);
+        break;
+    default:
+        return false;
+    }
+
+    uint32_t decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
+    return subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial);
+}
+
 /** 
  * Checking the accepted code against the database manafacture key
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -478,122 +522,34 @@ static uint8_t subghz_protocol_keeloq_check_remote_controller_selector(
 
     uint16_t end_serial = (uint16_t)(fix & 0xFF);
     uint8_t btn = (uint8_t)(fix >> 28);
-    uint32_t decrypt = 0;
-    uint64_t man;
-    uint32_t seed = 0;
-
-    for
-        M_EACH(manufacture_code, *subghz_keystore_get_data(keystore), SubGhzKeyArray_t) {
-            switch(manufacture_code->type) {
-            case KEELOQ_LEARNING_SIMPLE:
-                // Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_NORMAL:
-                // Normal Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man = subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_SECURE:
-                man = subghz_protocol_keeloq_common_secure_learning(
-                    fix, seed, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
-                    fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_UNKNOWN:
-                // Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                // Check for mirrored man
-                uint64_t man_rev = 0;
-                uint64_t man_rev_byte = 0;
-                for(uint8_t i = 0; i < 64; i += 8) {
-                    man_rev_byte = (uint8_t)(manufacture_code->key >> i);
-                    man_rev = man_rev | man_rev_byte << (56 - i);
-                }
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_rev);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                //###########################
-                // Normal Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man = subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_normal_learning(fix, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Secure Learning
-                man = subghz_protocol_keeloq_common_secure_learning(
-                    fix, seed, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_secure_learning(fix, seed, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Magic xor type1 learning
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
-                    fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
+    uint32_t serial = fix & 0x0FFFFFFF;
+
+    // Keys with unknown learning type are already expanded into all learning types
+    // and mirrored variants, so every candidate costs exactly one decrypt
+    size_t candidates_count = 0;
+    const SubGhzKeystoreKeeloqCandidate* candidates =
+        subghz_keystore_get_keeloq_candidates(keystore, &candidates_count);
+
+    // Repeated presses of the same remote resolve with the cached candidate
+    size_t cached_index = 0;
+    bool cached = subghz_keystore_get_keeloq_cached_candidate(keystore, serial, &cached_index);
+    if(cached && subghz_protocol_keeloq_check_candidate(
+                     instance, &candidates[cached_index], fix, hop, btn, end_serial)) {
+        *manufacture_name =
+            subghz_keystore_get_keeloq_candidate_name(keystore, &candidates[cached_index]);
+        return 1;
+    }
 
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(fix, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            }
+    for(size_t i = 0; i < candidates_count; i++) {
+        if(cached && i == cached_index) continue;
+        if(subghz_protocol_keeloq_check_candidate(
+               instance, &candidates[i], fix, hop, btn, end_serial)) {
+            subghz_keystore_set_keeloq_cached_candidate(keystore, serial, i);
+            *manufacture_name =
+                subghz_keystore_get_keeloq_candidate_name(keystore, &candidates[i]);
+            return 1;
         }
+    }
 
     *manufacture_name = "Unknown";
     instance->cnt = 0;
@@ -1,6 +1,7 @@
 #include "raw.h"
 #include <lib/flipper_format/flipper_format.h>
 #include "../subghz_file_encoder_worker.h"
+#include "../subghz_raw_packed.h"
 
 #include "../blocks/const.h"
 #include "../blocks/decoder.h"
@@ -14,6 +15,14 @@
 #define TAG "SubGhzProtocolRAW"
 #define SUBGHZ_DOWNLOAD_MAX_SIZE 512
 
+typedef enum {
+    SubGhzProtocolRAWWriterFlagFlush = (1 << 0),
+    SubGhzProtocolRAWWriterFlagExit = (1 << 1),
+} SubGhzProtocolRAWWriterFlag;
+
+#define SubGhzProtocolRAWWriterFlagAny \
+    (SubGhzProtocolRAWWriterFlagFlush | SubGhzProtocolRAWWriterFlagExit)
+
 static const SubGhzBlockConst subghz_protocol_raw_const = {
     .te_short = 50,
     .te_long = 32700,
@@ -25,13 +34,28 @@ struct SubGhzProtocolDecoderRAW {
     SubGhzProtocolDecoderBase base;
 
     int32_t* upload_raw;
+    uint8_t* upload_packed;
+    bool packed;
     uint16_t ind_write;
     Storage* storage;
     FlipperFormat* flipper_file;
     uint32_t file_is_open;
     string_t file_name;
-    size_t sample_write;
     bool last_level;
+    // Samples received, written by decoding thread only and read as a whole word
+    volatile size_t sample_count;
+
+    // Double buffering, upload_raw is filled while flush_raw is written by writer thread.
+    // flush_free is taken by the decoding thread on swap and given back by the writer.
+    FuriThread* writer_thread;
+    FuriSemaphore* flush_free;
+    int32_t* upload_buffer[2];
+    int32_t* flush_raw;
+    uint16_t flush_count;
+    size_t flush_stall;
+    // Written by writer thread only
+    size_t sample_write;
+    volatile uint32_t flush_latency_max;
 };
 
 struct SubGhzProtocolEncoderRAW {
@@ -53,6 +77,7 @@ const SubGhzProtocolDecoder subghz_protocol_raw_decoder = {
     .free = subghz_protocol_decoder_raw_free,
 
     .feed = subghz_protocol_decoder_raw_feed,
+    .feed_batch = subghz_protocol_decoder_raw_feed_batch,
     .reset = subghz_protocol_decoder_raw_reset,
 
     .get_hash_data = NULL,
@@ -119,7 +144,9 @@ bool subghz_protocol_raw_save_to_file_init(
         }
 
         if(!flipper_format_write_header_cstr(
-               instance->flipper_file, SUBGHZ_RAW_FILE_TYPE, SUBGHZ_RAW_FILE_VERSION)) {
+               instance->flipper_file,
+               SUBGHZ_RAW_FILE_TYPE,
+               instance->packed ? SUBGHZ_RAW_FILE_VERSION_PACKED : SUBGHZ_RAW_FILE_VERSION)) {
             FURI_LOG_E(TAG, "Unable to add header");
             break;
         }
@@ -154,9 +181,22 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
-        instance->upload_raw = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+        instance->upload_buffer[0] = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+        instance->upload_buffer[1] = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+        instance->upload_raw = instance->upload_buffer[0];
+        instance->flush_count = 0;
+        instance->flush_stall = 0;
+        instance->flush_latency_max = 0;
+        if(instance->packed) {
+            // Packed samples follow the header as is, up to the end of file
+            instance->upload_packed =
+                malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * SUBGHZ_RAW_PACKED_SAMPLE_SIZE_MAX);
+        }
         instance->file_is_open = RAWFileIsOpenWrite;
         instance->sample_write = 0;
+        instance->sample_count = 0;
+        furi_thread_start(instance->writer_thread);
+        subghz_protocol_decoder_base_set_idle(&instance->base, false);
         init = true;
     } while(0);
 
@@ -165,31 +205,112 @@ bool subghz_protocol_raw_save_to_file_init(
     return init;
 }
 
-static bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolDecoderRAW* instance) {
+static bool subghz_protocol_raw_save_to_file_write(
+    SubGhzProtocolDecoderRAW* instance,
+    const int32_t* data,
+    uint16_t count) {
     furi_assert(instance);
 
     bool is_write = false;
-    if(instance->file_is_open == RAWFileIsOpenWrite) {
-        if(!flipper_format_write_int32(
-               instance->flipper_file, "RAW_Data", instance->upload_raw, instance->ind_write)) {
+    if(instance->file_is_open == RAWFileIsOpenWrite && instance->packed) {
+        Stream* stream = flipper_format_get_raw_stream(instance->flipper_file);
+        size_t size = subghz_raw_packed_encode(data, count, instance->upload_packed);
+        if(stream_write(stream, instance->upload_packed, size) != size) {
+            FURI_LOG_E(TAG, "Unable to add packed RAW data");
+        } else {
+            instance->sample_write += count;
+            is_write = true;
+        }
+    } else if(instance->file_is_open == RAWFileIsOpenWrite) {
+        if(!flipper_format_write_int32(instance->flipper_file, "RAW_Data", data, count)) {
             FURI_LOG_E(TAG, "Unable to add RAW_Data");
         } else {
-            instance->sample_write += instance->ind_write;
-            instance->ind_write = 0;
+            instance->sample_write += count;
             is_write = true;
         }
     }
     return is_write;
 }
 
+static int32_t subghz_protocol_raw_writer_thread(void* context) {
+    SubGhzProtocolDecoderRAW* instance = context;
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            SubGhzProtocolRAWWriterFlagAny, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & SubGhzProtocolRAWWriterFlagFlush) {
+            uint32_t cycle_start = furi_hal_cortex_get_cycle_count();
+            subghz_protocol_raw_save_to_file_write(
+                instance, instance->flush_raw, instance->flush_count);
+            uint32_t latency = (furi_hal_cortex_get_cycle_count() - cycle_start) /
+                               furi_hal_cortex_instructions_per_microsecond();
+            if(latency > instance->flush_latency_max) instance->flush_latency_max = latency;
+            // Buffer is free again
+            instance->flush_count = 0;
+            furi_semaphore_release(instance->flush_free);
+        }
+        if(flags & SubGhzProtocolRAWWriterFlagExit) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Hand over filled buffer to writer thread and continue with the other one.
+ * Blocks if writer is still busy with previous buffer, meanwhile incoming samples
+ * are held by the worker stream buffer.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ */
+static void subghz_protocol_raw_save_to_file_swap(SubGhzProtocolDecoderRAW* instance) {
+    if(instance->file_is_open != RAWFileIsOpenWrite) return;
+
+    if(furi_semaphore_acquire(instance->flush_free, 0) != FuriStatusOk) {
+        instance->flush_stall++;
+        furi_check(
+            furi_semaphore_acquire(instance->flush_free, FuriWaitForever) == FuriStatusOk);
+    }
+    instance->flush_raw = instance->upload_raw;
+    instance->upload_raw = (instance->upload_raw == instance->upload_buffer[0]) ?
+                               instance->upload_buffer[1] :
+                               instance->upload_buffer[0];
+    instance->flush_count = instance->ind_write;
+    furi_thread_flags_set(
+        furi_thread_get_id(instance->writer_thread), SubGhzProtocolRAWWriterFlagFlush);
+    instance->ind_write = 0;
+}
+
 void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance) {
     furi_assert(instance);
 
-    if(instance->file_is_open == RAWFileIsOpenWrite && instance->ind_write)
-        subghz_protocol_raw_save_to_file_write(instance);
+    if(instance->file_is_open == RAWFileIsOpenWrite) {
+        // Pending buffer is flushed before exit
+        furi_thread_flags_set(
+            furi_thread_get_id(instance->writer_thread), SubGhzProtocolRAWWriterFlagExit);
+        furi_thread_join(instance->writer_thread);
+        if(instance->ind_write) {
+            subghz_protocol_raw_save_to_file_write(
+                instance, instance->upload_raw, instance->ind_write);
+            instance->ind_write = 0;
+        }
+        FURI_LOG_I(
+            TAG,
+            "Samples written: %u, stalls: %u, max flush latency: %lu us",
+            instance->sample_write,
+            instance->flush_stall,
+            instance->flush_latency_max);
+    }
     if(instance->file_is_open != RAWFileIsOpenClose) {
-        free(instance->upload_raw);
+        free(instance->upload_buffer[0]);
+        free(instance->upload_buffer[1]);
+        instance->upload_buffer[0] = NULL;
+        instance->upload_buffer[1] = NULL;
         instance->upload_raw = NULL;
+        if(instance->upload_packed) {
+            free(instance->upload_packed);
+            instance->upload_packed = NULL;
+        }
         flipper_format_file_close(instance->flipper_file);
         flipper_format_free(instance->flipper_file);
         furi_record_close(RECORD_STORAGE);
@@ -198,8 +319,25 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance) {
     instance->file_is_open = RAWFileIsOpenClose;
 }
 
+void subghz_protocol_raw_save_to_file_set_packed(SubGhzProtocolDecoderRAW* instance, bool packed) {
+    furi_assert(instance);
+    furi_assert(instance->file_is_open == RAWFileIsOpenClose);
+    instance->packed = packed;
+}
+
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance) {
-    return instance->sample_write + instance->ind_write;
+    furi_assert(instance);
+    return instance->sample_count;
+}
+
+size_t subghz_protocol_raw_get_flush_stall(SubGhzProtocolDecoderRAW* instance) {
+    furi_assert(instance);
+    return instance->flush_stall;
+}
+
+uint32_t subghz_protocol_raw_get_flush_latency_max(SubGhzProtocolDecoderRAW* instance) {
+    furi_assert(instance);
+    return instance->flush_latency_max;
 }
 
 void* subghz_protocol_decoder_raw_alloc(SubGhzEnvironment* environment) {
@@ -207,17 +345,28 @@ void* subghz_protocol_decoder_raw_alloc(SubGhzEnvironment* environment) {
     SubGhzProtocolDecoderRAW* instance = malloc(sizeof(SubGhzProtocolDecoderRAW));
     instance->base.protocol = &subghz_protocol_raw;
     instance->upload_raw = NULL;
+    instance->upload_packed = NULL;
+    instance->packed = false;
     instance->ind_write = 0;
     instance->last_level = false;
     instance->file_is_open = RAWFileIsOpenClose;
     string_init(instance->file_name);
 
+    instance->writer_thread = furi_thread_alloc();
+    furi_thread_set_name(instance->writer_thread, "SubGhzRAWWriter");
+    furi_thread_set_stack_size(instance->writer_thread, 2048);
+    furi_thread_set_context(instance->writer_thread, instance);
+    furi_thread_set_callback(instance->writer_thread, subghz_protocol_raw_writer_thread);
+    instance->flush_free = furi_semaphore_alloc(1, 1);
+
     return instance;
 }
 
 void subghz_protocol_decoder_raw_free(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderRAW* instance = context;
+    furi_thread_free(instance->writer_thread);
+    furi_semaphore_free(instance->flush_free);
     string_clear(instance->file_name);
     free(instance);
 }
@@ -238,13 +387,56 @@ void subghz_protocol_decoder_raw_feed(void* context, bool level, uint32_t durati
             if(instance->last_level != level) {
                 instance->last_level = (level ? true : false);
                 instance->upload_raw[instance->ind_write++] = (level ? duration : -duration);
+                instance->sample_count++;
             }
         }
 
         if(instance->ind_write == SUBGHZ_DOWNLOAD_MAX_SIZE) {
-            subghz_protocol_raw_save_to_file_write(instance);
+            subghz_protocol_raw_save_to_file_swap(instance);
+        }
+    } else {
+        // Nothing to record until save_to_file_init
+        subghz_protocol_decoder_base_set_idle(&instance->base, true);
+    }
+}
+
+void subghz_protocol_decoder_raw_feed_batch(
+    void* context,
+    const LevelDuration* level_duration,
+    size_t count) {
+    furi_assert(context);
+    SubGhzProtocolDecoderRAW* instance = context;
+
+    if(instance->upload_raw == NULL) {
+        // Nothing to record until save_to_file_init
+        subghz_protocol_decoder_base_set_idle(&instance->base, true);
+        return;
+    }
+
+    int32_t* upload_raw = instance->upload_raw;
+    uint16_t ind_write = instance->ind_write;
+    bool last_level = instance->last_level;
+    size_t sample_count = instance->sample_count;
+    for(size_t i = 0; i < count; i++) {
+        bool level = level_duration_get_level(level_duration[i]);
+        uint32_t duration = level_duration_get_duration(level_duration[i]);
+        if((duration > subghz_protocol_raw_const.te_short) && (last_level != level)) {
+            last_level = level;
+            upload_raw[ind_write++] = (level ? (int32_t)duration : -(int32_t)duration);
+            sample_count++;
+            if(ind_write == SUBGHZ_DOWNLOAD_MAX_SIZE) {
+                instance->ind_write = ind_write;
+                instance->last_level = last_level;
+                subghz_protocol_raw_save_to_file_swap(instance);
+                upload_raw = instance->upload_raw;
+                ind_write = instance->ind_write;
+                last_level = instance->last_level;
+            }
         }
     }
+    instance->ind_write = ind_write;
+    instance->last_level = last_level;
+    instance->sample_count = sample_count;
 }
 
 bool subghz_protocol_decoder_raw_deserialize(void* context, FlipperFormat* flipper_format) {
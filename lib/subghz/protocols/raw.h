@@ -25,6 +25,14 @@ bool subghz_protocol_raw_save_to_file_init(
     const char* dev_name,
     SubGhzPresetDefinition* preset);
 
+/**
+ * Select RAW file encoding, must be called before subghz_protocol_raw_save_to_file_init.
+ * Packed files are several times smaller, but can't be read by older firmware.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @param packed true - binary packed samples, false - "RAW_Data:" text lines
+ */
+void subghz_protocol_raw_save_to_file_set_packed(SubGhzProtocolDecoderRAW* instance, bool packed);
+
 /**
  * Stop writing file to flash
  * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
@@ -38,6 +46,20 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance);
  */
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance);
 
+/**
+ * Get the number of times decoding waited for storage to finish previous block.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @return count of stalls
+ */
+size_t subghz_protocol_raw_get_flush_stall(SubGhzProtocolDecoderRAW* instance);
+
+/**
+ * Get the worst-case time of writing one block to storage.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @return latency, us
+ */
+uint32_t subghz_protocol_raw_get_flush_latency_max(SubGhzProtocolDecoderRAW* instance);
+
 /**
  * Allocate SubGhzProtocolDecoderRAW.
  * @param environment Pointer to a SubGhzEnvironment instance
@@ -65,6 +87,17 @@ void subghz_protocol_decoder_raw_reset(void* context);
  */
 void subghz_protocol_decoder_raw_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Parse a block of levels and durations received from the air.
+ * @param context Pointer to a SubGhzProtocolDecoderRAW instance
+ * @param level_duration Array of LevelDuration
+ * @param count Number of elements in level_duration
+ */
+void subghz_protocol_decoder_raw_feed_batch(
+    void* context,
+    const LevelDuration* level_duration,
+    size_t count);
+
 /**
  * Deserialize data SubGhzProtocolDecoderRAW.
  * @param context Pointer to a SubGhzProtocolDecoderRAW instance
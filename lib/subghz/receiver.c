@@ -5,7 +5,12 @@
 #include <m-array.h>
 
 typedef struct {
-    SubGhzProtocolEncoderBase* base;
+    SubGhzProtocolDecoderBase* base;
+    SubGhzDecoderFeed feed;
+    SubGhzDecoderFeedBatch feed_batch;
+
+    uint32_t feed_count;
+    uint32_t cycle_count;
 } SubGhzReceiverSlot;
 
 ARRAY_DEF(SubGhzReceiverSlotArray, SubGhzReceiverSlot, M_POD_OPLIST);
@@ -15,6 +20,14 @@ struct SubGhzReceiver {
     SubGhzReceiverSlotArray_t slots;
     SubGhzProtocolFlag filter;
 
+    // Slots matching current filter, rebuilt on filter change.
+    // Holds pointers so that every entry is replaced atomically.
+    SubGhzReceiverSlot** dispatch;
+    volatile size_t dispatch_count;
+    bool profiling;
+    // Incremented on every reset, lets a batch notice a reset from a callback
+    uint32_t reset_generation;
+
     SubGhzReceiverCallback callback;
     void* context;
 };
@@ -29,12 +42,25 @@ SubGhzReceiver* subghz_receiver_alloc_init(SubGhzEnvironment* environment) {
         if(protocol->decoder && protocol->decoder->alloc) {
             SubGhzReceiverSlot* slot = SubGhzReceiverSlotArray_push_new(instance->slots);
             slot->base = protocol->decoder->alloc(environment);
+            slot->base->idle = false;
+            slot->feed = protocol->decoder->feed;
+            slot->feed_batch = protocol->decoder->feed_batch;
+            slot->feed_count = 0;
+            slot->cycle_count = 0;
         }
     }
 
+    instance->dispatch =
+        malloc(SubGhzReceiverSlotArray_size(instance->slots) * sizeof(SubGhzReceiverSlot*));
+    instance->dispatch_count = 0;
+    instance->profiling = false;
+    instance->reset_generation = 0;
+
     instance->callback = NULL;
     instance->context = NULL;
 
+    subghz_receiver_set_filter(instance, 0);
+
     return instance;
 }
 
@@ -51,29 +77,94 @@ void subghz_receiver_free(SubGhzReceiver* instance) {
             slot->base = NULL;
         }
     SubGhzReceiverSlotArray_clear(instance->slots);
+    free(instance->dispatch);
 
     free(instance);
 }
 
+static void
+    subghz_receiver_decode_profiled(SubGhzReceiver* instance, bool level, uint32_t duration) {
+    size_t dispatch_count = instance->dispatch_count;
+    for(size_t i = 0; i < dispatch_count; i++) {
+        SubGhzReceiverSlot* slot = instance->dispatch[i];
+        if(!slot->base->idle) {
+            uint32_t cycle_start = furi_hal_cortex_get_cycle_count();
+            slot->feed(slot->base, level, duration);
+            slot->cycle_count += furi_hal_cortex_get_cycle_count() - cycle_start;
+            slot->feed_count++;
+        }
+    }
+}
+
 void subghz_receiver_decode(SubGhzReceiver* instance, bool level, uint32_t duration) {
     furi_assert(instance);
-    furi_assert(instance->slots);
 
-    for
-        M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
-            if((slot->base->protocol->flag & instance->filter) == instance->filter) {
-                slot->base->protocol->decoder->feed(slot->base, level, duration);
-            }
+    if(instance->profiling) {
+        subghz_receiver_decode_profiled(instance, level, duration);
+        return;
+    }
+
+    size_t dispatch_count = instance->dispatch_count;
+    for(size_t i = 0; i < dispatch_count; i++) {
+        SubGhzReceiverSlot* slot = instance->dispatch[i];
+        if(!slot->base->idle) {
+            slot->feed(slot->base, level, duration);
+        }
+    }
+}
+
+static inline void subghz_receiver_slot_feed_batch(
+    SubGhzReceiverSlot* slot,
+    const LevelDuration* level_duration,
+    size_t count) {
+    if(slot->feed_batch) {
+        slot->feed_batch(slot->base, level_duration, count);
+    } else {
+        for(size_t i = 0; i < count && !slot->base->idle; i++) {
+            slot->feed(
+                slot->base,
+                level_duration_get_level(level_duration[i]),
+                level_duration_get_duration(level_duration[i]));
+        }
+    }
+}
+
+void subghz_receiver_decode_batch(
+    SubGhzReceiver* instance,
+    const LevelDuration* level_duration,
+    size_t count) {
+    furi_assert(instance);
+    furi_assert(level_duration);
+
+    uint32_t reset_generation = instance->reset_generation;
+    size_t dispatch_count = instance->dispatch_count;
+    for(size_t i = 0; i < dispatch_count; i++) {
+        // Remaining decoders were reset by a callback, the batch predates that reset
+        if(instance->reset_generation != reset_generation) break;
+
+        SubGhzReceiverSlot* slot = instance->dispatch[i];
+        if(slot->base->idle) continue;
+
+        if(instance->profiling) {
+            uint32_t cycle_start = furi_hal_cortex_get_cycle_count();
+            subghz_receiver_slot_feed_batch(slot, level_duration, count);
+            slot->cycle_count += furi_hal_cortex_get_cycle_count() - cycle_start;
+            slot->feed_count += count;
+        } else {
+            subghz_receiver_slot_feed_batch(slot, level_duration, count);
         }
+    }
 }
 
 void subghz_receiver_reset(SubGhzReceiver* instance) {
     furi_assert(instance);
     furi_assert(instance->slots);
 
+    instance->reset_generation++;
     for
         M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
             slot->base->protocol->decoder->reset(slot->base);
+            slot->base->idle = false;
         }
 }
 
@@ -103,6 +194,55 @@ void subghz_receiver_set_rx_callback(
 void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag filter) {
     furi_assert(instance);
     instance->filter = filter;
+
+    // Receiver may be running: every published entry must stay a valid slot pointer
+    size_t dispatch_count = 0;
+    for
+        M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
+            if((slot->base->protocol->flag & filter) == filter) {
+                instance->dispatch[dispatch_count++] = slot;
+                if(dispatch_count > instance->dispatch_count) {
+                    instance->dispatch_count = dispatch_count;
+                }
+            }
+        }
+    instance->dispatch_count = dispatch_count;
+}
+
+void subghz_receiver_set_profiling(SubGhzReceiver* instance, bool enable) {
+    furi_assert(instance);
+
+    if(enable) {
+        for
+            M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
+                slot->feed_count = 0;
+                slot->cycle_count = 0;
+            }
+    }
+    instance->profiling = enable;
+}
+
+size_t subghz_receiver_get_decoder_count(SubGhzReceiver* instance) {
+    furi_assert(instance);
+    return SubGhzReceiverSlotArray_size(instance->slots);
+}
+
+size_t subghz_receiver_get_active_decoder_count(SubGhzReceiver* instance) {
+    furi_assert(instance);
+    return instance->dispatch_count;
+}
+
+void subghz_receiver_get_decoder_stats(
+    SubGhzReceiver* instance,
+    size_t index,
+    SubGhzReceiverDecoderStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    const SubGhzReceiverSlot* slot = SubGhzReceiverSlotArray_cget(instance->slots, index);
+    stats->name = slot->base->protocol->name;
+    stats->feed_count = slot->feed_count;
+    stats->cycle_count = slot->cycle_count;
 }
 
 SubGhzProtocolDecoderBase* subghz_receiver_search_decoder_base_by_name(
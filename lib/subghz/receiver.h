@@ -5,6 +5,12 @@
 
 typedef struct SubGhzReceiver SubGhzReceiver;
 
+typedef struct {
+    const char* name;
+    uint32_t feed_count;
+    uint32_t cycle_count;
+} SubGhzReceiverDecoderStats;
+
 typedef void (*SubGhzReceiverCallback)(
     SubGhzReceiver* decoder,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -31,6 +37,20 @@ void subghz_receiver_free(SubGhzReceiver* instance);
  */
 void subghz_receiver_decode(SubGhzReceiver* instance, bool level, uint32_t duration);
 
+/**
+ * Parse a block of levels and durations received from the air.
+ * Every decoder consumes the whole block before the next one is fed, so
+ * decoders implementing feed_batch keep their state in registers.
+ * If a callback resets the receiver, decoders not yet fed skip this block.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param level_duration Array of LevelDuration, must not contain reset marks
+ * @param count Number of elements in level_duration
+ */
+void subghz_receiver_decode_batch(
+    SubGhzReceiver* instance,
+    const LevelDuration* level_duration,
+    size_t count);
+
 /**
  * Reset decoder SubGhzReceiver.
  * @param instance Pointer to a SubGhzReceiver instance
@@ -55,6 +75,38 @@ void subghz_receiver_set_rx_callback(
  */
 void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag filter);
 
+/**
+ * Enable per decoder feed and cycle counters. Counters are cleared on enable.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param enable true to start counting
+ */
+void subghz_receiver_set_profiling(SubGhzReceiver* instance, bool enable);
+
+/**
+ * Get number of decoders in SubGhzReceiver.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @return decoders count
+ */
+size_t subghz_receiver_get_decoder_count(SubGhzReceiver* instance);
+
+/**
+ * Get number of decoders passing the current filter.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @return active decoders count
+ */
+size_t subghz_receiver_get_active_decoder_count(SubGhzReceiver* instance);
+
+/**
+ * Get feed statistics of decoder.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param index Decoder index, less than subghz_receiver_get_decoder_count
+ * @param stats Pointer to a SubGhzReceiverDecoderStats to fill
+ */
+void subghz_receiver_get_decoder_stats(
+    SubGhzReceiver* instance,
+    size_t index,
+    SubGhzReceiverDecoderStats* stats);
+
 /**
  * Search for a cattery by his name.
  * @param instance Pointer to a SubGhzReceiver instance
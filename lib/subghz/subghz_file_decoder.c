@@ -0,0 +1,244 @@
+#include "subghz_file_decoder.h"
+#include "subghz_file_encoder_worker.h"
+#include "subghz_raw_packed.h"
+#include "protocols/raw.h"
+
+#include <toolbox/stream/stream.h>
+#include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+
+#define TAG "SubGhzFileDecoder"
+
+#define SUBGHZ_FILE_DECODER_BATCH_SIZE 64
+#define SUBGHZ_FILE_DECODER_PACKED_LOAD 256
+#define SUBGHZ_FILE_DECODER_CACHE_SIZE 4096
+
+struct SubGhzFileDecoder {
+    SubGhzReceiver* receiver;
+
+    LevelDuration batch[SUBGHZ_FILE_DECODER_BATCH_SIZE];
+    size_t batch_count;
+    // Same level durations are merged into one sample
+    int32_t pending_duration;
+
+    SubGhzRawPackedDecoder packed_decoder;
+    uint8_t packed_data[SUBGHZ_FILE_DECODER_PACKED_LOAD];
+
+    uint32_t* packet_count;
+    uint32_t sample_count;
+    uint64_t decode_cycles;
+
+    SubGhzReceiverCallback callback;
+    void* context;
+};
+
+static void subghz_file_decoder_rx_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    SubGhzFileDecoder* instance = context;
+
+    SubGhzReceiverDecoderStats stats;
+    for(size_t i = 0; i < subghz_receiver_get_decoder_count(receiver); i++) {
+        subghz_receiver_get_decoder_stats(receiver, i, &stats);
+        if(stats.name == decoder_base->protocol->name) {
+            instance->packet_count[i]++;
+            break;
+        }
+    }
+
+    if(instance->callback) {
+        instance->callback(receiver, decoder_base, instance->context);
+    }
+}
+
+SubGhzFileDecoder* subghz_file_decoder_alloc(SubGhzEnvironment* environment) {
+    SubGhzFileDecoder* instance = malloc(sizeof(SubGhzFileDecoder));
+
+    instance->receiver = subghz_receiver_alloc_init(environment);
+    subghz_receiver_set_filter(instance->receiver, SubGhzProtocolFlag_Decodable);
+    subghz_receiver_set_rx_callback(instance->receiver, subghz_file_decoder_rx_callback, instance);
+
+    instance->packet_count =
+        malloc(subghz_receiver_get_decoder_count(instance->receiver) * sizeof(uint32_t));
+    instance->callback = NULL;
+    instance->context = NULL;
+    subghz_file_decoder_reset_stats(instance);
+
+    return instance;
+}
+
+void subghz_file_decoder_free(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+
+    subghz_receiver_free(instance->receiver);
+    free(instance->packet_count);
+
+    free(instance);
+}
+
+void subghz_file_decoder_set_rx_callback(
+    SubGhzFileDecoder* instance,
+    SubGhzReceiverCallback callback,
+    void* context) {
+    furi_assert(instance);
+
+    instance->callback = callback;
+    instance->context = context;
+}
+
+static void subghz_file_decoder_flush(SubGhzFileDecoder* instance) {
+    if(instance->batch_count) {
+        uint32_t cycle_start = furi_hal_cortex_get_cycle_count();
+        subghz_receiver_decode_batch(instance->receiver, instance->batch, instance->batch_count);
+        instance->decode_cycles += furi_hal_cortex_get_cycle_count() - cycle_start;
+        instance->sample_count += instance->batch_count;
+        instance->batch_count = 0;
+    }
+}
+
+static void subghz_file_decoder_push_pending(SubGhzFileDecoder* instance) {
+    int32_t duration = instance->pending_duration;
+    if(duration == 0) return;
+    instance->pending_duration = 0;
+    instance->batch[instance->batch_count++] =
+        level_duration_make(duration > 0, (duration > 0) ? duration : -duration);
+    if(instance->batch_count == SUBGHZ_FILE_DECODER_BATCH_SIZE) {
+        subghz_file_decoder_flush(instance);
+    }
+}
+
+static void subghz_file_decoder_duration_callback(void* context, int32_t duration) {
+    SubGhzFileDecoder* instance = context;
+
+    if(duration == 0) return;
+    if((duration > 0) != (instance->pending_duration > 0)) {
+        subghz_file_decoder_push_pending(instance);
+    }
+    instance->pending_duration += duration;
+}
+
+bool subghz_file_decoder_run(SubGhzFileDecoder* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_assert(file_path);
+
+    bool result = false;
+    uint32_t version = 0;
+    string_t temp_str;
+    string_init(temp_str);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* flipper_format = flipper_format_buffered_file_alloc_ex(
+        storage, SUBGHZ_FILE_DECODER_CACHE_SIZE, BufferedFileStreamAccessSequential);
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+
+    do {
+        if(!flipper_format_buffered_file_open_existing(flipper_format, file_path)) {
+            FURI_LOG_E(TAG, "Unable to open file for read: %s", file_path);
+            break;
+        }
+        if(!flipper_format_read_header(flipper_format, temp_str, &version)) {
+            FURI_LOG_E(TAG, "Missing or incorrect header");
+            break;
+        }
+        if(strcmp(string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE) != 0 ||
+           (version != SUBGHZ_RAW_FILE_VERSION && version != SUBGHZ_RAW_FILE_VERSION_PACKED)) {
+            FURI_LOG_E(TAG, "Type or version mismatch");
+            break;
+        }
+        if(!flipper_format_read_string(flipper_format, "Protocol", temp_str)) {
+            FURI_LOG_E(TAG, "Missing Protocol");
+            break;
+        }
+        if(strcmp(string_get_cstr(temp_str), SUBGHZ_PROTOCOL_RAW_NAME) != 0) {
+            FURI_LOG_E(TAG, "Not a RAW file");
+            break;
+        }
+
+        subghz_receiver_reset(instance->receiver);
+        instance->batch_count = 0;
+        instance->pending_duration = 0;
+        if(version == SUBGHZ_RAW_FILE_VERSION_PACKED) {
+            //skip the end of the previous line "\n"
+            stream_seek(stream, 1, StreamOffsetFromCurrent);
+            subghz_raw_packed_decoder_reset(&instance->packed_decoder);
+            size_t size;
+            while((size = stream_read(
+                       stream, instance->packed_data, SUBGHZ_FILE_DECODER_PACKED_LOAD)) > 0) {
+                subghz_raw_packed_decode(
+                    &instance->packed_decoder,
+                    instance->packed_data,
+                    size,
+                    subghz_file_decoder_duration_callback,
+                    instance);
+            }
+        } else {
+            while(stream_read_line(stream, temp_str)) {
+                subghz_file_encoder_worker_parse_raw_data(
+                    string_get_cstr(temp_str), subghz_file_decoder_duration_callback, instance);
+            }
+        }
+        subghz_file_decoder_push_pending(instance);
+        subghz_file_decoder_flush(instance);
+
+        result = true;
+    } while(false);
+
+    flipper_format_free(flipper_format);
+    furi_record_close(RECORD_STORAGE);
+    string_clear(temp_str);
+
+    return result;
+}
+
+void subghz_file_decoder_reset_stats(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+
+    // Enabling profiling clears receiver counters
+    subghz_receiver_set_profiling(instance->receiver, true);
+    memset(
+        instance->packet_count,
+        0,
+        subghz_receiver_get_decoder_count(instance->receiver) * sizeof(uint32_t));
+    instance->sample_count = 0;
+    instance->decode_cycles = 0;
+}
+
+uint32_t subghz_file_decoder_get_sample_count(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+    return instance->sample_count;
+}
+
+uint32_t subghz_file_decoder_get_packet_count(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+    uint32_t packet_count = 0;
+    for(size_t i = 0; i < subghz_receiver_get_decoder_count(instance->receiver); i++) {
+        packet_count += instance->packet_count[i];
+    }
+    return packet_count;
+}
+
+uint64_t subghz_file_decoder_get_decode_cycles(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+    return instance->decode_cycles;
+}
+
+size_t subghz_file_decoder_get_protocol_count(SubGhzFileDecoder* instance) {
+    furi_assert(instance);
+    return subghz_receiver_get_decoder_count(instance->receiver);
+}
+
+void subghz_file_decoder_get_protocol_stats(
+    SubGhzFileDecoder* instance,
+    size_t index,
+    SubGhzFileDecoderProtocolStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    SubGhzReceiverDecoderStats receiver_stats;
+    subghz_receiver_get_decoder_stats(instance->receiver, index, &receiver_stats);
+    stats->name = receiver_stats.name;
+    stats->packet_count = instance->packet_count[index];
+    stats->feed_count = receiver_stats.feed_count;
+    stats->cycle_count = receiver_stats.cycle_count;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "receiver.h"
+
+typedef struct SubGhzFileDecoder SubGhzFileDecoder;
+
+typedef struct {
+    const char* name;
+    uint32_t packet_count;
+    uint32_t feed_count;
+    uint32_t cycle_count;
+} SubGhzFileDecoderProtocolStats;
+
+/**
+ * Allocate SubGhzFileDecoder. Offline decoder of RAW files, works without radio.
+ * @param environment Pointer to a SubGhzEnvironment instance
+ * @return SubGhzFileDecoder* pointer to a SubGhzFileDecoder instance
+ */
+SubGhzFileDecoder* subghz_file_decoder_alloc(SubGhzEnvironment* environment);
+
+/**
+ * Free SubGhzFileDecoder.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ */
+void subghz_file_decoder_free(SubGhzFileDecoder* instance);
+
+/**
+ * Set a callback upon completion of successful decoding of one of the protocols.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @param callback Callback, SubGhzReceiverCallback
+ * @param context Context
+ */
+void subghz_file_decoder_set_rx_callback(
+    SubGhzFileDecoder* instance,
+    SubGhzReceiverCallback callback,
+    void* context);
+
+/**
+ * Decode RAW file as fast as possible. Statistics are accumulated between runs.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @param file_path Full path to the RAW file
+ * @return true On success
+ */
+bool subghz_file_decoder_run(SubGhzFileDecoder* instance, const char* file_path);
+
+/**
+ * Clear accumulated statistics.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ */
+void subghz_file_decoder_reset_stats(SubGhzFileDecoder* instance);
+
+/**
+ * Get total number of samples fed to receiver.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @return samples count
+ */
+uint32_t subghz_file_decoder_get_sample_count(SubGhzFileDecoder* instance);
+
+/**
+ * Get total number of decoded packets.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @return packets count
+ */
+uint32_t subghz_file_decoder_get_packet_count(SubGhzFileDecoder* instance);
+
+/**
+ * Get CPU cycles spent in decoders, file parsing excluded.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @return cycles count
+ */
+uint64_t subghz_file_decoder_get_decode_cycles(SubGhzFileDecoder* instance);
+
+/**
+ * Get number of protocols in statistics.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @return protocols count
+ */
+size_t subghz_file_decoder_get_protocol_count(SubGhzFileDecoder* instance);
+
+/**
+ * Get statistics of protocol.
+ * @param instance Pointer to a SubGhzFileDecoder instance
+ * @param index Protocol index, less than subghz_file_decoder_get_protocol_count
+ * @param stats Pointer to a SubGhzFileDecoderProtocolStats to fill
+ */
+void subghz_file_decoder_get_protocol_stats(
+    SubGhzFileDecoder* instance,
+    size_t index,
+    SubGhzFileDecoderProtocolStats* stats);
@@ -1,4 +1,6 @@
 #include "subghz_file_encoder_worker.h"
+#include "subghz_raw_packed.h"
+#include "types.h"
 #include <stream_buffer.h>
 
 #include <toolbox/stream/stream.h>
@@ -8,6 +10,8 @@
 #define TAG "SubGhzFileEncoderWorker"
 
 #define SUBGHZ_FILE_ENCODER_LOAD 512
+#define SUBGHZ_FILE_ENCODER_PACKED_LOAD 256
+#define SUBGHZ_FILE_ENCODER_CACHE_SIZE 1024
 
 struct SubGhzFileEncoderWorker {
     FuriThread* thread;
@@ -22,6 +26,10 @@ struct SubGhzFileEncoderWorker {
     string_t str_data;
     string_t file_path;
 
+    uint32_t version;
+    SubGhzRawPackedDecoder packed_decoder;
+    uint8_t packed_data[SUBGHZ_FILE_ENCODER_PACKED_LOAD];
+
     SubGhzFileEncoderWorkerCallbackEnd callback_end;
     void* context_end;
 };
@@ -54,13 +62,16 @@ void subghz_file_encoder_worker_add_level_duration(
     }
 }
 
-bool subghz_file_encoder_worker_data_parse(SubGhzFileEncoderWorker* instance, const char* strStart) {
-    char* str1;
+bool subghz_file_encoder_worker_parse_raw_data(
+    const char* line,
+    SubGhzFileEncoderWorkerDurationCallback callback,
+    void* context) {
+    const char* str1;
     bool res = false;
     // Line sample: "RAW_Data: -1, 2, -2..."
 
     // Look for a key in the line
-    str1 = strstr(strStart, "RAW_Data: ");
+    str1 = strstr(line, "RAW_Data: ");
 
     if(str1 != NULL) {
         // Skip key
@@ -72,13 +83,24 @@ bool subghz_file_encoder_worker_data_parse(SubGhzFileEncoderWorker* instance, co
 
             // Skip space
             str1 += 1;
-            subghz_file_encoder_worker_add_level_duration(instance, atoi(str1));
+            callback(context, atoi(str1));
         }
         res = true;
     }
     return res;
 }
 
+static void subghz_file_encoder_worker_duration_callback(void* context, int32_t duration) {
+    subghz_file_encoder_worker_add_level_duration(context, duration);
+}
+
+bool subghz_file_encoder_worker_data_parse(
+    SubGhzFileEncoderWorker* instance,
+    const char* strStart) {
+    return subghz_file_encoder_worker_parse_raw_data(
+        strStart, subghz_file_encoder_worker_duration_callback, instance);
+}
+
 LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
     furi_assert(context);
     SubGhzFileEncoderWorker* instance = context;
@@ -116,16 +138,22 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
     bool res = false;
     Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
     do {
-        if(!flipper_format_file_open_existing(
+        if(!flipper_format_buffered_file_open_existing(
                instance->flipper_format, string_get_cstr(instance->file_path))) {
             FURI_LOG_E(
                 TAG, "Unable to open file for read: %s", string_get_cstr(instance->file_path));
             break;
         }
+        if(!flipper_format_read_header(
+               instance->flipper_format, instance->str_data, &instance->version)) {
+            FURI_LOG_E(TAG, "Missing or incorrect header");
+            break;
+        }
         if(!flipper_format_read_string(instance->flipper_format, "Protocol", instance->str_data)) {
             FURI_LOG_E(TAG, "Missing Protocol");
             break;
         }
+        subghz_raw_packed_decoder_reset(&instance->packed_decoder);
 
         //skip the end of the previous line "\n"
         stream_seek(stream, 1, StreamOffsetFromCurrent);
@@ -137,7 +165,23 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
     while(res && instance->worker_running) {
         size_t stream_free_byte = xStreamBufferSpacesAvailable(instance->stream);
         if((stream_free_byte / sizeof(int32_t)) >= SUBGHZ_FILE_ENCODER_LOAD) {
-            if(stream_read_line(stream, instance->str_data)) {
+            if(instance->version == SUBGHZ_RAW_FILE_VERSION_PACKED) {
+                // Every packed byte gives at most one sample
+                size_t size = stream_read(
+                    stream, instance->packed_data, SUBGHZ_FILE_ENCODER_PACKED_LOAD);
+                if(size) {
+                    subghz_raw_packed_decode(
+                        &instance->packed_decoder,
+                        instance->packed_data,
+                        size,
+                        subghz_file_encoder_worker_duration_callback,
+                        instance);
+                } else {
+                    subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
+                    subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
+                    break;
+                }
+            } else if(stream_read_line(stream, instance->str_data)) {
                 string_strim(instance->str_data);
                 if(!subghz_file_encoder_worker_data_parse(
                        instance, string_get_cstr(instance->str_data))) {
@@ -167,7 +211,7 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
         }
         furi_delay_ms(50);
     }
-    flipper_format_file_close(instance->flipper_format);
+    flipper_format_buffered_file_close(instance->flipper_format);
 
     FURI_LOG_I(TAG, "Worker stop");
     return 0;
@@ -184,7 +228,8 @@ SubGhzFileEncoderWorker* subghz_file_encoder_worker_alloc() {
     instance->stream = xStreamBufferCreate(sizeof(int32_t) * 2048, sizeof(int32_t));
 
     instance->storage = furi_record_open(RECORD_STORAGE);
-    instance->flipper_format = flipper_format_file_alloc(instance->storage);
+    instance->flipper_format = flipper_format_buffered_file_alloc_ex(
+        instance->storage, SUBGHZ_FILE_ENCODER_CACHE_SIZE, BufferedFileStreamAccessSequential);
 
     string_init(instance->str_data);
     string_init(instance->file_path);
@@ -4,6 +4,8 @@
 
 typedef void (*SubGhzFileEncoderWorkerCallbackEnd)(void* context);
 
+typedef void (*SubGhzFileEncoderWorkerDurationCallback)(void* context, int32_t duration);
+
 typedef struct SubGhzFileEncoderWorker SubGhzFileEncoderWorker;
 
 /** 
@@ -16,6 +18,18 @@ void subghz_file_encoder_worker_callback_end(
     SubGhzFileEncoderWorkerCallbackEnd callback_end,
     void* context_end);
 
+/** 
+ * Parse "RAW_Data:" line of a RAW file.
+ * @param line Line from RAW file
+ * @param callback SubGhzFileEncoderWorkerDurationCallback, called for every signed duration
+ * @param context Context for callback
+ * @return true if line contains RAW_Data
+ */
+bool subghz_file_encoder_worker_parse_raw_data(
+    const char* line,
+    SubGhzFileEncoderWorkerDurationCallback callback,
+    void* context);
+
 /** 
  * Allocate SubGhzFileEncoderWorker.
  * @return SubGhzFileEncoderWorker* pointer to a SubGhzFileEncoderWorker instance 
@@ -1,4 +1,5 @@
 #include "subghz_keystore.h"
+#include "protocols/keeloq_common.h"
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -21,19 +22,42 @@
 #define SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE 512
 #define SUBGHZ_KEYSTORE_FILE_ENCRYPTED_LINE_SIZE (SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE * 2)
 
+#define SUBGHZ_KEYSTORE_KEELOQ_SERIAL_CACHE_SIZE 32
+
 typedef enum {
     SubGhzKeystoreEncryptionNone,
     SubGhzKeystoreEncryptionAES256,
 } SubGhzKeystoreEncryption;
 
+typedef struct {
+    uint32_t serial;
+    uint32_t candidate_index;
+    bool valid;
+} SubGhzKeystoreKeeloqSerialCache;
+
 struct SubGhzKeystore {
     SubGhzKeyArray_t data;
+
+    SubGhzKeystoreKeeloqCandidate* keeloq_candidates;
+    size_t keeloq_candidates_count;
+    SubGhzKeystoreKeeloqSerialCache keeloq_serial_cache[SUBGHZ_KEYSTORE_KEELOQ_SERIAL_CACHE_SIZE];
+};
+
+// Order in which learning types are tried for keys with unknown learning type
+static const uint16_t subghz_keystore_keeloq_unknown_learning[] = {
+    KEELOQ_LEARNING_SIMPLE,
+    KEELOQ_LEARNING_NORMAL,
+    KEELOQ_LEARNING_SECURE,
+    KEELOQ_LEARNING_MAGIC_XOR_TYPE_1,
 };
 
 SubGhzKeystore* subghz_keystore_alloc() {
     SubGhzKeystore* instance = malloc(sizeof(SubGhzKeystore));
 
     SubGhzKeyArray_init(instance->data);
+    instance->keeloq_candidates = NULL;
+    instance->keeloq_candidates_count = 0;
+    memset(instance->keeloq_serial_cache, 0, sizeof(instance->keeloq_serial_cache));
 
     return instance;
 }
@@ -47,10 +71,77 @@ void subghz_keystore_free(SubGhzKeystore* instance) {
             manufacture_code->key = 0;
         }
     SubGhzKeyArray_clear(instance->data);
+    free(instance->keeloq_candidates);
 
     free(instance);
 }
 
+static uint64_t subghz_keystore_keeloq_mirror_key(uint64_t key) {
+    uint64_t key_mirror = 0;
+    for(uint8_t i = 0; i < 64; i += 8) {
+        key_mirror |= (uint64_t)(uint8_t)(key >> i) << (56 - i);
+    }
+    return key_mirror;
+}
+
+static bool subghz_keystore_keeloq_is_known_learning(uint16_t type) {
+    return (type == KEELOQ_LEARNING_SIMPLE) || (type == KEELOQ_LEARNING_NORMAL) ||
+           (type == KEELOQ_LEARNING_SECURE) || (type == KEELOQ_LEARNING_MAGIC_XOR_TYPE_1);
+}
+
+static void subghz_keystore_keeloq_index_build(SubGhzKeystore* instance) {
+    free(instance->keeloq_candidates);
+    instance->keeloq_candidates = NULL;
+    instance->keeloq_candidates_count = 0;
+    memset(instance->keeloq_serial_cache, 0, sizeof(instance->keeloq_serial_cache));
+
+    size_t keys_count = SubGhzKeyArray_size(instance->data);
+    furi_check(keys_count <= UINT16_MAX);
+
+    // Unknown learning type expands into every known type for direct and mirrored key
+    const size_t unknown_expansion = COUNT_OF(subghz_keystore_keeloq_unknown_learning) * 2;
+    size_t candidates_count = 0;
+    for
+        M_EACH(manufacture_code, instance->data, SubGhzKeyArray_t) {
+            if(manufacture_code->type == KEELOQ_LEARNING_UNKNOWN) {
+                candidates_count += unknown_expansion;
+            } else if(subghz_keystore_keeloq_is_known_learning(manufacture_code->type)) {
+                candidates_count++;
+            }
+        }
+    if(candidates_count == 0) return;
+
+    SubGhzKeystoreKeeloqCandidate* candidates =
+        malloc(candidates_count * sizeof(SubGhzKeystoreKeeloqCandidate));
+    size_t cursor = 0;
+    for(size_t key_index = 0; key_index < keys_count; key_index++) {
+        const SubGhzKey* manufacture_code = SubGhzKeyArray_cget(instance->data, key_index);
+        if(manufacture_code->type == KEELOQ_LEARNING_UNKNOWN) {
+            uint64_t key_mirror = subghz_keystore_keeloq_mirror_key(manufacture_code->key);
+            for(size_t i = 0; i < COUNT_OF(subghz_keystore_keeloq_unknown_learning); i++) {
+                candidates[cursor].key = manufacture_code->key;
+                candidates[cursor].type = subghz_keystore_keeloq_unknown_learning[i];
+                candidates[cursor].key_index = key_index;
+                cursor++;
+                candidates[cursor].key = key_mirror;
+                candidates[cursor].type = subghz_keystore_keeloq_unknown_learning[i];
+                candidates[cursor].key_index = key_index;
+                cursor++;
+            }
+        } else if(subghz_keystore_keeloq_is_known_learning(manufacture_code->type)) {
+            candidates[cursor].key = manufacture_code->key;
+            candidates[cursor].type = manufacture_code->type;
+            candidates[cursor].key_index = key_index;
+            cursor++;
+        }
+    }
+    furi_assert(cursor == candidates_count);
+
+    instance->keeloq_candidates = candidates;
+    instance->keeloq_candidates_count = candidates_count;
+    FURI_LOG_I(TAG, "KeeLoq candidates: %d of %d keys", candidates_count, keys_count);
+}
+
 static void subghz_keystore_add_key(
     SubGhzKeystore* instance,
     const char* name,
@@ -233,6 +324,8 @@ bool subghz_keystore_load(SubGhzKeystore* instance, const char* file_name) {
 
     string_clear(filetype);
 
+    subghz_keystore_keeloq_index_build(instance);
+
     return result;
 }
 
@@ -336,6 +429,58 @@ SubGhzKeyArray_t* subghz_keystore_get_data(SubGhzKeystore* instance) {
     return &instance->data;
 }
 
+const SubGhzKeystoreKeeloqCandidate*
+    subghz_keystore_get_keeloq_candidates(SubGhzKeystore* instance, size_t* count) {
+    furi_assert(instance);
+    furi_assert(count);
+    *count = instance->keeloq_candidates_count;
+    return instance->keeloq_candidates;
+}
+
+const char* subghz_keystore_get_keeloq_candidate_name(
+    SubGhzKeystore* instance,
+    const SubGhzKeystoreKeeloqCandidate* candidate) {
+    furi_assert(instance);
+    furi_assert(candidate);
+    const SubGhzKey* manufacture_code = SubGhzKeyArray_cget(instance->data, candidate->key_index);
+    return string_get_cstr(manufacture_code->name);
+}
+
+static inline SubGhzKeystoreKeeloqSerialCache*
+    subghz_keystore_keeloq_serial_cache_slot(SubGhzKeystore* instance, uint32_t serial) {
+    uint32_t hash = serial ^ (serial >> 10) ^ (serial >> 20);
+    return &instance->keeloq_serial_cache[hash % SUBGHZ_KEYSTORE_KEELOQ_SERIAL_CACHE_SIZE];
+}
+
+bool subghz_keystore_get_keeloq_cached_candidate(
+    SubGhzKeystore* instance,
+    uint32_t serial,
+    size_t* index) {
+    furi_assert(instance);
+    furi_assert(index);
+    SubGhzKeystoreKeeloqSerialCache* slot =
+        subghz_keystore_keeloq_serial_cache_slot(instance, serial);
+    if(slot->valid && slot->serial == serial &&
+       slot->candidate_index < instance->keeloq_candidates_count) {
+        *index = slot->candidate_index;
+        return true;
+    }
+    return false;
+}
+
+void subghz_keystore_set_keeloq_cached_candidate(
+    SubGhzKeystore* instance,
+    uint32_t serial,
+    size_t index) {
+    furi_assert(instance);
+    furi_assert(index < instance->keeloq_candidates_count);
+    SubGhzKeystoreKeeloqSerialCache* slot =
+        subghz_keystore_keeloq_serial_cache_slot(instance, serial);
+    slot->serial = serial;
+    slot->candidate_index = index;
+    slot->valid = true;
+}
+
 bool subghz_keystore_raw_encrypted_save(
     const char* input_file_name,
     const char* output_file_name,
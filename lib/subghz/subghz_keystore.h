@@ -14,6 +14,13 @@ ARRAY_DEF(SubGhzKeyArray, SubGhzKey, M_POD_OPLIST)
 
 #define M_OPL_SubGhzKeyArray_t() ARRAY_OPLIST(SubGhzKeyArray, M_POD_OPLIST)
 
+/** Precomputed KeeLoq manufacture key variant */
+typedef struct {
+    uint64_t key; /**< Manufacture key, already mirrored if needed */
+    uint16_t type; /**< Concrete learning type, never KEELOQ_LEARNING_UNKNOWN */
+    uint16_t key_index; /**< Index of the source SubGhzKey in keystore data */
+} SubGhzKeystoreKeeloqCandidate;
+
 typedef struct SubGhzKeystore SubGhzKeystore;
 
 /**
@@ -70,3 +77,47 @@ bool subghz_keystore_raw_encrypted_save(
  * @return true On success
  */
 bool subghz_keystore_raw_get_data(const char* file_name, size_t offset, uint8_t* data, size_t len);
+
+/** 
+ * Get KeeLoq candidates table, precomputed on keystore load.
+ * Keys with unknown learning type are expanded into all known learning types,
+ * both for direct and mirrored key, in the order they must be checked.
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param count Returned candidates count
+ * @return const SubGhzKeystoreKeeloqCandidate* candidates array, NULL if empty
+ */
+const SubGhzKeystoreKeeloqCandidate*
+    subghz_keystore_get_keeloq_candidates(SubGhzKeystore* instance, size_t* count);
+
+/** 
+ * Get manufacture name of KeeLoq candidate
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param candidate Pointer to a SubGhzKeystoreKeeloqCandidate from this keystore
+ * @return manufacture name
+ */
+const char* subghz_keystore_get_keeloq_candidate_name(
+    SubGhzKeystore* instance,
+    const SubGhzKeystoreKeeloqCandidate* candidate);
+
+/** 
+ * Get index of the KeeLoq candidate that last matched given serial
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param serial Remote serial number (28bit)
+ * @param index Returned candidate index
+ * @return true if serial is cached
+ */
+bool subghz_keystore_get_keeloq_cached_candidate(
+    SubGhzKeystore* instance,
+    uint32_t serial,
+    size_t* index);
+
+/** 
+ * Remember KeeLoq candidate that matched given serial
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param serial Remote serial number (28bit)
+ * @param index Candidate index
+ */
+void subghz_keystore_set_keeloq_cached_candidate(
+    SubGhzKeystore* instance,
+    uint32_t serial,
+    size_t index);
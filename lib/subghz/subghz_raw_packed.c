@@ -0,0 +1,56 @@
+#include "subghz_raw_packed.h"
+
+#include <furi.h>
+
+#define TAG "SubGhzRawPacked"
+
+size_t subghz_raw_packed_encode(const int32_t* samples, size_t count, uint8_t* output) {
+    furi_assert(samples);
+    furi_assert(output);
+
+    size_t size = 0;
+    for(size_t i = 0; i < count; i++) {
+        // zigzag: small negative and positive durations both become small numbers
+        uint32_t value = ((uint32_t)samples[i] << 1) ^ (uint32_t)(samples[i] >> 31);
+        while(value >= 0x80) {
+            output[size++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        output[size++] = (uint8_t)value;
+    }
+    return size;
+}
+
+void subghz_raw_packed_decoder_reset(SubGhzRawPackedDecoder* decoder) {
+    furi_assert(decoder);
+    decoder->value = 0;
+    decoder->shift = 0;
+}
+
+size_t subghz_raw_packed_decode(
+    SubGhzRawPackedDecoder* decoder,
+    const uint8_t* data,
+    size_t size,
+    SubGhzRawPackedCallback callback,
+    void* context) {
+    furi_assert(decoder);
+    furi_assert(data);
+    furi_assert(callback);
+
+    size_t count = 0;
+    for(size_t i = 0; i < size; i++) {
+        decoder->value |= (uint32_t)(data[i] & 0x7F) << decoder->shift;
+        if(data[i] & 0x80) {
+            decoder->shift += 7;
+            if(decoder->shift >= SUBGHZ_RAW_PACKED_SAMPLE_SIZE_MAX * 7) {
+                FURI_LOG_E(TAG, "Invalid sample in the stream");
+                subghz_raw_packed_decoder_reset(decoder);
+            }
+        } else {
+            callback(context, (int32_t)(decoder->value >> 1) ^ -(int32_t)(decoder->value & 1));
+            subghz_raw_packed_decoder_reset(decoder);
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/** Maximum size of one packed sample, bytes */
+#define SUBGHZ_RAW_PACKED_SAMPLE_SIZE_MAX 5
+
+typedef void (*SubGhzRawPackedCallback)(void* context, int32_t duration);
+
+/** Streaming decoder state, a sample may be split between two reads */
+typedef struct {
+    uint32_t value;
+    uint8_t shift;
+} SubGhzRawPackedDecoder;
+
+/**
+ * Pack signed durations, sign is level. Every sample is zigzag mapped and stored as LEB128 varint.
+ * @param samples Signed durations, us
+ * @param count Number of samples
+ * @param output Output buffer, at least count * SUBGHZ_RAW_PACKED_SAMPLE_SIZE_MAX bytes
+ * @return size of packed data, bytes
+ */
+size_t subghz_raw_packed_encode(const int32_t* samples, size_t count, uint8_t* output);
+
+/**
+ * Reset streaming decoder.
+ * @param decoder Pointer to a SubGhzRawPackedDecoder
+ */
+void subghz_raw_packed_decoder_reset(SubGhzRawPackedDecoder* decoder);
+
+/**
+ * Unpack block of data. Incomplete sample at the end of block is kept in decoder.
+ * @param decoder Pointer to a SubGhzRawPackedDecoder
+ * @param data Packed data
+ * @param size Size of data, bytes
+ * @param callback SubGhzRawPackedCallback, called for every signed duration
+ * @param context Context for callback
+ * @return number of unpacked samples
+ */
+size_t subghz_raw_packed_decode(
+    SubGhzRawPackedDecoder* decoder,
+    const uint8_t* data,
+    size_t size,
+    SubGhzRawPackedCallback callback,
+    void* context);
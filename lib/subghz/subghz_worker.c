@@ -5,6 +5,8 @@
 
 #define TAG "SubGhzWorker"
 
+#define SUBGHZ_WORKER_BATCH_SIZE 64
+
 struct SubGhzWorker {
     FuriThread* thread;
     StreamBufferHandle_t stream;
@@ -18,7 +20,12 @@ struct SubGhzWorker {
 
     SubGhzWorkerOverrunCallback overrun_callback;
     SubGhzWorkerPairCallback pair_callback;
+    SubGhzWorkerPairBatchCallback pair_batch_callback;
     void* context;
+
+    LevelDuration rx_buffer[SUBGHZ_WORKER_BATCH_SIZE];
+    LevelDuration batch[SUBGHZ_WORKER_BATCH_SIZE];
+    size_t batch_count;
 };
 
 /** Rx callback timer
@@ -42,6 +49,24 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+static void subghz_worker_flush_batch(SubGhzWorker* instance) {
+    if(instance->batch_count) {
+        instance->pair_batch_callback(instance->context, instance->batch, instance->batch_count);
+        instance->batch_count = 0;
+    }
+}
+
+static void subghz_worker_send_pair(SubGhzWorker* instance, bool level, uint32_t duration) {
+    if(instance->pair_batch_callback) {
+        instance->batch[instance->batch_count++] = level_duration_make(level, duration);
+        if(instance->batch_count == SUBGHZ_WORKER_BATCH_SIZE) {
+            subghz_worker_flush_batch(instance);
+        }
+    } else if(instance->pair_callback) {
+        instance->pair_callback(instance->context, level, duration);
+    }
+}
+
 /** Worker callback thread
  * 
  * @param context 
@@ -50,13 +75,18 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
 static int32_t subghz_worker_thread_callback(void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration;
+    instance->batch_count = 0;
     while(instance->running) {
-        int ret =
-            xStreamBufferReceive(instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
+        // Drain as much as available in one call, wait for at least one element
+        size_t ret = xStreamBufferReceive(
+            instance->stream, instance->rx_buffer, sizeof(instance->rx_buffer), 10);
+        size_t count = ret / sizeof(LevelDuration);
+        for(size_t i = 0; i < count; i++) {
+            LevelDuration level_duration = instance->rx_buffer[i];
             if(level_duration_is_reset(level_duration)) {
                 FURI_LOG_E(TAG, "Overrun buffer");
+                // Deliver everything received before overrun, then reset decoders
+                if(instance->pair_batch_callback) subghz_worker_flush_batch(instance);
                 if(instance->overrun_callback) instance->overrun_callback(instance->context);
             } else {
                 bool level = level_duration_get_level(level_duration);
@@ -68,21 +98,20 @@ static int32_t subghz_worker_thread_callback(void* context) {
                         instance->filter_level_duration.duration += duration;
 
                     } else if(instance->filter_level_duration.level != level) {
-                        if(instance->pair_callback)
-                            instance->pair_callback(
-                                instance->context,
-                                instance->filter_level_duration.level,
-                                instance->filter_level_duration.duration);
+                        subghz_worker_send_pair(
+                            instance,
+                            instance->filter_level_duration.level,
+                            instance->filter_level_duration.duration);
 
                         instance->filter_level_duration.duration = duration;
                         instance->filter_level_duration.level = level;
                     }
                 } else {
-                    if(instance->pair_callback)
-                        instance->pair_callback(instance->context, level, duration);
+                    subghz_worker_send_pair(instance, level, duration);
                 }
             }
         }
+        if(instance->pair_batch_callback) subghz_worker_flush_batch(instance);
     }
 
     return 0;
@@ -127,6 +156,13 @@ void subghz_worker_set_pair_callback(SubGhzWorker* instance, SubGhzWorkerPairCal
     instance->pair_callback = callback;
 }
 
+void subghz_worker_set_pair_batch_callback(
+    SubGhzWorker* instance,
+    SubGhzWorkerPairBatchCallback callback) {
+    furi_assert(instance);
+    instance->pair_batch_callback = callback;
+}
+
 void subghz_worker_set_context(SubGhzWorker* instance, void* context) {
     furi_assert(instance);
     instance->context = context;
@@ -20,6 +20,7 @@
 #define SUBGHZ_KEY_FILE_TYPE "Flipper SubGhz Key File"
 
 #define SUBGHZ_RAW_FILE_VERSION 1
+#define SUBGHZ_RAW_FILE_VERSION_PACKED 2
 #define SUBGHZ_RAW_FILE_TYPE "Flipper SubGhz RAW File"
 
 //
@@ -39,6 +40,10 @@ typedef bool (*SubGhzDeserialize)(void* context, FlipperFormat* flipper_format);
 
 // Decoder specific
 typedef void (*SubGhzDecoderFeed)(void* decoder, bool level, uint32_t duration);
+typedef void (*SubGhzDecoderFeedBatch)(
+    void* decoder,
+    const LevelDuration* level_duration,
+    size_t count);
 typedef void (*SubGhzDecoderReset)(void* decoder);
 typedef uint8_t (*SubGhzGetHashData)(void* decoder);
 typedef void (*SubGhzGetString)(void* decoder, string_t output);
@@ -52,6 +57,7 @@ typedef struct {
     SubGhzFree free;
 
     SubGhzDecoderFeed feed;
+    SubGhzDecoderFeedBatch feed_batch; // Optional, receiver falls back to feed
     SubGhzDecoderReset reset;
 
     SubGhzGetHashData get_hash_data;
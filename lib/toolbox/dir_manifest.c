@@ -0,0 +1,291 @@
+#include "dir_manifest.h"
+#include "md5.h"
+#include "stream/stream.h"
+#include "stream/buffered_file_stream.h"
+
+#define TAG "DirManifest"
+
+#define DIR_MANIFEST_INDEX_TMP_NAME DIR_MANIFEST_INDEX_NAME ".tmp"
+#define DIR_MANIFEST_MAGIC "HIX1"
+#define DIR_MANIFEST_MAGIC_SIZE 4
+#define DIR_MANIFEST_BUFFER_SIZE 1024
+// Index records are searched this far ahead, then the file is treated as new
+#define DIR_MANIFEST_LOOKAHEAD 16
+
+typedef struct {
+    uint64_t size;
+    uint32_t mtime;
+    uint8_t md5[DIR_MANIFEST_HASH_SIZE];
+} __attribute__((packed)) DirManifestRecord;
+
+struct DirManifest {
+    DirWalk* dir_walk;
+    Storage* storage;
+    File* file;
+    uint8_t* buffer;
+    string_t root;
+    string_t path;
+    string_t record_path;
+
+    Stream* index_in;
+    Stream* index_out;
+    bool index_in_open;
+    bool index_out_open;
+    bool changed;
+    bool finished;
+
+    FS_Error error;
+    DirManifestStats stats;
+};
+
+static bool dir_manifest_filter(const char* name, FileInfo* fileinfo, void* ctx) {
+    UNUSED(fileinfo);
+    UNUSED(ctx);
+    return strncmp(name, DIR_MANIFEST_INDEX_NAME, strlen(DIR_MANIFEST_INDEX_NAME)) != 0;
+}
+
+DirManifest* dir_manifest_alloc(Storage* storage) {
+    DirManifest* manifest = malloc(sizeof(DirManifest));
+    manifest->storage = storage;
+    manifest->dir_walk = dir_walk_alloc(storage);
+    dir_walk_set_filter_cb(manifest->dir_walk, dir_manifest_filter, NULL);
+    manifest->file = storage_file_alloc(storage);
+    manifest->buffer = malloc(DIR_MANIFEST_BUFFER_SIZE);
+    manifest->index_in = buffered_file_stream_alloc(storage);
+    manifest->index_out = buffered_file_stream_alloc(storage);
+    string_init(manifest->root);
+    string_init(manifest->path);
+    string_init(manifest->record_path);
+    return manifest;
+}
+
+void dir_manifest_free(DirManifest* manifest) {
+    string_clear(manifest->record_path);
+    string_clear(manifest->path);
+    string_clear(manifest->root);
+    stream_free(manifest->index_out);
+    stream_free(manifest->index_in);
+    free(manifest->buffer);
+    storage_file_free(manifest->file);
+    dir_walk_free(manifest->dir_walk);
+    free(manifest);
+}
+
+static void dir_manifest_index_path(DirManifest* manifest, string_t path, const char* name) {
+    string_printf(path, "%s/%s", string_get_cstr(manifest->root), name);
+}
+
+static bool dir_manifest_index_open(DirManifest* manifest) {
+    uint8_t magic[DIR_MANIFEST_MAGIC_SIZE];
+
+    dir_manifest_index_path(manifest, manifest->path, DIR_MANIFEST_INDEX_NAME);
+    manifest->index_in_open = buffered_file_stream_open(
+        manifest->index_in, string_get_cstr(manifest->path), FSAM_READ, FSOM_OPEN_EXISTING);
+    if(manifest->index_in_open) {
+        if(stream_read(manifest->index_in, magic, sizeof(magic)) != sizeof(magic) ||
+           memcmp(magic, DIR_MANIFEST_MAGIC, sizeof(magic)) != 0) {
+            FURI_LOG_W(TAG, "Unknown index format, rebuilding");
+            buffered_file_stream_close(manifest->index_in);
+            manifest->index_in_open = false;
+            manifest->changed = true;
+        }
+    } else {
+        buffered_file_stream_close(manifest->index_in);
+    }
+
+    // Created before the walk starts, so directory entries don't change while walking
+    dir_manifest_index_path(manifest, manifest->path, DIR_MANIFEST_INDEX_TMP_NAME);
+    manifest->index_out_open = buffered_file_stream_open(
+        manifest->index_out, string_get_cstr(manifest->path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if(manifest->index_out_open) {
+        manifest->index_out_open =
+            stream_write(manifest->index_out, (const uint8_t*)DIR_MANIFEST_MAGIC, sizeof(magic)) ==
+            sizeof(magic);
+    }
+    if(!manifest->index_out_open) {
+        buffered_file_stream_close(manifest->index_out);
+    }
+
+    return manifest->index_out_open;
+}
+
+static bool dir_manifest_record_read(DirManifest* manifest, DirManifestRecord* record) {
+    uint16_t path_size;
+    Stream* stream = manifest->index_in;
+
+    if(stream_read(stream, (uint8_t*)&path_size, sizeof(path_size)) != sizeof(path_size)) {
+        return false;
+    }
+    if(path_size >= DIR_MANIFEST_BUFFER_SIZE) return false;
+    if(stream_read(stream, manifest->buffer, path_size) != path_size) return false;
+    if(stream_read(stream, (uint8_t*)record, sizeof(DirManifestRecord)) !=
+       sizeof(DirManifestRecord)) {
+        return false;
+    }
+
+    manifest->buffer[path_size] = '\0';
+    string_set_str(manifest->record_path, (const char*)manifest->buffer);
+    return true;
+}
+
+static void dir_manifest_record_write(
+    DirManifest* manifest,
+    const char* path,
+    const DirManifestRecord* record) {
+    Stream* stream = manifest->index_out;
+    uint16_t path_size = strlen(path);
+
+    bool success = stream_write(stream, (const uint8_t*)&path_size, sizeof(path_size)) ==
+                   sizeof(path_size);
+    success = success && stream_write(stream, (const uint8_t*)path, path_size) == path_size;
+    success = success && stream_write(stream, (const uint8_t*)record, sizeof(DirManifestRecord)) ==
+                             sizeof(DirManifestRecord);
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Index write failed");
+        buffered_file_stream_close(stream);
+        manifest->index_out_open = false;
+    }
+}
+
+// Index follows the walk order, so the record is usually the next one
+static bool
+    dir_manifest_record_find(DirManifest* manifest, const char* path, DirManifestRecord* record) {
+    if(!manifest->index_in_open) return false;
+
+    size_t position = stream_tell(manifest->index_in);
+    for(size_t i = 0; i < DIR_MANIFEST_LOOKAHEAD; i++) {
+        if(!dir_manifest_record_read(manifest, record)) break;
+        if(string_cmp_str(manifest->record_path, path) == 0) {
+            // Skipped records belong to removed files
+            if(i > 0) manifest->changed = true;
+            return true;
+        }
+    }
+
+    stream_seek(manifest->index_in, position, StreamOffsetFromStart);
+    return false;
+}
+
+static bool dir_manifest_hash_file(DirManifest* manifest, const char* path, uint8_t* hash) {
+    File* file = manifest->file;
+    bool result = false;
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        md5_context* md5_ctx = malloc(sizeof(md5_context));
+        md5_starts(md5_ctx);
+
+        size_t read_size;
+        do {
+            read_size = storage_file_read(file, manifest->buffer, DIR_MANIFEST_BUFFER_SIZE);
+            md5_update(md5_ctx, manifest->buffer, read_size);
+        } while(read_size == DIR_MANIFEST_BUFFER_SIZE);
+
+        md5_finish(md5_ctx, hash);
+        free(md5_ctx);
+        result = (storage_file_get_error(file) == FSE_OK);
+    }
+
+    manifest->error = storage_file_get_error(file);
+    storage_file_close(file);
+    return result;
+}
+
+bool dir_manifest_open(DirManifest* manifest, const char* path) {
+    string_set_str(manifest->root, path);
+    memset(&manifest->stats, 0, sizeof(DirManifestStats));
+    manifest->error = FSE_OK;
+    manifest->changed = false;
+    manifest->finished = false;
+
+    if(!dir_manifest_index_open(manifest)) {
+        FURI_LOG_W(TAG, "Can't create index in %s, hashing all files", path);
+    }
+
+    return dir_walk_open(manifest->dir_walk, path);
+}
+
+DirWalkResult
+    dir_manifest_read(DirManifest* manifest, string_t return_path, DirManifestEntry* entry) {
+    FileInfo* fileinfo = &entry->fileinfo;
+    DirWalkResult result = dir_walk_read(manifest->dir_walk, manifest->path, fileinfo);
+
+    memset(entry->md5, 0, DIR_MANIFEST_HASH_SIZE);
+    if(result == DirWalkLast) {
+        manifest->finished = true;
+    } else if(result == DirWalkOK && !(fileinfo->flags & FSF_DIRECTORY)) {
+        const char* full_path = string_get_cstr(manifest->path);
+        const char* path = full_path + string_size(manifest->root) + 1;
+        DirManifestRecord record;
+
+        if(fileinfo->mtime && dir_manifest_record_find(manifest, path, &record) &&
+           record.size == fileinfo->size && record.mtime == fileinfo->mtime) {
+            memcpy(entry->md5, record.md5, DIR_MANIFEST_HASH_SIZE);
+            manifest->stats.cached++;
+        } else if(dir_manifest_hash_file(manifest, full_path, entry->md5)) {
+            manifest->stats.hashed++;
+            manifest->changed = true;
+        } else {
+            result = DirWalkError;
+        }
+
+        // Without mtime there is no way to tell whether the file was changed
+        if(result == DirWalkOK && fileinfo->mtime && manifest->index_out_open) {
+            record.size = fileinfo->size;
+            record.mtime = fileinfo->mtime;
+            memcpy(record.md5, entry->md5, DIR_MANIFEST_HASH_SIZE);
+            dir_manifest_record_write(manifest, path, &record);
+        }
+    }
+
+    if(return_path != NULL) {
+        string_set(return_path, manifest->path);
+    }
+
+    return result;
+}
+
+FS_Error dir_manifest_get_error(DirManifest* manifest) {
+    if(manifest->error != FSE_OK) {
+        return manifest->error;
+    }
+    return dir_walk_get_error(manifest->dir_walk);
+}
+
+void dir_manifest_get_stats(DirManifest* manifest, DirManifestStats* stats) {
+    *stats = manifest->stats;
+}
+
+void dir_manifest_close(DirManifest* manifest) {
+    dir_walk_close(manifest->dir_walk);
+
+    if(manifest->index_in_open) {
+        // Trailing records belong to removed files
+        if(!stream_eof(manifest->index_in)) manifest->changed = true;
+        buffered_file_stream_close(manifest->index_in);
+        manifest->index_in_open = false;
+    }
+
+    string_t index_path;
+    string_init(index_path);
+    dir_manifest_index_path(manifest, index_path, DIR_MANIFEST_INDEX_NAME);
+    dir_manifest_index_path(manifest, manifest->path, DIR_MANIFEST_INDEX_TMP_NAME);
+
+    bool index_complete = manifest->index_out_open;
+    if(manifest->index_out_open) {
+        index_complete = buffered_file_stream_close(manifest->index_out);
+        manifest->index_out_open = false;
+    }
+
+    // Partially walked tree would drop the rest of the index
+    if(index_complete && manifest->finished && manifest->changed) {
+        storage_common_remove(manifest->storage, string_get_cstr(index_path));
+        storage_common_rename(
+            manifest->storage, string_get_cstr(manifest->path), string_get_cstr(index_path));
+    } else {
+        storage_common_remove(manifest->storage, string_get_cstr(manifest->path));
+    }
+
+    string_clear(index_path);
+    string_reset(manifest->root);
+}
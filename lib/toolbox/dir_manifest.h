@@ -0,0 +1,81 @@
+#pragma once
+#include <storage/storage.h>
+#include "dir_walk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DIR_MANIFEST_HASH_SIZE 16
+#define DIR_MANIFEST_INDEX_NAME ".hash_index"
+
+typedef struct DirManifest DirManifest;
+
+typedef struct {
+    FileInfo fileinfo; /**< file info */
+    uint8_t md5[DIR_MANIFEST_HASH_SIZE]; /**< content hash, zeros for directories */
+} DirManifestEntry;
+
+typedef struct {
+    size_t cached; /**< hashes taken from the index */
+    size_t hashed; /**< files read and hashed */
+} DirManifestStats;
+
+/**
+ * Allocate DirManifest
+ * Walks directory tree and gives content hash for every file.
+ * Hashes are kept in a sidecar index in the walked directory, keyed by path, size and mtime,
+ * so unchanged files are not read again. Storages without mtime are always hashed.
+ * @param storage
+ * @return DirManifest*
+ */
+DirManifest* dir_manifest_alloc(Storage* storage);
+
+/**
+ * Free DirManifest
+ * @param manifest
+ */
+void dir_manifest_free(DirManifest* manifest);
+
+/**
+ * Open directory and its hash index
+ * @param manifest
+ * @param path
+ * @return true
+ * @return false
+ */
+bool dir_manifest_open(DirManifest* manifest, const char* path);
+
+/**
+ * Read next element, index files are skipped
+ * @param manifest
+ * @param return_path full path
+ * @param entry
+ * @return DirWalkResult
+ */
+DirWalkResult
+    dir_manifest_read(DirManifest* manifest, string_t return_path, DirManifestEntry* entry);
+
+/**
+ * Get error id
+ * @param manifest
+ * @return FS_Error
+ */
+FS_Error dir_manifest_get_error(DirManifest* manifest);
+
+/**
+ * Get hash statistics for the last open
+ * @param manifest
+ * @param stats
+ */
+void dir_manifest_get_stats(DirManifest* manifest, DirManifestStats* stats);
+
+/**
+ * Close directory, hash index is updated if the tree was walked to the end
+ * @param manifest
+ */
+void dir_manifest_close(DirManifest* manifest);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,11 +4,28 @@
 #include "file_stream.h"
 #include "stream_cache.h"
 
+typedef enum {
+    BufferedFileStreamReadAheadFlagFill = (1 << 0),
+    BufferedFileStreamReadAheadFlagExit = (1 << 1),
+} BufferedFileStreamReadAheadFlag;
+
+#define BufferedFileStreamReadAheadFlagAny \
+    (BufferedFileStreamReadAheadFlagFill | BufferedFileStreamReadAheadFlagExit)
+
 typedef struct {
     Stream stream_base;
     Stream* file_stream;
     StreamCache* cache;
     bool sync_pending;
+    BufferedFileStreamAccess access;
+
+    // Sequential access, next block is read to read_ahead_cache by read_ahead_thread
+    StreamCache* read_ahead_cache;
+    FuriThread* read_ahead_thread;
+    FuriSemaphore* read_ahead_done;
+    bool read_ahead_pending;
+    // File offset of the cache start, valid while read ahead is pending
+    size_t read_ahead_cache_offset;
 } BufferedFileStream;
 
 static void buffered_file_stream_free(BufferedFileStream* stream);
@@ -21,14 +38,23 @@ static size_t buffered_file_stream_size(BufferedFileStream* stream);
 static size_t
     buffered_file_stream_write(BufferedFileStream* stream, const uint8_t* data, size_t size);
 static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* data, size_t size);
+static size_t buffered_file_stream_peek(BufferedFileStream* stream, const uint8_t** data);
 static bool buffered_file_stream_delete_and_insert(
     BufferedFileStream* stream,
     size_t delete_size,
     StreamWriteCB write_callback,
     const void* ctx);
+static bool buffered_file_stream_delete_and_insert_batch(
+    BufferedFileStream* stream,
+    const StreamEdit* edits,
+    size_t count);
 
 static bool buffered_file_stream_flush(BufferedFileStream* stream);
 static bool buffered_file_stream_unread(BufferedFileStream* stream);
+static size_t buffered_file_stream_fill(BufferedFileStream* stream);
+static void buffered_file_stream_read_ahead_wait(BufferedFileStream* stream);
+static bool buffered_file_stream_read_ahead_drop(BufferedFileStream* stream);
+static int32_t buffered_file_stream_read_ahead_thread(void* context);
 
 const StreamVTable buffered_file_stream_vtable = {
     .free = (StreamFreeFn)buffered_file_stream_free,
@@ -40,14 +66,38 @@ const StreamVTable buffered_file_stream_vtable = {
     .write = (StreamWriteFn)buffered_file_stream_write,
     .read = (StreamReadFn)buffered_file_stream_read,
     .delete_and_insert = (StreamDeleteAndInsertFn)buffered_file_stream_delete_and_insert,
+    .peek = (StreamPeekFn)buffered_file_stream_peek,
+    .delete_and_insert_batch =
+        (StreamDeleteAndInsertBatchFn)buffered_file_stream_delete_and_insert_batch,
 };
 
 Stream* buffered_file_stream_alloc(Storage* storage) {
+    return buffered_file_stream_alloc_ex(
+        storage, BUFFERED_FILE_STREAM_CACHE_SIZE, BufferedFileStreamAccessRandom);
+}
+
+Stream* buffered_file_stream_alloc_ex(
+    Storage* storage,
+    size_t cache_size,
+    BufferedFileStreamAccess access) {
     BufferedFileStream* stream = malloc(sizeof(BufferedFileStream));
 
     stream->file_stream = file_stream_alloc(storage);
-    stream->cache = stream_cache_alloc();
+    stream->cache = stream_cache_alloc(cache_size);
     stream->sync_pending = false;
+    stream->access = access;
+
+    if(access == BufferedFileStreamAccessSequential) {
+        stream->read_ahead_cache = stream_cache_alloc(cache_size);
+        stream->read_ahead_done = furi_semaphore_alloc(1, 0);
+        stream->read_ahead_thread = furi_thread_alloc();
+        furi_thread_set_name(stream->read_ahead_thread, "StreamReadAhead");
+        furi_thread_set_stack_size(stream->read_ahead_thread, 1024);
+        furi_thread_set_context(stream->read_ahead_thread, stream);
+        furi_thread_set_callback(
+            stream->read_ahead_thread, buffered_file_stream_read_ahead_thread);
+        furi_thread_start(stream->read_ahead_thread);
+    }
 
     stream->stream_base.vtable = &buffered_file_stream_vtable;
     return (Stream*)stream;
@@ -90,27 +140,44 @@ FS_Error buffered_file_stream_get_error(Stream* _stream) {
     furi_assert(_stream);
     BufferedFileStream* stream = (BufferedFileStream*)_stream;
     furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    buffered_file_stream_read_ahead_wait(stream);
     return file_stream_get_error(stream->file_stream);
 }
 
 static void buffered_file_stream_free(BufferedFileStream* stream) {
     furi_assert(stream);
+    if(stream->read_ahead_thread) {
+        // Pending read is completed before exit
+        furi_thread_flags_set(
+            furi_thread_get_id(stream->read_ahead_thread), BufferedFileStreamReadAheadFlagExit);
+        furi_thread_join(stream->read_ahead_thread);
+        furi_thread_free(stream->read_ahead_thread);
+        furi_semaphore_free(stream->read_ahead_done);
+        stream_cache_free(stream->read_ahead_cache);
+    }
     stream_free(stream->file_stream);
     stream_cache_free(stream->cache);
     free(stream);
 }
 
 static bool buffered_file_stream_eof(BufferedFileStream* stream) {
+    // No need to wait for read ahead while there is cached data
+    if(stream->read_ahead_pending && !stream_cache_at_end(stream->cache)) return false;
+    buffered_file_stream_read_ahead_wait(stream);
+
     bool ret;
     const bool file_stream_eof = stream_eof(stream->file_stream);
     const bool cache_at_end = stream_cache_at_end(stream->cache);
     if(!stream->sync_pending) {
         ret = file_stream_eof && cache_at_end;
+        if(stream->read_ahead_thread) {
+            ret = ret && stream_cache_at_end(stream->read_ahead_cache);
+        }
     } else {
         const size_t remaining_size =
             stream_size(stream->file_stream) - stream_tell(stream->file_stream);
-        ret = stream_cache_size(stream->cache) >=
-              (remaining_size ? cache_at_end : file_stream_eof);
+        // Cached data overwrites the file starting from its current position
+        ret = cache_at_end && (stream_cache_size(stream->cache) >= remaining_size);
     }
     return ret;
 }
@@ -118,6 +185,7 @@ static bool buffered_file_stream_eof(BufferedFileStream* stream) {
 static void buffered_file_stream_clean(BufferedFileStream* stream) {
     // Not syncing because data will be deleted anyway
     stream->sync_pending = false;
+    buffered_file_stream_read_ahead_drop(stream);
     stream_cache_drop(stream->cache);
     stream_clean(stream->file_stream);
 }
@@ -131,7 +199,8 @@ static bool buffered_file_stream_seek(
 
     if(offset_type == StreamOffsetFromCurrent) {
         new_offset -= stream_cache_seek(stream->cache, offset);
-        if(new_offset < 0) {
+        // Sync leaves the file at the cache position, drop leaves it at the cache end
+        if(new_offset < 0 && !stream->sync_pending) {
             new_offset -= (int32_t)stream_cache_size(stream->cache);
         }
     }
@@ -140,6 +209,7 @@ static bool buffered_file_stream_seek(
         if(stream->sync_pending) {
             success = buffered_file_stream_sync((Stream*)stream);
         } else {
+            success = buffered_file_stream_read_ahead_drop(stream);
             stream_cache_drop(stream->cache);
         }
         if(success) {
@@ -151,14 +221,23 @@ static bool buffered_file_stream_seek(
 }
 
 static size_t buffered_file_stream_tell(BufferedFileStream* stream) {
+    // File stream is busy, but the cache position is known
+    if(stream->read_ahead_pending) {
+        return stream->read_ahead_cache_offset + stream_cache_pos(stream->cache);
+    }
+
     size_t pos = stream_tell(stream->file_stream) + stream_cache_pos(stream->cache);
     if(!stream->sync_pending) {
         pos -= stream_cache_size(stream->cache);
+        if(stream->read_ahead_thread) {
+            pos -= stream_cache_size(stream->read_ahead_cache);
+        }
     }
     return pos;
 }
 
 static size_t buffered_file_stream_size(BufferedFileStream* stream) {
+    buffered_file_stream_read_ahead_wait(stream);
     size_t size = stream_size(stream->file_stream);
     if(stream->sync_pending) {
         const size_t remaining_size = size - stream_tell(stream->file_stream);
@@ -178,6 +257,16 @@ static size_t
             if(!buffered_file_stream_unread(stream)) break;
         }
         while(need_to_write) {
+            if(stream->access == BufferedFileStreamAccessAppend &&
+               stream_cache_size(stream->cache) == 0 &&
+               need_to_write >= stream_cache_max_size(stream->cache)) {
+                // No point in copying data that fills the whole cache
+                const size_t size_written = stream_write(
+                    stream->file_stream, data + (size - need_to_write), need_to_write);
+                need_to_write -= size_written;
+                if(need_to_write) break;
+                continue;
+            }
             stream->sync_pending = true;
             need_to_write -=
                 stream_cache_write(stream->cache, data + (size - need_to_write), need_to_write);
@@ -199,12 +288,22 @@ static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* dat
             if(stream->sync_pending) {
                 if(!buffered_file_stream_flush(stream)) break;
             }
-            if(!stream_cache_fill(stream->cache, stream->file_stream)) break;
+            if(!buffered_file_stream_fill(stream)) break;
         }
     }
     return size - need_to_read;
 }
 
+static size_t buffered_file_stream_peek(BufferedFileStream* stream, const uint8_t** data) {
+    if(stream_cache_at_end(stream->cache)) {
+        if(stream->sync_pending) {
+            if(!buffered_file_stream_flush(stream)) return 0;
+        }
+        if(!buffered_file_stream_fill(stream)) return 0;
+    }
+    return stream_cache_peek(stream->cache, data);
+}
+
 static bool buffered_file_stream_delete_and_insert(
     BufferedFileStream* stream,
     size_t delete_size,
@@ -221,6 +320,21 @@ static bool buffered_file_stream_delete_and_insert(
     return success;
 }
 
+static bool buffered_file_stream_delete_and_insert_batch(
+    BufferedFileStream* stream,
+    const StreamEdit* edits,
+    size_t count) {
+    bool success = false;
+    do {
+        if(!(stream->sync_pending ? buffered_file_stream_flush(stream) :
+                                    buffered_file_stream_unread(stream)))
+            break;
+        if(!stream_delete_and_insert_batch(stream->file_stream, edits, count)) break;
+        success = true;
+    } while(false);
+    return success;
+}
+
 // Write the cache into the underlying stream and adjust seek position
 static bool buffered_file_stream_flush(BufferedFileStream* stream) {
     bool success = false;
@@ -238,15 +352,85 @@ static bool buffered_file_stream_flush(BufferedFileStream* stream) {
 
 // Drop read cache and adjust the underlying stream seek position
 static bool buffered_file_stream_unread(BufferedFileStream* stream) {
-    bool success = true;
+    bool success = buffered_file_stream_read_ahead_drop(stream);
     const size_t cache_size = stream_cache_size(stream->cache);
     if(cache_size > 0) {
         const size_t cache_pos = stream_cache_pos(stream->cache);
         if(cache_pos < cache_size) {
             const int32_t offset = cache_size - cache_pos;
-            success = stream_seek(stream->file_stream, -offset, StreamOffsetFromCurrent);
+            success = success &&
+                      stream_seek(stream->file_stream, -offset, StreamOffsetFromCurrent);
         }
         stream_cache_drop(stream->cache);
     }
     return success;
 }
+
+// Load the cache from read ahead data or from the file and start reading the next block
+static size_t buffered_file_stream_fill(BufferedFileStream* stream) {
+    if(!stream->read_ahead_thread) {
+        return stream_cache_fill(stream->cache, stream->file_stream);
+    }
+
+    buffered_file_stream_read_ahead_wait(stream);
+    size_t size = stream_cache_size(stream->read_ahead_cache);
+    if(size > 0) {
+        StreamCache* cache = stream->cache;
+        stream->cache = stream->read_ahead_cache;
+        stream->read_ahead_cache = cache;
+        stream_cache_drop(stream->read_ahead_cache);
+    } else {
+        size = stream_cache_fill(stream->cache, stream->file_stream);
+    }
+
+    // Short read means end of file, nothing to read ahead
+    if(size == stream_cache_max_size(stream->cache)) {
+        stream->read_ahead_cache_offset = stream_tell(stream->file_stream) - size;
+        stream->read_ahead_pending = true;
+        furi_thread_flags_set(
+            furi_thread_get_id(stream->read_ahead_thread), BufferedFileStreamReadAheadFlagFill);
+    }
+    return size;
+}
+
+// File stream must not be used while read ahead is pending
+static void buffered_file_stream_read_ahead_wait(BufferedFileStream* stream) {
+    if(stream->read_ahead_pending) {
+        furi_check(
+            furi_semaphore_acquire(stream->read_ahead_done, FuriWaitForever) == FuriStatusOk);
+        stream->read_ahead_pending = false;
+    }
+}
+
+// Drop read ahead data and adjust the underlying stream seek position
+static bool buffered_file_stream_read_ahead_drop(BufferedFileStream* stream) {
+    bool success = true;
+    if(stream->read_ahead_thread) {
+        buffered_file_stream_read_ahead_wait(stream);
+        const size_t read_ahead_size = stream_cache_size(stream->read_ahead_cache);
+        if(read_ahead_size > 0) {
+            success = stream_seek(
+                stream->file_stream, -(int32_t)read_ahead_size, StreamOffsetFromCurrent);
+            stream_cache_drop(stream->read_ahead_cache);
+        }
+    }
+    return success;
+}
+
+static int32_t buffered_file_stream_read_ahead_thread(void* context) {
+    BufferedFileStream* stream = context;
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            BufferedFileStreamReadAheadFlagAny, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & BufferedFileStreamReadAheadFlagFill) {
+            stream_cache_fill(stream->read_ahead_cache, stream->file_stream);
+            furi_semaphore_release(stream->read_ahead_done);
+        }
+        if(flags & BufferedFileStreamReadAheadFlagExit) {
+            break;
+        }
+    }
+
+    return 0;
+}
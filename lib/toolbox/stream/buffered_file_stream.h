@@ -7,12 +7,36 @@
 extern "C" {
 #endif
 
+#define BUFFERED_FILE_STREAM_CACHE_SIZE 1024U
+
+typedef enum {
+    /** No assumptions, default */
+    BufferedFileStreamAccessRandom,
+    /** Next cache block is read ahead in background while the current one is parsed */
+    BufferedFileStreamAccessSequential,
+    /** Writes larger than the cache bypass it */
+    BufferedFileStreamAccessAppend,
+} BufferedFileStreamAccess;
+
 /**
  * Allocate a file stream with buffered read operations
  * @return Stream*
  */
 Stream* buffered_file_stream_alloc(Storage* storage);
 
+/**
+ * Allocate a file stream with buffered read operations, custom cache size and access pattern.
+ * Sequential access uses a second cache of the same size and a read-ahead thread.
+ * @param storage Storage instance
+ * @param cache_size cache size in bytes
+ * @param access expected access pattern
+ * @return Stream*
+ */
+Stream* buffered_file_stream_alloc_ex(
+    Storage* storage,
+    size_t cache_size,
+    BufferedFileStreamAccess access);
+
 /**
  * Opens an existing file or creates a new one.
  * @param stream pointer to file stream object.
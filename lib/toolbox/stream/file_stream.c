@@ -2,6 +2,8 @@
 #include "stream_i.h"
 #include "file_stream.h"
 
+#define FILE_STREAM_MOVE_BUFFER_SIZE 512U
+
 typedef struct {
     Stream stream_base;
     Storage* storage;
@@ -21,6 +23,10 @@ static bool file_stream_delete_and_insert(
     size_t delete_size,
     StreamWriteCB write_callback,
     const void* ctx);
+static bool file_stream_delete_and_insert_batch(
+    FileStream* stream,
+    const StreamEdit* edits,
+    size_t count);
 
 const StreamVTable file_stream_vtable = {
     .free = (StreamFreeFn)file_stream_free,
@@ -32,6 +38,7 @@ const StreamVTable file_stream_vtable = {
     .write = (StreamWriteFn)file_stream_write,
     .read = (StreamReadFn)file_stream_read,
     .delete_and_insert = (StreamDeleteAndInsertFn)file_stream_delete_and_insert,
+    .delete_and_insert_batch = (StreamDeleteAndInsertBatchFn)file_stream_delete_and_insert_batch,
 };
 
 Stream* file_stream_alloc(Storage* storage) {
@@ -166,67 +173,229 @@ static bool file_stream_delete_and_insert(
     size_t delete_size,
     StreamWriteCB write_callback,
     const void* ctx) {
-    bool result = false;
     Stream* stream = (Stream*)_stream;
+    StreamEdit edit = {
+        .offset = stream_tell(stream),
+        .delete_size = delete_size,
+        .write_callback = write_callback,
+        .context = ctx,
+    };
+    return file_stream_delete_and_insert_batch(_stream, &edit, 1);
+}
 
-    // open scratchpad
-    Stream* scratch_stream = file_stream_alloc(_stream->storage);
+/********************************** Size counter **********************************/
 
-    // TODO: we need something like "storage_open_tmpfile and storage_close_tmpfile"
-    string_t scratch_name;
-    string_t tmp_name;
-    string_init(tmp_name);
-    storage_get_next_filename(
-        _stream->storage, STORAGE_ANY_PATH_PREFIX, ".scratch", ".pad", tmp_name, 255);
-    string_init_printf(scratch_name, ANY_PATH("%s.pad"), string_get_cstr(tmp_name));
-    string_clear(tmp_name);
+// Stream that only counts written bytes, used to get the size of data before it is written
 
-    do {
-        if(!file_stream_open(
-               scratch_stream, string_get_cstr(scratch_name), FSAM_READ_WRITE, FSOM_CREATE_NEW))
-            break;
+typedef struct {
+    Stream stream_base;
+    size_t size;
+} FileStreamCounter;
+
+static void file_stream_counter_free(FileStreamCounter* stream) {
+    UNUSED(stream);
+}
 
-        size_t current_position = stream_tell(stream);
-        size_t file_size = stream_size(stream);
+static bool file_stream_counter_eof(FileStreamCounter* stream) {
+    UNUSED(stream);
+    return true;
+}
 
-        size_t size_to_delete = file_size - current_position;
-        size_to_delete = MIN(delete_size, size_to_delete);
+static void file_stream_counter_clean(FileStreamCounter* stream) {
+    stream->size = 0;
+}
 
-        size_t size_to_copy_before = current_position;
-        size_t size_to_copy_after = file_size - current_position - size_to_delete;
+static bool
+    file_stream_counter_seek(FileStreamCounter* stream, int32_t offset, StreamOffset offset_type) {
+    UNUSED(stream);
+    UNUSED(offset);
+    UNUSED(offset_type);
+    return false;
+}
 
-        // copy file from 0 to insert position to scratchpad
-        if(!stream_rewind(stream)) break;
-        if(stream_copy(stream, scratch_stream, size_to_copy_before) != size_to_copy_before) break;
+static size_t file_stream_counter_size(FileStreamCounter* stream) {
+    return stream->size;
+}
+
+static size_t
+    file_stream_counter_write(FileStreamCounter* stream, const uint8_t* data, size_t size) {
+    UNUSED(data);
+    stream->size += size;
+    return size;
+}
+
+static size_t file_stream_counter_read(FileStreamCounter* stream, uint8_t* data, size_t size) {
+    UNUSED(stream);
+    UNUSED(data);
+    UNUSED(size);
+    return 0;
+}
+
+static bool file_stream_counter_delete_and_insert(
+    FileStreamCounter* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx) {
+    UNUSED(delete_size);
+    return write_callback ? write_callback((Stream*)stream, ctx) : true;
+}
+
+static const StreamVTable file_stream_counter_vtable = {
+    .free = (StreamFreeFn)file_stream_counter_free,
+    .eof = (StreamEOFFn)file_stream_counter_eof,
+    .clean = (StreamCleanFn)file_stream_counter_clean,
+    .seek = (StreamSeekFn)file_stream_counter_seek,
+    .tell = (StreamTellFn)file_stream_counter_size,
+    .size = (StreamSizeFn)file_stream_counter_size,
+    .write = (StreamWriteFn)file_stream_counter_write,
+    .read = (StreamReadFn)file_stream_counter_read,
+    .delete_and_insert = (StreamDeleteAndInsertFn)file_stream_counter_delete_and_insert,
+};
 
-        if(write_callback) {
-            if(!write_callback(scratch_stream, ctx)) break;
+static bool file_stream_get_insert_size(const StreamEdit* edit, size_t* size) {
+    FileStreamCounter counter = {
+        .stream_base.vtable = &file_stream_counter_vtable,
+        .size = 0,
+    };
+    bool result = true;
+    if(edit->write_callback) {
+        result = edit->write_callback((Stream*)&counter, edit->context);
+    }
+    *size = counter.size;
+    return result;
+}
+
+/********************************** Batch edit **********************************/
+
+typedef struct {
+    size_t insert_size;
+    // Shift of the data between this edit and the next one
+    int32_t shift;
+} FileStreamEditInfo;
+
+// Move data inside the file, chunks are copied from the side that is not overwritten
+static bool file_stream_move(
+    FileStream* stream,
+    size_t from,
+    size_t to,
+    size_t size,
+    uint8_t* buffer) {
+    bool result = true;
+    size_t moved = 0;
+
+    while(moved < size) {
+        size_t chunk = MIN(size - moved, FILE_STREAM_MOVE_BUFFER_SIZE);
+        size_t chunk_offset = (to < from) ? moved : (size - moved - chunk);
+
+        if(!storage_file_seek(stream->file, from + chunk_offset, true) ||
+           file_stream_read(stream, buffer, chunk) != chunk ||
+           !storage_file_seek(stream->file, to + chunk_offset, true) ||
+           file_stream_write(stream, buffer, chunk) != chunk) {
+            result = false;
+            break;
         }
-        size_t new_position = stream_tell(scratch_stream);
+        moved += chunk;
+    }
+
+    return result;
+}
+
+static bool file_stream_delete_and_insert_batch(
+    FileStream* stream,
+    const StreamEdit* edits,
+    size_t count) {
+    if(count == 0) return true;
 
-        // copy key file after insert position + size_to_delete to scratchpad
-        if(!stream_seek(stream, size_to_delete, StreamOffsetFromCurrent)) break;
-        if(stream_copy(stream, scratch_stream, size_to_copy_after) != size_to_copy_after) break;
+    bool result = false;
+    size_t file_size = file_stream_size(stream);
+    size_t* delete_sizes = malloc(sizeof(size_t) * count);
+    FileStreamEditInfo* info = malloc(sizeof(FileStreamEditInfo) * count);
+    uint8_t* buffer = malloc(FILE_STREAM_MOVE_BUFFER_SIZE);
 
-        size_t new_file_size = stream_size(scratch_stream);
+    do {
+        // Validate edits and get the size of data to insert, nothing is written yet
+        bool success = true;
+        size_t previous_end = 0;
+        int32_t shift = 0;
+        for(size_t i = 0; i < count && success; i++) {
+            if(edits[i].offset < previous_end || edits[i].offset > file_size) {
+                success = false;
+                break;
+            }
+            delete_sizes[i] = MIN(edits[i].delete_size, file_size - edits[i].offset);
+            previous_end = edits[i].offset + delete_sizes[i];
+
+            success = file_stream_get_insert_size(&edits[i], &info[i].insert_size);
+            shift += (int32_t)info[i].insert_size - (int32_t)delete_sizes[i];
+            info[i].shift = shift;
+        }
+        if(!success) break;
+
+        const int32_t total_shift = shift;
+
+        // Grow the file first, so the data can be moved beyond the old end
+        if(total_shift > 0) {
+            if(!storage_file_seek(stream->file, file_size, true)) break;
+            memset(buffer, 0, FILE_STREAM_MOVE_BUFFER_SIZE);
+            size_t need_to_write = total_shift;
+            while(need_to_write > 0 && success) {
+                size_t chunk = MIN(need_to_write, FILE_STREAM_MOVE_BUFFER_SIZE);
+                success = (file_stream_write(stream, buffer, chunk) == chunk);
+                need_to_write -= chunk;
+            }
+            if(!success) break;
+        }
 
-        // copy whole scratchpad file to the original file
-        if(!stream_rewind(stream)) break;
-        if(!stream_rewind(scratch_stream)) break;
-        if(stream_copy(scratch_stream, stream, new_file_size) != new_file_size) break;
+        // Data that moves to the start is moved first, starting from the first edit,
+        // then data that moves to the end, starting from the last edit.
+        // This way no data is overwritten before it is moved.
+        for(size_t i = 0; i < count && success; i++) {
+            if(info[i].shift < 0) {
+                size_t start = edits[i].offset + delete_sizes[i];
+                size_t end = (i + 1 < count) ? edits[i + 1].offset : file_size;
+                success =
+                    file_stream_move(stream, start, start + info[i].shift, end - start, buffer);
+            }
+        }
+        for(size_t i = count; i > 0 && success; i--) {
+            if(info[i - 1].shift > 0) {
+                size_t start = edits[i - 1].offset + delete_sizes[i - 1];
+                size_t end = (i < count) ? edits[i].offset : file_size;
+                success = file_stream_move(
+                    stream, start, start + info[i - 1].shift, end - start, buffer);
+            }
+        }
+        if(!success) break;
+
+        // Write new data into the gaps between the moved data
+        shift = 0;
+        for(size_t i = 0; i < count && success; i++) {
+            size_t position = edits[i].offset + shift;
+            success = storage_file_seek(stream->file, position, true);
+            if(success && edits[i].write_callback) {
+                success = edits[i].write_callback((Stream*)stream, edits[i].context);
+            }
+            // Callback must write the same data as at the size counting
+            success = success && (file_stream_tell(stream) == position + info[i].insert_size);
+            shift = info[i].shift;
+        }
+        if(!success) break;
+        size_t end_position = file_stream_tell(stream);
 
-        // and truncate original file
-        if(!storage_file_truncate(_stream->file)) break;
+        if(total_shift < 0) {
+            if(!storage_file_seek(stream->file, file_size + total_shift, true)) break;
+            if(!storage_file_truncate(stream->file)) break;
+        }
 
         // move seek pointer at insert end
-        if(!stream_seek(stream, new_position, StreamOffsetFromStart)) break;
+        if(!storage_file_seek(stream->file, end_position, true)) break;
 
         result = true;
     } while(false);
 
-    stream_free(scratch_stream);
-    storage_common_remove(_stream->storage, string_get_cstr(scratch_name));
-    string_clear(scratch_name);
+    free(buffer);
+    free(info);
+    free(delete_sizes);
 
     return result;
 }
@@ -53,6 +53,59 @@ bool stream_delete_and_insert(
     return stream->vtable->delete_and_insert(stream, delete_size, write_callback, ctx);
 }
 
+bool stream_delete_and_insert_batch(Stream* stream, const StreamEdit* edits, size_t count) {
+    furi_assert(stream);
+    furi_assert(edits || count == 0);
+    if(stream->vtable->delete_and_insert_batch) {
+        return stream->vtable->delete_and_insert_batch(stream, edits, count);
+    }
+
+    bool result = true;
+    size_t end_position = 0;
+    const size_t original_size = stream_size(stream);
+
+    // Edits must be sorted and must not overlap
+    size_t previous_end = 0;
+    for(size_t i = 0; i < count; i++) {
+        const StreamEdit* edit = &edits[i];
+        if(edit->offset < previous_end || edit->offset > original_size) return false;
+        previous_end = edit->offset + MIN(edit->delete_size, original_size - edit->offset);
+    }
+
+    // Edits are applied from the end so offsets of the remaining ones stay valid
+    for(size_t i = count; i > 0; i--) {
+        const StreamEdit* edit = &edits[i - 1];
+        size_t size = stream_size(stream);
+        // Data inserted by the next edits must not be deleted
+        size_t delete_size = MIN(edit->delete_size, original_size - edit->offset);
+
+        if(!stream_seek(stream, edit->offset, StreamOffsetFromStart) ||
+           !stream_delete_and_insert(stream, delete_size, edit->write_callback, edit->context)) {
+            result = false;
+            break;
+        }
+
+        if(i == count) {
+            end_position = stream_tell(stream);
+        } else {
+            end_position += stream_size(stream) - size;
+        }
+    }
+
+    if(result && count > 0) {
+        result = stream_seek(stream, end_position, StreamOffsetFromStart);
+    }
+
+    return result;
+}
+
+size_t stream_peek(Stream* stream, const uint8_t** data) {
+    furi_assert(stream);
+    furi_assert(data);
+    if(!stream->vtable->peek) return 0;
+    return stream->vtable->peek(stream, data);
+}
+
 /********************************** Some random helpers starts here **********************************/
 
 typedef struct {
@@ -67,8 +120,107 @@ static bool stream_write_struct(Stream* stream, const void* context) {
     return (stream_write(stream, write_data->data, write_data->size) == write_data->size);
 }
 
-bool stream_read_line(Stream* stream, string_t str_result) {
-    string_reset(str_result);
+void stream_string_cat_data(string_t str, const uint8_t* data, size_t size) {
+    // Text ends at the first null byte, the string can't hold it
+    const uint8_t* end = memchr(data, '\0', size);
+    if(end) size = end - data;
+
+    string_reserve(str, string_size(str) + size);
+    for(size_t i = 0; i < size; i++) {
+        string_push_back(str, data[i]);
+    }
+}
+
+static size_t stream_scan_delimiters(const uint8_t* data, size_t size, const char* delimiters) {
+    if(delimiters[1] == '\0') {
+        const uint8_t* found = memchr(data, delimiters[0], size);
+        return found ? (size_t)(found - data) : size;
+    }
+    for(size_t i = 0; i < size; i++) {
+        if(strchr(delimiters, data[i]) && data[i] != '\0') return i;
+    }
+    return size;
+}
+
+// Scan stream up to delimiter, data is copied to buffer only if it is not contiguous
+static bool stream_scan(
+    Stream* stream,
+    const char* delimiters,
+    bool include_delimiter,
+    string_t buffer,
+    const char** result,
+    size_t* result_size) {
+    const bool can_peek = (stream->vtable->peek != NULL);
+    const size_t chunk_size = 32;
+    uint8_t chunk[chunk_size];
+    bool use_buffer = !can_peek;
+    const uint8_t* data = NULL;
+    size_t size = 0;
+
+    *result = NULL;
+    *result_size = 0;
+    if(use_buffer) string_reset(buffer);
+
+    while(true) {
+        if(can_peek) {
+            size = stream_peek(stream, &data);
+        } else {
+            size = stream_read(stream, chunk, chunk_size);
+            data = chunk;
+        }
+        if(size == 0) break;
+
+        size_t scan_size = stream_scan_delimiters(data, size, delimiters);
+        const bool found = (scan_size < size);
+        if(found && include_delimiter) scan_size++;
+
+        if(!found && !use_buffer) {
+            // Data goes over buffer boundary, copy is unavoidable
+            use_buffer = true;
+            string_reset(buffer);
+        }
+        if(use_buffer) {
+            stream_string_cat_data(buffer, data, scan_size);
+        } else {
+            *result = (const char*)data;
+            *result_size = scan_size;
+        }
+
+        int32_t offset = can_peek ? (int32_t)scan_size : (int32_t)scan_size - (int32_t)size;
+        if(offset != 0 && !stream_seek(stream, offset, StreamOffsetFromCurrent)) break;
+        if(found) break;
+    }
+
+    if(use_buffer) {
+        *result = string_get_cstr(buffer);
+        *result_size = string_size(buffer);
+    }
+
+    return *result_size != 0;
+}
+
+bool stream_read_line_slice(Stream* stream, string_t buffer, const char** line, size_t* size) {
+    furi_assert(stream);
+    furi_assert(line);
+    furi_assert(size);
+    return stream_scan(stream, "\n", true, buffer, line, size);
+}
+
+bool stream_read_token_slice(
+    Stream* stream,
+    const char* delimiters,
+    string_t buffer,
+    const char** token,
+    size_t* size) {
+    furi_assert(stream);
+    furi_assert(delimiters);
+    furi_assert(token);
+    furi_assert(size);
+    return stream_scan(stream, delimiters, false, buffer, token, size);
+}
+
+// Stream without buffer is read by small chunks
+static bool stream_read_line_unbuffered(Stream* stream, string_t str_result) {
     const uint8_t buffer_size = 32;
     uint8_t buffer[buffer_size];
 
@@ -102,6 +254,33 @@ bool stream_read_line(Stream* stream, string_t str_result) {
     return string_size(str_result) != 0;
 }
 
+bool stream_read_line(Stream* stream, string_t str_result) {
+    string_reset(str_result);
+    if(!stream->vtable->peek) {
+        return stream_read_line_unbuffered(stream, str_result);
+    }
+
+    const uint8_t* data;
+    size_t size;
+    while((size = stream_peek(stream, &data)) > 0) {
+        const uint8_t* eol = memchr(data, '\n', size);
+        const size_t line_size = eol ? (size_t)(eol - data + 1) : size;
+        // Copy line without CR in as few appends as possible
+        const uint8_t* span = data;
+        const uint8_t* end = data + line_size;
+        while(span < end) {
+            const uint8_t* cr = memchr(span, '\r', end - span);
+            const uint8_t* span_end = cr ? cr : end;
+            stream_string_cat_data(str_result, span, span_end - span);
+            span = span_end + (cr ? 1 : 0);
+        }
+        if(!stream_seek(stream, line_size, StreamOffsetFromCurrent)) break;
+        if(eol) break;
+    }
+
+    return string_size(str_result) != 0;
+}
+
 bool stream_rewind(Stream* stream) {
     furi_assert(stream);
     return stream_seek(stream, 0, StreamOffsetFromStart);
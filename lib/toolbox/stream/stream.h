@@ -19,6 +19,13 @@ typedef enum {
 
 typedef bool (*StreamWriteCB)(Stream* stream, const void* context);
 
+typedef struct {
+    size_t offset;
+    size_t delete_size;
+    StreamWriteCB write_callback;
+    const void* context;
+} StreamEdit;
+
 /**
  * Free Stream
  * @param stream Stream instance
@@ -83,6 +90,7 @@ size_t stream_read(Stream* stream, uint8_t* data, size_t count);
 
 /**
  * Delete N chars from the stream and write data by calling write_callback(context)
+ * write_callback can be called more than once and must write the same data every time
  * @param stream Stream instance
  * @param delete_size size of data to be deleted
  * @param write_callback write callback
@@ -96,8 +104,68 @@ bool stream_delete_and_insert(
     StreamWriteCB write_callback,
     const void* context);
 
+/**
+ * Apply several deletes and inserts in one go, the data between edits is moved at most once.
+ * Offsets are positions in the stream before any of the edits are applied,
+ * edits must be sorted by offset and must not overlap.
+ * @param stream Stream instance
+ * @param edits edits array
+ * @param count edits count
+ * @return true if the operation was successful, the rw pointer is moved to the end of
+ * the data inserted by the last edit
+ * @return false on error
+ */
+bool stream_delete_and_insert_batch(Stream* stream, const StreamEdit* edits, size_t count);
+
+/**
+ * Get data at the rw pointer without copying, the rw pointer is not moved.
+ * Use stream_seek with StreamOffsetFromCurrent to consume the data.
+ * @param stream Stream instance
+ * @param data pointer to data, valid until any stream call except forward seek inside data
+ * @return size_t size of available data, 0 at the end of stream or if stream has no buffer
+ */
+size_t stream_peek(Stream* stream, const uint8_t** data);
+
 /********************************** Some random helpers starts here **********************************/
 
+/**
+ * Read line from a stream without copying, if the line is inside the stream buffer.
+ * Line ending is included as is, CR is not removed.
+ * @param stream Stream instance
+ * @param buffer line storage, used when the line spans buffer boundary or stream has no buffer
+ * @param line pointer to the line, not null-terminated, valid until the next stream call
+ * @param size line size
+ * @return true if line length is not zero
+ * @return false otherwise
+ */
+bool stream_read_line_slice(Stream* stream, string_t buffer, const char** line, size_t* size);
+
+/**
+ * Read data up to one of delimiters without copying, if it is inside the stream buffer.
+ * The rw pointer is left at the delimiter.
+ * @param stream Stream instance
+ * @param delimiters delimiter chars
+ * @param buffer token storage, used when the token spans buffer boundary or stream has no buffer
+ * @param token pointer to the token, not null-terminated, valid until the next stream call
+ * @param size token size
+ * @return true if token length is not zero
+ * @return false otherwise
+ */
+bool stream_read_token_slice(
+    Stream* stream,
+    const char* delimiters,
+    string_t buffer,
+    const char** token,
+    size_t* size);
+
+/**
+ * Append data to string
+ * @param str string
+ * @param data data to append, not null-terminated
+ * @param size data size
+ */
+void stream_string_cat_data(string_t str, const uint8_t* data, size_t size);
+
 /**
  * Read line from a stream (supports LF and CRLF line endings)
  * @param stream 
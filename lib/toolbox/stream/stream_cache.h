@@ -10,9 +10,10 @@ typedef struct StreamCache StreamCache;
 
 /**
  * Allocate stream cache.
+ * @param size Cache size in bytes.
  * @return StreamCache* pointer to a StreamCache instance
  */
-StreamCache* stream_cache_alloc();
+StreamCache* stream_cache_alloc(size_t size);
 
 /**
  * Free stream cache.
@@ -47,6 +48,13 @@ size_t stream_cache_size(StreamCache* cache);
  */
 size_t stream_cache_pos(StreamCache* cache);
 
+/**
+ * Get the cache capacity.
+ * @param cache Pointer to a StreamCache instance
+ * @return Maximum size of cached data.
+ */
+size_t stream_cache_max_size(StreamCache* cache);
+
 /**
  * Load the cache with new data from a stream.
  * @param cache Pointer to a StreamCache instance
@@ -72,6 +80,14 @@ bool stream_cache_flush(StreamCache* cache, Stream* stream);
  */
 size_t stream_cache_read(StreamCache* cache, uint8_t* data, size_t size);
 
+/**
+ * Get cached data at the internal cursor without copying, the cursor is not moved.
+ * @param cache Pointer to a StreamCache instance.
+ * @param data Pointer to cached data.
+ * @return Size of cached data after the cursor.
+ */
+size_t stream_cache_peek(StreamCache* cache, const uint8_t** data);
+
 /**
  * Write to cached data and advance the internal cursor.
  * @param cache Pointer to a StreamCache instance.
@@ -19,11 +19,16 @@ typedef size_t (*StreamTellFn)(Stream* stream);
 typedef size_t (*StreamSizeFn)(Stream* stream);
 typedef size_t (*StreamWriteFn)(Stream* stream, const uint8_t* data, size_t size);
 typedef size_t (*StreamReadFn)(Stream* stream, uint8_t* data, size_t count);
+typedef size_t (*StreamPeekFn)(Stream* stream, const uint8_t** data);
 typedef bool (*StreamDeleteAndInsertFn)(
     Stream* stream,
     size_t delete_size,
     StreamWriteCB write_cb,
     const void* ctx);
+typedef bool (*StreamDeleteAndInsertBatchFn)(
+    Stream* stream,
+    const StreamEdit* edits,
+    size_t count);
 
 struct StreamVTable {
     const StreamFreeFn free;
@@ -35,6 +40,10 @@ struct StreamVTable {
     const StreamWriteFn write;
     const StreamReadFn read;
     const StreamDeleteAndInsertFn delete_and_insert;
+    // Optional, only for streams with data in memory
+    const StreamPeekFn peek;
+    // Optional, edits are applied one by one from the end if not set
+    const StreamDeleteAndInsertBatchFn delete_and_insert_batch;
 };
 
 struct Stream {
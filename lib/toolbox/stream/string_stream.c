@@ -19,6 +19,7 @@ static size_t string_stream_tell(StringStream* stream);
 static size_t string_stream_size(StringStream* stream);
 static size_t string_stream_write(StringStream* stream, const char* data, size_t size);
 static size_t string_stream_read(StringStream* stream, char* data, size_t size);
+static size_t string_stream_peek(StringStream* stream, const uint8_t** data);
 static bool string_stream_delete_and_insert(
     StringStream* stream,
     size_t delete_size,
@@ -35,6 +36,7 @@ const StreamVTable string_stream_vtable = {
     .write = (StreamWriteFn)string_stream_write,
     .read = (StreamReadFn)string_stream_read,
     .delete_and_insert = (StreamDeleteAndInsertFn)string_stream_delete_and_insert,
+    .peek = (StreamPeekFn)string_stream_peek,
 };
 
 Stream* string_stream_alloc() {
@@ -133,6 +135,11 @@ static size_t string_stream_read(StringStream* stream, char* data, size_t size)
     return write_index;
 }
 
+static size_t string_stream_peek(StringStream* stream, const uint8_t** data) {
+    *data = (const uint8_t*)string_get_cstr(stream->string) + stream->index;
+    return string_stream_size(stream) - stream->index;
+}
+
 static bool string_stream_delete_and_insert(
     StringStream* stream,
     size_t delete_size,
@@ -151,7 +158,9 @@ static bool string_stream_delete_and_insert(
 
     if(write_callback) {
         string_t right;
-        string_init_set(right, &string_get_cstr(stream->string)[stream->index]);
+        // Copy by size, data may contain zeros
+        string_init_set(right, stream->string);
+        string_right(right, string_stream_tell(stream));
         string_left(stream->string, string_stream_tell(stream));
         result &= write_callback((Stream*)stream, ctx);
         string_cat(stream->string, right);
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+
+import os
+
+from flipper.app import App
+from flipper.utils.fff_binary import is_binary, text_to_binary, binary_to_text
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument("input", help="Flipper Format file, text or binary")
+        self.parser.add_argument("output", help="Converted file path")
+        self.parser.set_defaults(func=self.convert)
+
+    def convert(self):
+        if not os.path.exists(self.args.input):
+            self.logger.error(f'"{self.args.input}" does not exist')
+            return 1
+
+        with open(self.args.input, mode="rb") as file:
+            data = file.read()
+
+        try:
+            if is_binary(data):
+                self.logger.info("Converting binary to text")
+                converted = binary_to_text(data).encode("utf-8")
+            else:
+                # Empty lines are not kept, values are stored with the narrowest type
+                # that is printed back exactly as in the source
+                self.logger.info("Converting text to binary")
+                converted = text_to_binary(data.decode("utf-8"))
+        except Exception as e:
+            self.logger.error(f"Conversion failed: {e}")
+            return 1
+
+        with open(self.args.output, mode="wb") as file:
+            file.write(converted)
+
+        self.logger.info(f"Done: {len(data)} -> {len(converted)} bytes")
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()
@@ -1,4 +1,5 @@
 import os
+import posixpath
 import sys
 import serial
 import time
@@ -360,6 +361,35 @@ class FlipperStorage:
                 hash_md5.update(chunk)
         return hash_md5.hexdigest()
 
+    def manifest(self, path):
+        """Get md5, mtime and size of files under path, hashes are cached on Flipper"""
+        files = {}
+        self.send_and_wait_eol(f'storage manifest "{path}"\r')
+        data = self.read.until(self.CLI_PROMPT)
+        lines = data.split(b"\r\n")
+
+        for line in lines:
+            try:
+                line = line.decode("ascii")
+            except:
+                continue
+
+            line = line.strip()
+
+            if len(line) == 0:
+                continue
+
+            if self.has_error(line.encode("ascii")):
+                self.last_error = self.get_error(line.encode("ascii"))
+                return None
+
+            type, info = line.split(" ", 1)
+            if type == "[F]":
+                hash, mtime, size, name = info.split(" ", 3)
+                files[posixpath.normpath(name)] = (hash, int(mtime), int(size))
+
+        return files
+
     def hash_flipper(self, filename):
         """Get hash of file on Flipper"""
         self.send_and_wait_eol('storage md5 "' + filename + '"\r')
@@ -0,0 +1,160 @@
+import struct
+from enum import IntEnum
+
+# Binary Flipper Format container, see lib/flipper_format/flipper_format_binary.h
+
+MAGIC = b"\xffFFB\x01"
+TAG_KEY = 0xF0
+TAG_COMMENT = 0xF1
+RECORD_HEADER = struct.Struct("<BHH")
+
+
+# Value record tags, FLIPPER_FORMAT_BINARY_TAG_* in flipper_format_binary.c
+class ValueType(IntEnum):
+    Str = 1
+    Hex = 2
+    Float = 3
+    Int32 = 4
+    Uint32 = 5
+    HexUint64 = 6
+    Bool = 7
+
+
+ELEMENT_FORMAT = {
+    ValueType.Hex: "B",
+    ValueType.Float: "f",
+    ValueType.Int32: "i",
+    ValueType.Uint32: "i",
+    ValueType.HexUint64: "Q",
+    ValueType.Bool: "B",
+}
+
+HEX_DIGITS = "0123456789ABCDEF"
+
+
+def _is_hex(token: str, length: int):
+    return len(token) == length and all(c in HEX_DIGITS for c in token)
+
+
+def _float32(token: str):
+    try:
+        value = struct.unpack("<f", struct.pack("<f", float(token)))[0]
+    except (ValueError, OverflowError):
+        return None
+    # Firmware prints floats with "%f"
+    return value if f"{value:f}" == token else None
+
+
+def _int32(token: str):
+    try:
+        value = int(token)
+    except ValueError:
+        return None
+    if str(value) != token or value < -(2**31) or value >= 2**31:
+        return None
+    return value
+
+
+def encode_value(text: str):
+    """Find the type, which is printed by firmware exactly as the given text"""
+    tokens = text.split(" ")
+    if text and all(t in ("true", "false") for t in tokens):
+        return ValueType.Bool, bytes(t == "true" for t in tokens)
+    if text and all(_int32(t) is not None for t in tokens):
+        values = [_int32(t) for t in tokens]
+        return ValueType.Int32, struct.pack(f"<{len(values)}i", *values)
+    if text and all(_is_hex(t, 2) for t in tokens):
+        return ValueType.Hex, bytes(int(t, 16) for t in tokens)
+    if text and all(_is_hex(t, 16) for t in tokens):
+        values = [int(t, 16) for t in tokens]
+        return ValueType.HexUint64, struct.pack(f"<{len(values)}Q", *values)
+    if text and all(_float32(t) is not None for t in tokens):
+        values = [_float32(t) for t in tokens]
+        return ValueType.Float, struct.pack(f"<{len(values)}f", *values)
+    return ValueType.Str, text.encode("utf-8")
+
+
+def decode_value(value_type: int, payload: bytes):
+    value_type = ValueType(value_type)
+    if value_type == ValueType.Str:
+        return payload.decode("utf-8")
+
+    element_format = ELEMENT_FORMAT[value_type]
+    count = len(payload) // struct.calcsize(element_format)
+    values = struct.unpack(f"<{count}{element_format}", payload)
+    if value_type == ValueType.Hex:
+        tokens = [f"{v:02X}" for v in values]
+    elif value_type == ValueType.Float:
+        tokens = [f"{v:f}" for v in values]
+    elif value_type == ValueType.HexUint64:
+        tokens = [f"{v:016X}" for v in values]
+    elif value_type == ValueType.Bool:
+        tokens = ["true" if v else "false" for v in values]
+    else:
+        # Uint32 is printed as signed too
+        tokens = [str(v) for v in values]
+    return " ".join(tokens)
+
+
+def _record(tag: int, key_id: int, payload: bytes):
+    if len(payload) > 0xFFFF:
+        raise Exception(f"Record is too long: {len(payload)} bytes")
+    return RECORD_HEADER.pack(tag, key_id, len(payload)) + payload
+
+
+def is_binary(data: bytes):
+    return data.startswith(MAGIC)
+
+
+def text_to_binary(text: str):
+    keys = {}
+    data = bytearray(MAGIC)
+    for line in text.split("\n"):
+        line = line.rstrip("\r")
+        if not line:
+            continue
+        if line.startswith("#"):
+            comment = line[2:] if line.startswith("# ") else line[1:]
+            data += _record(TAG_COMMENT, 0, comment.encode("utf-8"))
+            continue
+
+        key, separator, value = line.partition(":")
+        if not separator:
+            raise Exception(f"Unexpected line: not `key: value`: `{line}`")
+        # Value starts after ": "
+        value = value[1:]
+
+        if key not in keys:
+            keys[key] = len(keys)
+            data += _record(TAG_KEY, keys[key], key.encode("utf-8"))
+        value_type, payload = encode_value(value)
+        data += _record(value_type, keys[key], payload)
+    return bytes(data)
+
+
+def binary_to_text(data: bytes):
+    if not is_binary(data):
+        raise Exception("Not a binary Flipper Format file")
+
+    keys = {}
+    lines = []
+    position = len(MAGIC)
+    while position < len(data):
+        if position + RECORD_HEADER.size > len(data):
+            raise Exception(f"Truncated record at {position}")
+        tag, key_id, size = RECORD_HEADER.unpack_from(data, position)
+        position += RECORD_HEADER.size
+        payload = data[position : position + size]
+        if len(payload) != size:
+            raise Exception(f"Truncated record at {position}")
+        position += size
+
+        if tag == TAG_KEY:
+            keys[key_id] = payload.decode("utf-8")
+        elif tag == TAG_COMMENT:
+            lines.append(f"# {payload.decode('utf-8')}")
+        elif ValueType.Str <= tag <= ValueType.Bool:
+            lines.append(f"{keys[key_id]}: {decode_value(tag, payload)}")
+        else:
+            raise Exception(f"Unknown record tag {tag:#x}")
+    return "".join(f"{line}\n" for line in lines)
@@ -159,6 +159,9 @@ class Main(App):
             # create parent dir
             self.mkdir_on_storage(storage, flipper_path)
 
+            # hashes of all files on Flipper at once
+            manifest = None if force else storage.manifest(flipper_path)
+
             for dirpath, dirnames, filenames in os.walk(local_path):
                 self.logger.debug(f'Processing directory "{os.path.normpath(dirpath)}"')
                 dirnames.sort()
@@ -181,7 +184,7 @@ class Main(App):
                     )
                     local_file_path = os.path.normpath(os.path.join(dirpath, filename))
                     self.send_file_to_storage(
-                        storage, flipper_file_path, local_file_path, force
+                        storage, flipper_file_path, local_file_path, force, manifest
                     )
         else:
             self.send_file_to_storage(storage, flipper_path, local_path, force)
@@ -196,8 +199,15 @@ class Main(App):
             self.logger.debug(f'"{flipper_dir_path}" already exists')
 
     # send file with exist check and hash check
-    def send_file_to_storage(self, storage, flipper_file_path, local_file_path, force):
-        if not storage.exist_file(flipper_file_path):
+    def send_file_to_storage(
+        self, storage, flipper_file_path, local_file_path, force, manifest=None
+    ):
+        if manifest is not None:
+            exists = flipper_file_path in manifest
+        else:
+            exists = storage.exist_file(flipper_file_path)
+
+        if not exists:
             self.logger.debug(
                 f'"{flipper_file_path}" does not exist, sending "{local_file_path}"'
             )
@@ -216,7 +226,10 @@ class Main(App):
                 f'"{flipper_file_path}" exists, compare hash with "{local_file_path}"'
             )
             hash_local = storage.hash_local(local_file_path)
-            hash_flipper = storage.hash_flipper(flipper_file_path)
+            if manifest is not None:
+                hash_flipper = manifest[flipper_file_path][0]
+            else:
+                hash_flipper = storage.hash_flipper(flipper_file_path)
 
             if not hash_flipper:
                 self.logger.error(f"Error: {storage.last_error}")